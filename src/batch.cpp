@@ -0,0 +1,133 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+void pin_to_core(unsigned core)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+
+}    // namespace
+
+Batch::Batch(const Cartridge& cart, std::size_t count, unsigned threads, bool pin)
+    : frames(count * kFrameSize)
+    , carts(count, cart)
+{
+    const bool skip_bios {cart.bios.data.empty()};
+    instances.reserve(count);
+    for (Cartridge& copy : carts) {
+        // They'd all write to the same file
+        copy.save_path.clear();
+
+        auto& emulator {*instances.emplace_back(std::make_unique<Emulator>())};
+        emulator.reset(skip_bios);
+        mmu_set_cartridge(&emulator.mmu, &copy, skip_bios);
+    }
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::clamp<std::size_t>(count, 1, threads));
+
+    shares = std::make_unique<Share[]>(threads);
+    for (unsigned i = 0; i < threads; i++) {
+        shares[i].begin = count * i / threads;
+        shares[i].end = count * (i + 1) / threads;
+        shares[i].next.store(shares[i].end, std::memory_order_relaxed);
+    }
+
+    workers.reserve(threads - 1);
+    for (unsigned id = 1; id < threads; id++) {
+        workers.emplace_back(&Batch::work, this, id, pin);
+    }
+}
+
+Batch::~Batch()
+{
+    stopping = true;
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void Batch::run_frame()
+{
+    for_each([this](std::size_t i) {
+        Emulator& emulator {*instances[i]};
+        if (emulator.cpu.is_enabled()) {
+            emulator.run_frame();
+        }
+        std::memcpy(&frames[i * kFrameSize], emulator.ppu.get_pixels(), kFrameSize);
+    });
+}
+
+void Batch::run_tasks(TaskFn fn, void* context)
+{
+    task = fn;
+    task_context = context;
+
+    const unsigned threads {static_cast<unsigned>(workers.size() + 1)};
+    for (unsigned i = 0; i < threads; i++) {
+        shares[i].next.store(shares[i].begin, std::memory_order_relaxed);
+    }
+    busy.store(workers.size(), std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+
+    run_shares(0);
+
+    for (std::size_t left {busy.load(std::memory_order_acquire)}; left; left = busy.load(std::memory_order_acquire)) {
+        busy.wait(left, std::memory_order_acquire);
+    }
+}
+
+void Batch::work(unsigned id, bool pin)
+{
+    if (pin) {
+        pin_to_core(id % std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    u64 seen {0};
+    while (true) {
+        generation.wait(seen, std::memory_order_acquire);
+        seen = generation.load(std::memory_order_acquire);
+        if (stopping) {
+            return;
+        }
+
+        run_shares(id);
+        if (busy.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            busy.notify_one();
+        }
+    }
+}
+
+void Batch::run_shares(unsigned id)
+{
+    // Our own share first, then round the others
+    const unsigned threads {static_cast<unsigned>(workers.size() + 1)};
+    for (unsigned n = 0; n < threads; n++) {
+        Share& share {shares[(id + n) % threads]};
+        for (std::size_t i {share.next.fetch_add(1, std::memory_order_relaxed)}; i < share.end;
+             i = share.next.fetch_add(1, std::memory_order_relaxed)) {
+            task(task_context, i);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef KORLOW_BATCH_H
+#define KORLOW_BATCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "cartridge.h"
+#include "constants.h"
+#include "emu_types.h"
+#include "emulator.h"
+
+/*
+ * Many independent emulators running the same cartridge, stepped a frame at a
+ * time across a fixed pool of threads.
+ *
+ * Each worker starts on its own share of the instances and steals from the
+ * others' once it's through, one instance at a time, so a few slow instances
+ * don't hold the rest up. The calling thread is worker 0. Nothing is shared
+ * between instances but the ROM image, and the frames end up side by side in
+ * one buffer.
+ */
+struct Batch {
+    static constexpr std::size_t kFrameSize {kLcdWidth * kLcdHeight};
+
+    // `threads` counts the caller, 0 for one per core. With `pin` the pool's
+    // threads are each kept to a core of their own; the caller isn't.
+    Batch(const Cartridge& cart, std::size_t count, unsigned threads = 0, bool pin = false);
+
+    Batch(const Batch&) = delete;
+    ~Batch();
+
+    // Runs every instance to its next frame boundary, or until its CPU stops,
+    // and copies the frames out. Set the instances up in between.
+    void run_frame();
+
+    // Calls task(i) for every instance i across the pool, and returns once
+    // they're all done. run_frame() is one of these.
+    template <typename Task>
+    void for_each(Task&& task)
+    {
+        using T = std::remove_reference_t<Task>;
+        run_tasks([](void* context, std::size_t i) { (*static_cast<T*>(context))(i); }, &task);
+    }
+
+    std::size_t size() const
+    {
+        return instances.size();
+    }
+
+    Emulator& operator[](std::size_t i)
+    {
+        return *instances[i];
+    }
+
+    // Instance i's frame from the last run_frame()
+    const u8* frame(std::size_t i) const
+    {
+        return &frames[i * kFrameSize];
+    }
+
+    // Every frame, instance by instance
+    std::vector<u8> frames;
+
+private:
+    // A worker's share of the instances. Others take from it too once theirs
+    // is done.
+    struct alignas(64) Share {
+        std::atomic<std::size_t> next {0};
+        std::size_t begin {0};
+        std::size_t end {0};
+    };
+
+    // Called with `context` for each instance. Not a std::function, which
+    // could allocate every frame.
+    using TaskFn = void (*)(void* context, std::size_t i);
+
+    void run_tasks(TaskFn fn, void* context);
+    void work(unsigned id, bool pin);
+    void run_shares(unsigned id);
+
+    std::vector<Cartridge> carts;
+    std::vector<std::unique_ptr<Emulator>> instances;
+    std::unique_ptr<Share[]> shares;
+
+    // Bumped to start a round of tasks; the pool counts itself down once it's done
+    alignas(64) std::atomic<u64> generation {0};
+    alignas(64) std::atomic<std::size_t> busy {0};
+    bool stopping {false};
+    TaskFn task {nullptr};
+    void* task_context {nullptr};
+
+    std::vector<std::thread> workers;
+};
+
+#endif    // KORLOW_BATCH_H
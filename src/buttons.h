@@ -6,6 +6,17 @@ enum ButtonId {
     ButtonOpenFile,
     ButtonCloseDialog,
     ButtonDumpVRAM,
+    ButtonRewind,
+
+    // The joypad, in JoypadButton's order
+    ButtonRight,
+    ButtonLeft,
+    ButtonUp,
+    ButtonDown,
+    ButtonA,
+    ButtonB,
+    ButtonSelect,
+    ButtonStart,
 };
 
 #endif    // KORLOW_BUTTONS_H
@@ -0,0 +1,69 @@
+#include "cartridge.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "fs.h"
+#include "mmu.h"
+
+void cartridge_load_bios(Cartridge* cart, const std::filesystem::path& file_path)
+{
+    assert(std::filesystem::file_size(file_path) == 0x100);
+
+    cart->bios.path = std::filesystem::absolute(file_path);
+    cart->bios.data = FS::read_bytes(file_path.string());
+
+    fprintf(stdout, "Loaded BIOS '%s'\n", file_path.string().c_str());
+}
+
+void cartridge_load_rom(Cartridge* cart, const std::filesystem::path& file_path)
+{
+    // 512 banks, as many as MBC5 can address
+    static constexpr int kMaxRomSize {0x800000};
+
+    const auto rom_size {std::filesystem::file_size(file_path)};
+
+    if (rom_size > kMaxRomSize) {
+        throw std::runtime_error("Rom too large: " + std::to_string(rom_size) + "/" + std::to_string(kMaxRomSize));
+    }
+
+    auto image {RomImage::open(file_path)};
+
+    if (!mbc_supported(image->data[0x147])) {
+        throw std::runtime_error("Unsupported cartridge type: " + std::to_string(image->data[0x147]));
+    }
+
+    cart->save_path = std::filesystem::path(image->path).replace_extension(".sav");
+    cart->rom = std::move(image);
+
+    fprintf(stdout, "Loaded ROM '%s'\n", file_path.string().c_str());
+}
+
+void mmu_set_cartridge(Mmu* mmu, Cartridge* cart, bool skip_bios)
+{
+    assert(cart->rom);
+
+    // A fork keeps its memory, but cart RAM is about to be replaced
+    mmu->unshare_all();
+
+    // Nothing is copied, the MMU's pages point into the image
+    mmu->mbc.load(cart->rom);
+    if (mmu->mbc.battery && !cart->save_path.empty()) {
+        mmu->mbc.attach_save(cart->save_path);
+    }
+
+    mmu->bios = cart->bios.data.empty() ? nullptr : cart->bios.data.data();
+    if (skip_bios) {
+        mmu->boot_rom = nullptr;
+    }
+    else {
+        assert(cart->bios.data.size() == 0x100);
+        mmu->boot_rom = mmu->bios;
+    }
+
+    mmu->map_pages();
+    mmu->invalidate_code();
+}
@@ -0,0 +1,33 @@
+#ifndef KORLOW_CARTRIDGE_H
+#define KORLOW_CARTRIDGE_H
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "emu_types.h"
+#include "rom_image.h"
+
+struct Mmu;
+
+struct Rom {
+    std::filesystem::path path;
+    std::vector<u8> data;
+};
+
+struct Cartridge {
+    std::shared_ptr<const RomImage> rom;
+    Rom bios;
+
+    // Where battery-backed RAM is kept, next to the ROM by default. Empty to
+    // keep it in memory only.
+    std::filesystem::path save_path;
+};
+
+void cartridge_load_bios(Cartridge* cart, const std::filesystem::path& file_path);
+void cartridge_load_rom(Cartridge* cart, const std::filesystem::path& file_path);
+
+// The MMU shares `cart`'s ROM image, but maps the BIOS in place, so it must stay put while it runs.
+void mmu_set_cartridge(Mmu* mmu, Cartridge* cart, bool skip_bios);
+
+#endif    // KORLOW_CARTRIDGE_H
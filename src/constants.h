@@ -7,6 +7,10 @@ constexpr int kLcdHeight {144};
 constexpr int kMapWidth {32};
 constexpr int kMapHeight {32};
 
+constexpr int kCyclesPerLine {456};
+constexpr int kLinesPerFrame {154};
+constexpr int kCyclesPerFrame {kCyclesPerLine * kLinesPerFrame};
+
 constexpr int kCpuFreq {4'194'304};
 constexpr int kMaxCyclesPerFrame {kCpuFreq / 60};
 
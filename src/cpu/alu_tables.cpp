@@ -0,0 +1,81 @@
+#include "cpu/alu_tables.h"
+
+#include <utility>
+
+namespace {
+
+using Row = std::array<u16, 0x100>;
+
+constexpr u16 pack(u8 result, u8 f)
+{
+    return f << 8 | result;
+}
+
+// Row `a` of each table. Built one row per constant so no single evaluation
+// goes over the compilers' constexpr step limits.
+struct Rows {
+    Row add;
+    Row sub;
+    Row adc;
+    Row sbc;
+};
+
+constexpr Rows make_rows(u8 a)
+{
+    Rows rows {};
+    for (int b = 0; b < 0x100; b++) {
+        u8 f {0};
+        u8 result {ADD8(a, b, f)};
+        rows.add[b] = pack(result, f);
+
+        f = 0;
+        result = SUB8(a, b, f);
+        rows.sub[b] = pack(result, f);
+
+        f = FLAGS_CARRY;
+        result = a;
+        ADC(result, b, f);
+        rows.adc[b] = pack(result, f);
+
+        f = FLAGS_CARRY;
+        result = a;
+        SBC(result, b, f);
+        rows.sbc[b] = pack(result, f);
+    }
+    return rows;
+}
+
+template <int A>
+constexpr Rows kRows {make_rows(A)};
+
+constexpr Row make_inc_dec(bool dec)
+{
+    Row row {};
+    for (int r = 0; r < 0x100; r++) {
+        u8 f {0};
+        u8 result = r;
+        if (dec) {
+            DEC8(result, f);
+        }
+        else {
+            INC8(result, f);
+        }
+        row[r] = pack(result, f);
+    }
+    return row;
+}
+
+template <std::size_t... A>
+constexpr AluTables make_alu_tables(std::index_sequence<A...>)
+{
+    return AluTables {
+        .add {{kRows<A>.add..., kRows<A>.adc...}},
+        .sub {{kRows<A>.sub..., kRows<A>.sbc...}},
+        .inc {make_inc_dec(false)},
+        .dec {make_inc_dec(true)},
+    };
+}
+
+}    // namespace
+
+extern constexpr AluTables kAluTables {make_alu_tables(std::make_index_sequence<0x100> {})};
@@ -0,0 +1,79 @@
+#ifndef KORLOW_ALU_TABLES_H
+#define KORLOW_ALU_TABLES_H
+
+#include <array>
+
+#include "cpu/cpu_base.h"
+#include "emu_types.h"
+
+/*
+ * Results and flags of the 8-bit arithmetic helpers in cpu_base.h, computed at
+ * compile time from those helpers so the interpreters can look them up instead
+ * of branching on every flag.
+ *
+ * Each entry has the result in the low byte and F in the high byte. The add and
+ * sub tables are indexed by [carry << 8 | a][b]; the rows without carry are
+ * ADD8/SUB8, the others ADC/SBC. INC and DEC leave C alone, so theirs are
+ * indexed by the operand and hold Z, N and H only.
+ */
+struct AluTables {
+    std::array<std::array<u16, 0x100>, 0x200> add;
+    std::array<std::array<u16, 0x100>, 0x200> sub;
+    std::array<u16, 0x100> inc;
+    std::array<u16, 0x100> dec;
+};
+
+extern const AluTables kAluTables;
+
+namespace alu {
+
+inline u8 add(u8 a, u8 b, u8 &f)
+{
+    const u16 entry = kAluTables.add[a][b];
+    f = entry >> 8;
+    return entry & 0xFF;
+}
+
+inline u8 sub(u8 a, u8 b, u8 &f)
+{
+    const u16 entry = kAluTables.sub[a][b];
+    f = entry >> 8;
+    return entry & 0xFF;
+}
+
+inline void cp(u8 a, u8 b, u8 &f)
+{
+    f = kAluTables.sub[a][b] >> 8;
+}
+
+inline void adc(u8 &a, u8 r, u8 &f)
+{
+    const u16 entry = kAluTables.add[(f & FLAGS_CARRY) << 4 | a][r];
+    f = entry >> 8;
+    a = entry & 0xFF;
+}
+
+inline void sbc(u8 &a, u8 r, u8 &f)
+{
+    const u16 entry = kAluTables.sub[(f & FLAGS_CARRY) << 4 | a][r];
+    f = entry >> 8;
+    a = entry & 0xFF;
+}
+
+inline void inc(u8 &r, u8 &f)
+{
+    const u16 entry = kAluTables.inc[r];
+    f = (f & FLAGS_CARRY) | entry >> 8;
+    r = entry & 0xFF;
+}
+
+inline void dec(u8 &r, u8 &f)
+{
+    const u16 entry = kAluTables.dec[r];
+    f = (f & FLAGS_CARRY) | entry >> 8;
+    r = entry & 0xFF;
+}
+
+}    // namespace alu
+
+#endif    // KORLOW_ALU_TABLES_H
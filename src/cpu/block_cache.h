@@ -0,0 +1,427 @@
+#ifndef KORLOW_BLOCK_CACHE_H
+#define KORLOW_BLOCK_CACHE_H
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "cpu/inst_data.h"
+#include "cpu/rom_blocks.h"
+#include "emu_types.h"
+
+/* Guest loops the switch core runs as a single operation */
+enum class Idiom : u8 {
+    None,
+    Copy,     // LD A, (HL+); LD (DE), A; INC DE; DEC B; JR NZ
+    Poll,     // LDH A, (d8); CP d8; JR NZ
+    Delay,    // DEC BC; LD A, B; OR C; JR NZ
+    Count,
+};
+
+// Switch core case for a fused idiom: kFusedOps + Idiom
+constexpr u16 kFusedOps {0x200};
+
+/* One instruction, fetched and decoded ahead of time. */
+struct DecodedOp {
+    u16 pc;
+    u16 op;          // 0x100+ for CB-prefixed instructions
+    u16 dispatch;    // What the switch core runs: `op`, or a fused idiom starting here
+    u16 d16;         // The two bytes after the opcode, d8 is the low byte
+    u8 size;         // Including the CB prefix
+    u8 cycles;       // Base cycles; taken branches add the difference to kInstCyclesAlt
+    bool store;      // Writes memory, so may overwrite the block it's in
+};
+
+/*
+ * The instructions of a block as decoded. Those decoded from ROM are shared by
+ * every instance running the image (see RomBlocks), so never change once
+ * they're decoded.
+ */
+struct BlockCode {
+    static constexpr int kMaxOps {16};
+
+    u16 pc {0};
+    u8 length {0};
+    u8 last_page {0};
+    bool idle {false};
+    std::array<DecodedOp, kMaxOps> ops {};
+};
+
+/*
+ * A straight run of instructions starting at `pc`, ending at the first
+ * instruction that can jump (branch, call, RST, RET) or stop (HALT, STOP).
+ *
+ * This instance's view of a BlockCode: the pages it's valid for and the JIT's
+ * state, with the rest copied out so a hit doesn't have to follow `ops`.
+ */
+struct Block {
+    u16 pc {0};
+    u8 length {0};
+    u8 first_page {0};
+    u8 last_page {0};
+    u32 first_generation {0};
+    u32 last_generation {0};
+    const DecodedOp* ops {nullptr};    // BlockCode::ops
+
+    // Loops back to `pc` without writing memory, see BlockCache::idle_skip
+    bool idle {false};
+
+    // Used by the JIT core: times entered, and the translated code once hot
+    u32 runs {0};
+    const void* native {nullptr};
+};
+
+/*
+ * Direct-mapped cache of decoded blocks keyed by PC.
+ *
+ * Every 256-byte page has a generation number that's bumped whenever its
+ * contents change underneath the CPU: RAM writes, the boot ROM unmapping or a
+ * new cartridge. A block is only used while the generations of the pages it
+ * was decoded from are unchanged.
+ *
+ * The bus needs read8, read16, watch_code(page) and rom_blocks(address,
+ * offset). watch_code is called for every page a block is decoded from, and
+ * from then on every write to that page must end up in invalidate().
+ *
+ * Code in ROM is decoded once per image rather than once per instance: it's
+ * looked up in the image's RomBlocks, keyed by where in the image it's read
+ * from, and published there when it isn't found. Only code elsewhere, in RAM
+ * or the boot ROM, is decoded into `local`.
+ *
+ * Blocks that end in a copy, poll or delay loop get the loop marked as a fused
+ * idiom (see DecodedOp::dispatch), unless `fusion` is off.
+ *
+ * Blocks that jump back to their own start and write nothing are marked idle
+ * unless `idle_skip` is off. Apart from DIV and TIMA (see timed_reads), memory
+ * only changes through the CPU and events, so once a pass through such a loop
+ * leaves the registers as it found them, every pass up to the next event will
+ * too, and the switch core skips straight there.
+ */
+struct BlockCache {
+    static constexpr int kBlockCount {4096};
+    static constexpr int kLocalCount {256};
+
+    // The blocks are allocated on first use, so an instance that never runs
+    // code (e.g. a fork that's only inspected) doesn't pay for them
+    BlockCache() = default;
+
+    BlockCache(const BlockCache&) = delete;
+
+    void reset()
+    {
+        for (Block& block : blocks) {
+            block.length = 0;
+        }
+        generation.fill(0);
+    }
+
+    // Called after a write to `address`
+    void invalidate(u16 address)
+    {
+        generation[address >> 8]++;
+    }
+
+    void invalidate_all()
+    {
+        for (u32& g : generation) {
+            g++;
+        }
+    }
+
+    // Forgets all translated code, e.g. when the JIT's buffer is full
+    void drop_native()
+    {
+        for (Block& block : blocks) {
+            block.native = nullptr;
+            block.runs = 0;
+        }
+    }
+
+    const u32* generations() const
+    {
+        return generation.data();
+    }
+
+    // Where a block starting at `pc` is cached, so generated code can follow
+    // jumps itself. Only valid once lookup() has run.
+    const Block* slot(u16 pc) const
+    {
+        return &blocks[pc % kBlockCount];
+    }
+
+    bool is_current(const Block& block) const
+    {
+        return generation[block.first_page] == block.first_generation && generation[block.last_page] == block.last_generation;
+    }
+
+    template <typename Bus>
+    Block& lookup(Bus& mmu, u16 pc)
+    {
+        if (blocks.empty()) [[unlikely]] {
+            blocks.resize(kBlockCount);
+        }
+        Block& block {blocks[pc % kBlockCount]};
+        if (block.length && block.pc == pc && is_current(block)) {
+            hits++;
+            return block;
+        }
+        misses++;
+        decode(mmu, pc, block);
+        return block;
+    }
+
+    u64 hits {0};
+    u64 misses {0};
+
+    bool fusion {true};
+    bool idle_skip {true};
+
+    // Loop iterations run fused, per Idiom
+    std::array<u64, static_cast<std::size_t>(Idiom::Count)> fused {};
+
+    // Passes through idle loops skipped rather than run
+    u64 idle_passes {0};
+
+    // Reads of registers computed from the cycle counter (DIV, TIMA), counted
+    // by the bus. A loop pass that makes any isn't repeatable, so isn't skipped.
+    u64 timed_reads {0};
+
+private:
+    template <typename Bus>
+    void decode(Bus& mmu, u16 pc, Block& block)
+    {
+        const int variant {int(fusion) | int(idle_skip) << 1};
+        u32 offset {0};
+        RomBlocks* const rom {mmu.rom_blocks(pc, offset)};
+        const BlockCode* code {rom ? rom->find(offset, variant) : nullptr};
+
+        if (!code || code->pc != pc) {
+            BlockCode decoded;
+            const u16 last_byte {decode_ops(mmu, pc, decoded)};
+
+            // Shared if it's all read from one bank of the image. Banks 0 and
+            // 1 are next to each other in it, but a block running from one
+            // into the other is only right while bank 1 is mapped.
+            u32 last_offset {0};
+            const bool one_bank {pc >> 14 == last_byte >> 14};
+            if (rom && !code && one_bank && mmu.rom_blocks(last_byte, last_offset) == rom && last_offset == offset + u16(last_byte - pc)) {
+                code = rom->publish(offset, variant, decoded);
+            }
+            else {
+                code = &store_local(decoded);
+            }
+        }
+
+        block.pc = pc;
+        block.length = code->length;
+        block.first_page = pc >> 8;
+        block.last_page = code->last_page;
+        block.ops = code->ops.data();
+        block.idle = code->idle;
+        block.runs = 0;
+        block.native = nullptr;
+
+        mmu.watch_code(block.first_page);
+        mmu.watch_code(block.last_page);
+        block.first_generation = generation[block.first_page];
+        block.last_generation = generation[block.last_page];
+    }
+
+    // Returns the address of the block's last byte
+    template <typename Bus>
+    u16 decode_ops(Bus& mmu, u16 pc, BlockCode& code) const
+    {
+        code.pc = pc;
+        code.length = 0;
+
+        u16 address {pc};
+        while (code.length < BlockCode::kMaxOps) {
+            u16 op {mmu.read8(address)};
+            const u16 d16 {mmu.read16(address + 1)};
+            if (op == 0xCB) {
+                op = 0x100 + (d16 & 0xFF);
+            }
+
+            DecodedOp& inst {code.ops[code.length++]};
+            inst.pc = address;
+            inst.op = op;
+            inst.dispatch = op;
+            inst.d16 = d16;
+            inst.size = kInstSizes[op] + (op > 0xFF);
+            inst.cycles = kInstCycles[op];
+            inst.store = writes_memory(op);
+
+            address += inst.size;
+
+            if (ends_block(op)) {
+                break;
+            }
+        }
+
+        if (fusion) {
+            fuse(code);
+        }
+        code.idle = idle_skip && is_idle_loop(code);
+
+        // At most 16 * 3 bytes, so a block never spans more than two pages
+        const u16 last_byte = (address == pc) ? pc : u16(address - 1);
+        code.last_page = last_byte >> 8;
+        return last_byte;
+    }
+
+    // Into the local slot for its PC, taking it from whichever block had it
+    BlockCode& store_local(const BlockCode& code)
+    {
+        if (local.empty()) [[unlikely]] {
+            local.resize(kLocalCount);
+        }
+        BlockCode& slot {local[code.pc % kLocalCount]};
+        Block& owner {blocks[slot.pc % kBlockCount]};
+        if (owner.ops == slot.ops.data()) {
+            owner.length = 0;
+        }
+        slot = code;
+        return slot;
+    }
+
+    // Idioms end in a JR NZ, so they can only be at the end of a block
+    static void fuse(BlockCode& block)
+    {
+        struct Pattern {
+            Idiom idiom;
+            u8 length;
+            std::array<u16, 5> ops;
+        };
+        static constexpr Pattern kPatterns[] {
+            {Idiom::Copy, 5, {0x2A, 0x12, 0x13, 0x05, 0x20}},
+            {Idiom::Poll, 3, {0xF0, 0xFE, 0x20}},
+            {Idiom::Delay, 4, {0x0B, 0x78, 0xB1, 0x20}},
+        };
+
+        // A copy into the block's echo mirror would go unnoticed
+        if (block.pc >= 0xE000 && block.pc < 0xFE00) {
+            return;
+        }
+
+        for (const Pattern& pattern : kPatterns) {
+            if (block.length < pattern.length) {
+                continue;
+            }
+            DecodedOp* const first {&block.ops[block.length - pattern.length]};
+            const auto same_op = [](u16 op, const DecodedOp& inst) { return op == inst.op; };
+            if (std::equal(pattern.ops.begin(), pattern.ops.begin() + pattern.length, first, same_op)) {
+                first->dispatch = kFusedOps + static_cast<u16>(pattern.idiom);
+                return;
+            }
+        }
+    }
+
+    static bool is_idle_loop(const BlockCode& block)
+    {
+        const DecodedOp& last {block.ops[block.length - 1]};
+        u16 target {0};
+        switch (last.op) {
+            case 0x18:    // JR d8
+            case 0x20:    // JR NZ, d8
+            case 0x28:    // JR Z, d8
+            case 0x30:    // JR NC, d8
+            case 0x38:    // JR C, d8
+                target = last.pc + last.size + int8_t(last.d16 & 0xFF);
+                break;
+            case 0xC2:    // JP NZ, d16
+            case 0xC3:    // JP d16
+            case 0xCA:    // JP Z, d16
+            case 0xD2:    // JP NC, d16
+            case 0xDA:    // JP C, d16
+                target = last.d16;
+                break;
+            default:
+                return false;
+        }
+        if (target != block.pc) {
+            return false;
+        }
+
+        // EI changes IME an instruction late, so a pass wouldn't repeat exactly
+        return std::none_of(block.ops.begin(), block.ops.begin() + block.length, [](const DecodedOp& inst) { return inst.store || inst.op == 0xFB; });
+    }
+
+    // Calls and RSTs write too, but they always end the block
+    static bool writes_memory(u16 op)
+    {
+        if (op > 0xFF) {
+            // CB (HL) operations other than BIT
+            return (op & 0x7) == 0x6 && (op < 0x140 || op >= 0x180);
+        }
+
+        switch (op) {
+            case 0x02:    // LD (BC), A
+            case 0x08:    // LD (d16), SP
+            case 0x12:    // LD (DE), A
+            case 0x22:    // LD (HL+), A
+            case 0x32:    // LD (HL-), A
+            case 0x34:    // INC (HL)
+            case 0x35:    // DEC (HL)
+            case 0x36:    // LD (HL), d8
+            case 0xC5:    // PUSH BC
+            case 0xD5:    // PUSH DE
+            case 0xE0:    // LDH (d8), A
+            case 0xE2:    // LD (C), A
+            case 0xE5:    // PUSH HL
+            case 0xEA:    // LD (d16), A
+            case 0xF5:    // PUSH AF
+                return true;
+            default:
+                // LD (HL), r
+                return op >= 0x70 && op <= 0x77 && op != 0x76;
+        }
+    }
+
+    static bool ends_block(u16 op)
+    {
+        switch (op) {
+            case 0x10:    // STOP
+            case 0x18:    // JR d8
+            case 0x20:    // JR NZ, d8
+            case 0x28:    // JR Z, d8
+            case 0x30:    // JR NC, d8
+            case 0x38:    // JR C, d8
+            case 0x76:    // HALT
+            case 0xC0:    // RET NZ
+            case 0xC2:    // JP NZ, d16
+            case 0xC3:    // JP d16
+            case 0xC4:    // CALL NZ, d16
+            case 0xC7:    // RST 00
+            case 0xC8:    // RET Z
+            case 0xC9:    // RET
+            case 0xCA:    // JP Z, d16
+            case 0xCC:    // CALL Z, d16
+            case 0xCD:    // CALL d16
+            case 0xCF:    // RST 08
+            case 0xD0:    // RET NC
+            case 0xD2:    // JP NC, d16
+            case 0xD4:    // CALL NC, d16
+            case 0xD7:    // RST 10
+            case 0xD8:    // RET C
+            case 0xD9:    // RETI
+            case 0xDA:    // JP C, d16
+            case 0xDC:    // CALL C, d16
+            case 0xDF:    // RST 18
+            case 0xE7:    // RST 20
+            case 0xE9:    // JP HL
+            case 0xEF:    // RST 28
+            case 0xF7:    // RST 30
+            case 0xFF:    // RST 38
+                return true;
+            default:
+                // Invalid opcodes have size 0 and stop the CPU
+                return op < 0x100 && kInstSizes[op] == 0;
+        }
+    }
+
+    std::vector<Block> blocks;
+    std::vector<BlockCode> local;    // Allocated on first use too
+    std::array<u32, 0x100> generation {};
+};
+
+#endif    // KORLOW_BLOCK_CACHE_H
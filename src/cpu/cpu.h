@@ -3,9 +3,10 @@
 
 #include <cstdint>
 
-#include "component.h"
 #include "emu_types.h"
 
+struct BlockCache;
+
 enum class HaltBug {
     None,
     Triggered,
@@ -24,21 +25,33 @@ struct CpuRegisters {
     u8& ie;
 };
 
-struct Cpu : Component {
+struct Cpu {
     Cpu(CpuRegisters);
 
-    void reset(bool) override;
-    int tick(Component& mmu);    // Returns # of cycles taken
+    Cpu(const Cpu&) = delete;
+
+    void reset(bool);
+
+    template <typename Bus>
+    int tick(Bus& mmu);    // Returns # of cycles taken
     void enable_interrupts();
     void disable_interrupts();
     void halt();
+    bool interrupt_pending() const;
     void set_enabled(bool value);
     bool is_enabled() const;
     void print_instruction(u16 op, u8 d8, u16 d16);
     void halt_bug();
     void ei_bug();
 
-    int do_instruction(u16 op, u8 d8, u16 d16, Component& mmu);
+    template <typename Bus>
+    int do_instruction(u16 op, u8 d8, u16 d16, Bus& mmu);
+
+    // Switch-dispatched core, executing from `cache`. Runs until `now` reaches
+    // `deadline` or `end`, the CPU halts with nothing pending, or it stops.
+    // Returns # of instructions run.
+    template <typename Bus>
+    u64 run_until(Bus& mmu, BlockCache& cache, u64& now, const u64& deadline, u64 end);
 
     HaltBug halt_bug_state {HaltBug::None};
     EIBug ei_bug_state {EIBug::None};
@@ -84,4 +97,8 @@ struct Cpu : Component {
     bool ime;
 };
 
+// Template definitions of tick(), do_instruction() and run_until()
+#include "cpu/cpu_instructions.h"
+#include "cpu/cpu_switch.h"
+
 #endif    // CPU_H
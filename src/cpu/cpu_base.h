@@ -17,37 +17,285 @@ void RST(CPU *cpu, u16 addr);
 
 // Z00C
 // Sets LSB to carry
-void RL(u8 val, u8 *result, u8 *flags);
+inline void RL(u8 val, u8 *result, u8 *flags)
+{
+    // Z00C
+
+    u8 old_carry = (*flags & FLAGS_CARRY) >> 4;
+    u8 new_carry = val & 0x80;
+    u8 r = (val << 1) | old_carry;
+
+    *flags = 0;
+
+    if (r == 0) {
+        *flags |= FLAGS_ZERO;
+    }
+
+    *flags |= new_carry >> 3;
+
+    *result = r;
+}
 
 // Z00C
 // Doesn't set LSB
-void RLC(u8 val, u8 *result, u8 *flags, bool unset_zero = false);
+inline void RLC(u8 val, u8 *result, u8 *flags, bool unset_zero = false)
+{
+    /* Push the MSB to LSB. */
+    u8 msb = (val & 0x80) >> 7;
+
+    /* Left shift and add the MSB (now LSB). */
+    *result = (val << 1) | msb;
+
+    /* Push the former MSB to the carry flag. */
+    *flags = msb << 4;
+
+    /* RLC A always unsets the zero flag. */
+    if (*result != 0 || unset_zero) {
+        *flags &= ~(FLAGS_ZERO);
+    }
+    else {
+        *flags |= FLAGS_ZERO;
+    }
+}
 
 // Z00C
 // Sets LSB to carry
-void RR(u8 val, u8 *result, u8 *flags);
+inline void RR(u8 val, u8 *result, u8 *flags)
+{
+    u8 carry = *flags & 0x10;
+    u8 lsb = val & 0x1;
+    *result = (val >> 1) | (carry << 3);
+    *flags = lsb << 4;
+    if (!*result) {
+        *flags |= 0x80;
+    }
+}
 
 // Z00C
 // Doesn't set LSB
-void RRC(u8 val, u8 *result, u8 *flags);
+inline void RRC(u8 val, u8 *result, u8 *flags)
+{
+    u8 lsb = val & 0x1;
+    *result = (val >> 1) | (lsb << 7);
+    *flags = lsb << 4;
+    if (!*result) {
+        *flags |= 0x80;
+    }
+}
 
 // Z0HC
-u8 ADD8(u8 a, u8 b, u8 &flags);
-void ADD16(u16 a, u16 b, u16 *result, u8 *flags);
+constexpr u8 ADD8(u8 a, u8 b, u8 &f)
+{
+    // Z0HC
+    f = 0;
+
+    u8 result = a + b;
+
+    if ((a ^ b ^ result) & FLAGS_CARRY) {
+        f |= FLAGS_HALFCARRY;
+    }
+    if (u16(a) + u16(b) > 0xFF) {
+        f |= FLAGS_CARRY;
+    }
+    if (result == 0) {
+        f |= FLAGS_ZERO;
+    }
+
+    return result;
+}
+
+inline void ADD16(u16 a, u16 b, u16 *result, u8 *flags)
+{
+    *flags = 0;
+    *result = a + b;
+    if (((a & 0xFFF) + (b & 0xFFF)) & 0x1000) {
+        *flags |= FLAGS_HALFCARRY;
+    }
+    if ((uint32_t(a) + uint32_t(b)) & 0x10000) {
+        *flags |= FLAGS_CARRY;
+    }
+    if (*result == 0) {
+        *flags |= FLAGS_ZERO;
+    }
+}
 
 // Z1HC
-u8 SUB8(u8 a, u8 b, u8 &flags);
+constexpr u8 SUB8(u8 a, u8 b, u8 &f)
+{
+    // Z1HC
+    f = FLAGS_SUBTRACT;
+    u8 result = a - b;
+    if (!result) {
+        f |= FLAGS_ZERO;
+    }
+    if (b > a) {
+        f |= FLAGS_CARRY;
+    }
+    if ((int(a) & 0xF) - (int(b) & 0xF) < 0) {
+        f |= FLAGS_HALFCARRY;
+    }
+    return result;
+}
 
 // Z0H-
-void INC8(u8 &r, u8 &f);
+constexpr void INC8(u8 &r, u8 &f)
+{
+    u8 carry = f & FLAGS_CARRY;
+    r = ADD8(r, 1, f);
+    f = (f & 0b1110'0000) | carry;
+}
 
 // Z1H-
-void DEC8(u8 &r, u8 &f);
+constexpr void DEC8(u8 &r, u8 &f)
+{
+    u8 carry = f & FLAGS_CARRY;
+    r = SUB8(r, 1, f);
+    f = (f & 0b1110'0000) | carry;
+}
 
 // Generalisations
 class CPU;
-void CP(u8 a, u8 r, u8 &f);
-void SUB(CPU *cpu, u8 r);
-void TestBit(u8 bit, u8 &f);
+constexpr void CP(u8 a, u8 r, u8 &f)
+{
+    (void)SUB8(a, r, f);
+}
+
+inline void SUB(CPU *cpu, u8 r)
+{
+    //u8 flags = 0;
+    //u8 result = 0;
+    //SUB8(Hi(cpu->af), r, &result, &flags);
+    //SetLo(cpu->af, flags);
+    //SetHi(cpu->af, result);
+}
+
+inline void TestBit(u8 bit, u8 &f)
+{
+    u8 flags = FLAGS_HALFCARRY;
+    if (!bit) {
+        flags |= FLAGS_ZERO;
+    }
+    f = (f & FLAGS_CARRY) | flags;
+}
+
+inline void SWAP(u8 &n, u8 &f)
+{
+    u8 hi = (n & 0xF0) >> 4;
+    u8 lo = (n & 0x0F);
+    n = (lo << 4) | hi;
+    f = (!n) ? 0x80 : 0x0;
+}
+
+inline void SRL(u8 &r, u8 &f)
+{
+    /* Shift register right into carry. MSB set to 0. */
+    // Z00C
+    u8 carry = r & 0x1;
+    r >>= 1;
+    u8 flags = 0;
+    if (r == 0) {
+        flags |= FLAGS_ZERO;
+    }
+    if (carry) {
+        flags |= FLAGS_CARRY;
+    }
+    f = flags;
+}
+
+inline void XOR(u8 &a, u8 r, u8 &f)
+{
+    // Z000
+    a ^= r;
+    f = a ? 0 : FLAGS_ZERO;
+}
+
+inline void AND(u8 &a, u8 r, u8 &f)
+{
+    // Z010
+    a &= r;
+    f = a ? FLAGS_HALFCARRY : (FLAGS_ZERO | FLAGS_HALFCARRY);
+}
+
+inline void OR(u8 &a, u8 r, u8 &f)
+{
+    // Z000
+    a |= r;
+    f = a ? 0 : FLAGS_ZERO;
+}
+
+inline void SLA(u8 &r, u8 &f)
+{
+    // Z00C
+    u8 carry = r & 0b1000'0000;
+    r <<= 1;
+    u8 flags = 0;
+    if (!r)
+        flags |= FLAGS_ZERO;
+    if (carry)
+        flags |= FLAGS_CARRY;
+    f = flags;
+}
+
+inline void SRA(u8 &r, u8 &f)
+{
+    // Z00C
+    u8 msb = r & 0b1000'0000;
+    u8 carry = r & 0b0000'0001;
+    r >>= 1;
+    r |= msb;
+    u8 flags = 0;
+    if (!r)
+        flags |= FLAGS_ZERO;
+    if (carry)
+        flags |= FLAGS_CARRY;
+    f = flags;
+}
+
+constexpr void ADC(u8 &a, u8 r, u8 &f)
+{
+    u8 carry = (f & FLAGS_CARRY) >> 4;
+    u8 flags = 0;
+
+    u16 result = a + r + carry;
+
+    if (result > 0xFF) {
+        flags |= FLAGS_CARRY;
+    }
+    if (((a & 0xF) + (r & 0xF) + carry) > 0xF) {
+        flags |= FLAGS_HALFCARRY;
+    }
+    if ((result & 0xFF) == 0) {
+        flags |= FLAGS_ZERO;
+    }
+
+    f = flags;
+    a = result & 0xFF;
+}
+
+constexpr void SBC(u8 &a, u8 r, u8 &f)
+{
+    u8 carry = (f & FLAGS_CARRY) >> 4;
+    u8 flags = FLAGS_SUBTRACT;
+
+    if ((int(a) - int(r) - int(carry)) < 0)
+        flags |= FLAGS_CARRY;
+
+    if ((int(a & 0xF) - int(r & 0xF) - int(carry)) < 0)
+        flags |= FLAGS_HALFCARRY;
+
+    a -= r;
+    a -= carry;
+
+    if (!a)
+        flags |= FLAGS_ZERO;
+
+    f = flags;
+}
+
+// Merges flags according to mask
+inline void SetFlags(u8 &f, u8 flags, u8 mask)
+{
+    f = f ^ ((f ^ flags) & mask);
+}
 
 #endif    // CPU_BASE_H
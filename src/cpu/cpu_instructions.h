@@ -1,402 +1,1948 @@
 #ifndef CPU_INSTRUCTIONS_H
 #define CPU_INSTRUCTIONS_H
 
+/*
+ * Instruction handlers are templated on the bus so that memory accesses inline
+ * into the opcode bodies. Any type with read8/read16/write8/write16 works, e.g.
+ * Mmu or the flat test bus.
+ */
+
+#include <array>
+#include <cstdio>
+#include <utility>
+
+#include "cpu/alu_tables.h"
+#include "cpu/cpu.h"
+#include "cpu/cpu_base.h"
+#include "cpu/inst_data.h"
 #include "emu_types.h"
 
-struct Cpu;
-struct Component;
-using Instruction = void (*)(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-extern const Instruction kInstructions[];
+template <typename Bus>
+using Instruction = void (*)(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles);
 
 // Generic
 
-void UNIMPL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void INVALID(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.set_enabled(false);
+}
+
+template <typename Bus>
+void RST(Cpu &cpu, Bus &mmu, u16 addr)
+{
+    cpu.sp -= 2;
+    mmu.write16(cpu.sp, cpu.pc);
+    cpu.pc = addr;
+}
 
 // 0x00
 
-void NOP(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_BC_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_ABC_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_BC(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_B_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RLCA(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_AIMM16_SP(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_HL_BC(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_ABC(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_BC(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_C_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRCA(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void NOP(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+}
+
+template <typename Bus>
+void LD_BC_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.bc = d16;
+}
+
+template <typename Bus>
+void LD_ABC_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.bc, cpu.a);
+}
+
+template <typename Bus>
+void INC_BC(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.bc++;
+}
+
+template <typename Bus>
+void INC_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::inc(cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void DEC_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::dec(cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void LD_B_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.b = d8;
+}
+
+// x = cpu.a.bit[7]
+// carry = x
+// cpu.a << 1
+// cpu.a |= x
+template <typename Bus>
+void RLCA(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    u8 bit7 = !!(cpu.af & 0b1000'0000'0000'0000);
+    cpu.f = bit7 << 4;
+    cpu.a = (cpu.a << 1) | bit7;
+}
+
+template <typename Bus>
+void LD_AIMM16_SP(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write16(d16, cpu.sp);
+}
+
+template <typename Bus>
+void ADD_HL_BC(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    // -0HC
+    u8 flags = 0;
+    u16 result = 0;
+    ADD16(cpu.hl, cpu.bc, &result, &flags);
+    cpu.hl = result;
+    flags &= 0b0111'0000;
+    cpu.f = (cpu.af & FLAGS_ZERO) | flags;
+}
+
+template <typename Bus>
+void LD_A_ABC(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = mmu.read8(cpu.bc);
+}
+
+template <typename Bus>
+void DEC_BC(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.bc--;
+}
+
+template <typename Bus>
+void INC_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::inc(cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void DEC_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::dec(cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void LD_C_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.bc = (cpu.bc & 0xFF00) + d8;
+}
+
+template <typename Bus>
+void RRCA(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    u8 bit0 = !!(cpu.af & 0b0000'0001'0000'0000);
+    cpu.f = bit0 << 4;
+    cpu.a = ((cpu.a >> 1) & 0b0111'1111) | (bit0 << 7);
+}
 
 // 0x10
 
-void STOP(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_DE_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_ADE_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_DE(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_D_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RLA(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void JR_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_HL_DE(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_ADE(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_DE(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_E_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRA(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void STOP(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+}
+
+template <typename Bus>
+void LD_DE_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.de = d16;
+}
+
+template <typename Bus>
+void LD_ADE_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.de, cpu.a);
+}
+
+template <typename Bus>
+void INC_DE(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.de++;
+}
+
+template <typename Bus>
+void INC_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::inc(cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void DEC_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::dec(cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void LD_D_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.d = d8;
+}
+
+template <typename Bus>
+void RLA(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    u8 flags = cpu.f;
+    u8 result = 0;
+    RL(cpu.a, &result, &flags);
+    cpu.a = result;
+    cpu.f = flags & 0b0111'0000;
+}
+
+template <typename Bus>
+void JR_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.pc += int8_t(d8);
+}
+
+template <typename Bus>
+void ADD_HL_DE(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    // -0HC
+    u8 flags = 0;
+    u16 result = 0;
+    ADD16(cpu.hl, cpu.de, &result, &flags);
+    cpu.hl = result;
+    cpu.f = (flags & 0x70) | (cpu.f & 0x80);
+}
+
+template <typename Bus>
+void LD_A_ADE(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = mmu.read8(cpu.de);
+}
+
+template <typename Bus>
+void DEC_DE(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.de--;
+}
+
+template <typename Bus>
+void INC_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::inc(cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void DEC_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::dec(cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void LD_E_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.e = d8;
+}
+
+template <typename Bus>
+void RRA(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    u8 flags = cpu.f;
+    u8 result = 0;
+    RR(cpu.a, &result, &flags);
+    cpu.f = flags & FLAGS_CARRY;
+    cpu.a = result;
+}
 
 // 0x20
 
-void JR_NZ_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_HL_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LDI_HL_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_HL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_H_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DAA(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void JR_Z_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_HL_HL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LDI_A_HL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_HL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_L_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CPL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void JR_NZ_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (!(cpu.af & FLAGS_ZERO)) {
+        cpu.pc += int8_t(d8);
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void LD_HL_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.hl = d16;
+}
+
+template <typename Bus>
+void LDI_HL_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl++, cpu.a);
+}
+
+template <typename Bus>
+void INC_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::inc(cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void DEC_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::dec(cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void LD_H_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.h = d8;
+}
+
+template <typename Bus>
+void DAA(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    u8 a = cpu.a;
+    u8 f = cpu.f;
+
+    if (!(f & FLAGS_SUBTRACT)) {    // after an addition, adjust if (half-)carry occurred or if result is out of bounds
+        if ((f & FLAGS_CARRY) || a > 0x99) {
+            a += 0x60;
+            f |= FLAGS_CARRY;
+        }
+        if ((f & FLAGS_HALFCARRY) || (a & 0xF) > 0x9)
+            a += 0x6;
+    }
+    else {    // after a subtraction, only adjust if (half-)carry occurred
+        if (f & FLAGS_CARRY)
+            a -= 0x60;
+        if (f & FLAGS_HALFCARRY)
+            a -= 0x6;
+    }
+
+    f &= 0b1101'0000;
+    f = a ? f & 0b0111'0000 : f | 0b1000'0000;
+
+    cpu.a = a;
+    cpu.f = f;
+}
+
+template <typename Bus>
+void JR_Z_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (cpu.af & FLAGS_ZERO) {
+        cpu.pc += int8_t(d8);
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void INC_HL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.hl++;
+}
+
+template <typename Bus>
+void ADD_HL_HL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    // -0HC
+    u8 flags = 0;
+    u16 result = 0;
+    ADD16(cpu.hl, cpu.hl, &result, &flags);
+    cpu.hl = result;
+    cpu.f = (flags & 0x70) | (cpu.f & 0x80);
+}
+
+template <typename Bus>
+void LDI_A_HL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = mmu.read8(cpu.hl);
+    cpu.hl++;
+}
+
+template <typename Bus>
+void DEC_HL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.hl--;
+}
+
+template <typename Bus>
+void INC_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::inc(cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void DEC_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::dec(cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void LD_L_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.l = d8;
+}
+
+template <typename Bus>
+void CPL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = ~cpu.a;
+    u8 old_flags = cpu.f;
+    u8 new_flags = (old_flags & (FLAGS_ZERO | FLAGS_CARRY)) | (FLAGS_SUBTRACT | FLAGS_HALFCARRY);
+    cpu.f = new_flags;
+}
 
 // 0x30
 
-void JR_NC_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_SP_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LDD_HL_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_SP(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);    // 0x35
-void LD_AHL_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SCF(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void JR_C_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);    // 0x38
-void ADD_HL_SP(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LDD_A_HL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_SP(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void INC_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DEC_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CCF(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void JR_NC_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (!(cpu.af & FLAGS_CARRY)) {
+        cpu.pc += int8_t(d8);
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void LD_SP_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.sp = d16;
+}
+
+template <typename Bus>
+void LDD_HL_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl, cpu.a);
+    cpu.hl--;
+}
+
+template <typename Bus>
+void INC_SP(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.sp++;
+}
+
+template <typename Bus>
+void INC_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    u8 result = mmu.read8(cpu.hl);
+    alu::inc(result, cpu.f);
+    mmu.write8(cpu.hl, result);
+}
+
+template <typename Bus>
+void DEC_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    u8 f = 0;
+    u8 result = mmu.read8(cpu.hl);
+    alu::dec(result, f);
+    mmu.write8(cpu.hl, result);
+    cpu.f = (f & 0b1110'0000) | (cpu.af & FLAGS_CARRY);
+}
+
+template <typename Bus>
+void LD_AHL_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl, d8);
+}
+
+template <typename Bus>
+void SCF(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.f = (cpu.f & 0b1000'0000) | 0x10;
+}
+
+template <typename Bus>
+void JR_C_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (cpu.af & FLAGS_CARRY) {
+        cpu.pc += int8_t(d8);
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void ADD_HL_SP(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    // -0HC
+    u8 flags = 0;
+    u16 result = 0;
+    ADD16(cpu.hl, cpu.sp, &result, &flags);
+    cpu.hl = result;
+    flags &= 0b0011'0000;
+    cpu.f = (cpu.f & 0b1000'0000) | flags;
+}
+
+template <typename Bus>
+void LDD_A_HL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = mmu.read8(cpu.hl--);
+}
+
+template <typename Bus>
+void DEC_SP(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.sp--;
+}
+
+template <typename Bus>
+void INC_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::inc(cpu.a, cpu.f);
+}
+
+template <typename Bus>
+void DEC_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::dec(cpu.a, cpu.f);
+}
+
+template <typename Bus>
+void LD_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = d8;
+}
+
+template <typename Bus>
+void CCF(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    u8 old_flags = cpu.f;
+    u8 new_flags = (old_flags & FLAGS_ZERO) | ((~(old_flags & FLAGS_CARRY)) & FLAGS_CARRY);
+    cpu.f = new_flags;
+}
 
 // 0x40
 
-void LD_B_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_B_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_B_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_B_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_B_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_B_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_B_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_B_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_C_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_C_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_C_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_C_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_C_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_C_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_C_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_C_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void LD_B_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    // cpu.b = cpu.b;
+}
+
+template <typename Bus>
+void LD_B_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.b = cpu.c;
+}
+
+template <typename Bus>
+void LD_B_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.b = cpu.d;
+}
+
+template <typename Bus>
+void LD_B_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.b = cpu.e;
+}
+
+template <typename Bus>
+void LD_B_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.b = cpu.h;
+}
+
+template <typename Bus>
+void LD_B_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.b = cpu.l;
+}
+
+template <typename Bus>
+void LD_B_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.b = mmu.read8(cpu.hl);
+}
+
+template <typename Bus>
+void LD_B_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.b = cpu.a;
+}
+
+template <typename Bus>
+void LD_C_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.c = cpu.b;
+}
+
+template <typename Bus>
+void LD_C_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    //
+}
+
+template <typename Bus>
+void LD_C_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.c = cpu.d;
+}
+
+template <typename Bus>
+void LD_C_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.c = cpu.e;
+}
+
+template <typename Bus>
+void LD_C_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.c = cpu.h;
+}
+
+template <typename Bus>
+void LD_C_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.c = cpu.l;
+}
+
+template <typename Bus>
+void LD_C_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.c = mmu.read8(cpu.hl);
+}
+
+template <typename Bus>
+void LD_C_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.c = cpu.a;
+}
 
 // 0x50
 
-void LD_D_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_D_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_D_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_D_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_D_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_D_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_D_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_D_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_E_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_E_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_E_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_E_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_E_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_E_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_E_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_E_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void LD_D_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.d = cpu.b;
+}
+
+template <typename Bus>
+void LD_D_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.d = cpu.c;
+}
+
+template <typename Bus>
+void LD_D_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    //
+}
+
+template <typename Bus>
+void LD_D_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.d = cpu.e;
+}
+
+template <typename Bus>
+void LD_D_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.d = cpu.h;
+}
+
+template <typename Bus>
+void LD_D_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.d = cpu.l;
+}
+
+template <typename Bus>
+void LD_D_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.d = mmu.read8(cpu.hl);
+}
+
+template <typename Bus>
+void LD_D_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.d = cpu.a;
+}
+
+template <typename Bus>
+void LD_E_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.e = cpu.b;
+}
+
+template <typename Bus>
+void LD_E_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.e = cpu.c;
+}
+
+template <typename Bus>
+void LD_E_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.e = cpu.d;
+}
+
+template <typename Bus>
+void LD_E_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    //
+}
+
+template <typename Bus>
+void LD_E_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.e = cpu.h;
+}
+
+template <typename Bus>
+void LD_E_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.e = cpu.l;
+}
+
+template <typename Bus>
+void LD_E_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.e = mmu.read8(cpu.hl);
+}
+
+template <typename Bus>
+void LD_E_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.e = cpu.a;
+}
 
 // 0x60
 
-void LD_H_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_H_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_H_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_H_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_H_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_H_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_H_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_H_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_L_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_L_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_L_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_L_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_L_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_L_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_L_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_L_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void LD_H_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.h = cpu.b;
+}
+
+template <typename Bus>
+void LD_H_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.h = cpu.c;
+}
+
+template <typename Bus>
+void LD_H_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.h = cpu.d;
+}
+
+template <typename Bus>
+void LD_H_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.h = cpu.e;
+}
+
+template <typename Bus>
+void LD_H_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    //
+}
+
+template <typename Bus>
+void LD_H_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.h = cpu.l;
+}
+
+template <typename Bus>
+void LD_H_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.h = mmu.read8(cpu.hl);
+}
+
+template <typename Bus>
+void LD_H_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.h = cpu.a;
+}
+
+template <typename Bus>
+void LD_L_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.l = cpu.b;
+}
+
+template <typename Bus>
+void LD_L_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.l = cpu.c;
+}
+
+template <typename Bus>
+void LD_L_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.l = cpu.d;
+}
+
+template <typename Bus>
+void LD_L_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.l = cpu.e;
+}
+
+template <typename Bus>
+void LD_L_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.l = cpu.h;
+}
+
+template <typename Bus>
+void LD_L_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    //
+}
+
+template <typename Bus>
+void LD_L_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.l = mmu.read8(cpu.hl);
+}
+
+template <typename Bus>
+void LD_L_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.l = cpu.a;
+}
 
 // 0x70
 
-void LD_AHL_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_AHL_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_AHL_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_AHL_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_AHL_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_AHL_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void HALT(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_AHL_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void LD_AHL_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl, cpu.b);
+}
+
+template <typename Bus>
+void LD_AHL_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl, cpu.c);
+}
+
+template <typename Bus>
+void LD_AHL_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl, cpu.d);
+}
+
+template <typename Bus>
+void LD_AHL_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl, cpu.e);
+}
+
+template <typename Bus>
+void LD_AHL_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl, cpu.h);
+}
+
+template <typename Bus>
+void LD_AHL_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl, cpu.l);
+}
+
+template <typename Bus>
+void HALT(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.halt();
+}
+
+template <typename Bus>
+void LD_AHL_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(cpu.hl, cpu.a);
+}
+
+template <typename Bus>
+void LD_A_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = cpu.b;
+}
+
+template <typename Bus>
+void LD_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = cpu.c;
+}
+
+template <typename Bus>
+void LD_A_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = cpu.d;
+}
+
+template <typename Bus>
+void LD_A_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = cpu.e;
+}
+
+template <typename Bus>
+void LD_A_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = cpu.h;
+}
+
+template <typename Bus>
+void LD_A_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = cpu.l;
+}
+
+template <typename Bus>
+void LD_A_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = mmu.read8(cpu.hl);
+}
+
+template <typename Bus>
+void LD_A_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    // cpu.a = cpu.a;
+}
 
 // 0x80
 
-void ADD_A_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_A_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_A_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_A_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_A_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_A_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_A_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADC_A_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADC_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADC_A_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADC_A_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADC_A_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADC_A_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADC_A_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADC_A_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void ADD_A_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::add(cpu.a, cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void ADD_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::add(cpu.a, cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void ADD_A_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::add(cpu.a, cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void ADD_A_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::add(cpu.a, cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void ADD_A_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::add(cpu.a, cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void ADD_A_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::add(cpu.a, cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void ADD_A_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::add(cpu.a, mmu.read8(cpu.hl), cpu.f);
+}
+
+template <typename Bus>
+void ADD_A_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::add(cpu.a, cpu.a, cpu.f);
+}
+
+template <typename Bus>
+void ADC_A_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::adc(cpu.a, cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void ADC_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::adc(cpu.a, cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void ADC_A_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::adc(cpu.a, cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void ADC_A_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::adc(cpu.a, cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void ADC_A_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::adc(cpu.a, cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void ADC_A_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::adc(cpu.a, cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void ADC_A_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::adc(cpu.a, mmu.read8(cpu.hl), cpu.f);
+}
+
+template <typename Bus>
+void ADC_A_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::adc(cpu.a, cpu.a, cpu.f);
+}
 
 // 0x90
 
-void SUB_A_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SUB_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SUB_A_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SUB_A_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SUB_A_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SUB_A_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SUB_A_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SUB_A_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SBC_A_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SBC_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SBC_A_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SBC_A_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SBC_A_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SBC_A_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SBC_A_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SBC_A_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void SUB_A_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::sub(cpu.a, cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void SUB_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::sub(cpu.a, cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void SUB_A_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::sub(cpu.a, cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void SUB_A_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::sub(cpu.a, cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void SUB_A_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::sub(cpu.a, cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void SUB_A_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::sub(cpu.a, cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void SUB_A_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::sub(cpu.a, mmu.read8(cpu.hl), cpu.f);
+}
+
+template <typename Bus>
+void SUB_A_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::sub(cpu.a, cpu.a, cpu.f);
+}
+
+template <typename Bus>
+void SBC_A_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::sbc(cpu.a, cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void SBC_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::sbc(cpu.a, cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void SBC_A_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::sbc(cpu.a, cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void SBC_A_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::sbc(cpu.a, cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void SBC_A_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::sbc(cpu.a, cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void SBC_A_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::sbc(cpu.a, cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void SBC_A_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::sbc(cpu.a, mmu.read8(cpu.hl), cpu.f);
+}
+
+template <typename Bus>
+void SBC_A_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::sbc(cpu.a, cpu.a, cpu.f);
+}
 
 // 0xA0
 
-void AND_A_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void AND_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void AND_A_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void AND_A_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void AND_A_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void AND_A_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void AND_A_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void AND_A_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void XOR_A_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void XOR_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void XOR_A_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void XOR_A_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void XOR_A_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void XOR_A_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void XOR_A_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void XOR_A_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void AND_A_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    AND(cpu.a, cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void AND_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    AND(cpu.a, cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void AND_A_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    AND(cpu.a, cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void AND_A_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    AND(cpu.a, cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void AND_A_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    AND(cpu.a, cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void AND_A_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    AND(cpu.a, cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void AND_A_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    AND(cpu.a, mmu.read8(cpu.hl), cpu.f);
+}
+
+template <typename Bus>
+void AND_A_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    AND(cpu.a, cpu.a, cpu.f);
+}
+
+template <typename Bus>
+void XOR_A_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    XOR(cpu.a, cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void XOR_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    XOR(cpu.a, cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void XOR_A_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    XOR(cpu.a, cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void XOR_A_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    XOR(cpu.a, cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void XOR_A_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    XOR(cpu.a, cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void XOR_A_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    XOR(cpu.a, cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void XOR_A_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    XOR(cpu.a, mmu.read8(cpu.hl), cpu.f);
+}
+
+template <typename Bus>
+void XOR_A_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    XOR(cpu.a, cpu.a, cpu.f);
+}
 
 // 0xB0
 
-void OR_A_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void OR_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void OR_A_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void OR_A_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void OR_A_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void OR_A_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void OR_A_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void OR_A_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CP_A_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CP_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CP_A_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CP_A_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CP_A_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CP_A_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CP_A_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CP_A_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void OR_A_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    OR(cpu.a, cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void OR_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    OR(cpu.a, cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void OR_A_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    OR(cpu.a, cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void OR_A_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    OR(cpu.a, cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void OR_A_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    OR(cpu.a, cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void OR_A_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    OR(cpu.a, cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void OR_A_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    OR(cpu.a, mmu.read8(cpu.hl), cpu.f);
+}
+
+template <typename Bus>
+void OR_A_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    OR(cpu.a, cpu.a, cpu.f);
+}
+
+template <typename Bus>
+void CP_A_B(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::cp(cpu.a, cpu.b, cpu.f);
+}
+
+template <typename Bus>
+void CP_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::cp(cpu.a, cpu.c, cpu.f);
+}
+
+template <typename Bus>
+void CP_A_D(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::cp(cpu.a, cpu.d, cpu.f);
+}
+
+template <typename Bus>
+void CP_A_E(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::cp(cpu.a, cpu.e, cpu.f);
+}
+
+template <typename Bus>
+void CP_A_H(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::cp(cpu.a, cpu.h, cpu.f);
+}
+
+template <typename Bus>
+void CP_A_L(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::cp(cpu.a, cpu.l, cpu.f);
+}
+
+template <typename Bus>
+void CP_A_AHL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::cp(cpu.a, mmu.read8(cpu.hl), cpu.f);
+}
+
+template <typename Bus>
+void CP_A_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::cp(cpu.a, cpu.a, cpu.f);
+}
 
 // 0xC0
 
-void RET_NZ(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void POP_BC(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void JP_NZ_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void JP_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CALL_NZ_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void PUSH_BC(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RST_00(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RET_Z(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RET(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void JP_Z_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CB(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CALL_Z_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CALL_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADC_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RST_08(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void RET_NZ(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (!(cpu.af & FLAGS_ZERO)) {
+        cpu.pc = mmu.read16(cpu.sp);
+        cpu.sp += 2;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void POP_BC(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.bc = mmu.read16(cpu.sp);
+    cpu.sp += 2;
+}
+
+template <typename Bus>
+void JP_NZ_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (!(cpu.af & FLAGS_ZERO)) {
+        cpu.pc = d16;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void JP_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.pc = d16;
+}
+
+template <typename Bus>
+void CALL_NZ_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (!(cpu.af & FLAGS_ZERO)) {
+        cpu.sp -= 2;
+        mmu.write16(cpu.sp, cpu.pc);
+        cpu.pc = d16;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void PUSH_BC(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.sp -= 2;
+    mmu.write16(cpu.sp, cpu.bc);
+}
+
+template <typename Bus>
+void ADD_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::add(cpu.a, d8, cpu.f);
+}
+
+template <typename Bus>
+void RST_00(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    RST(cpu, mmu, 0x00);
+}
+
+template <typename Bus>
+void RET_Z(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (cpu.af & FLAGS_ZERO) {
+        cpu.pc = mmu.read16(cpu.sp);
+        cpu.sp += 2;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void RET(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.pc = mmu.read16(cpu.sp);
+    cpu.sp += 2;
+}
+
+template <typename Bus>
+void JP_Z_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (cpu.af & FLAGS_ZERO) {
+        cpu.pc = d16;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void CB(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+}
+
+template <typename Bus>
+void CALL_Z_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (cpu.af & FLAGS_ZERO) {
+        cpu.sp -= 2;
+        mmu.write16(cpu.sp, cpu.pc);
+        cpu.pc = d16;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void CALL_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.sp -= 2;
+    mmu.write16(cpu.sp, cpu.pc);
+    cpu.pc = d16;
+}
+
+template <typename Bus>
+void ADC_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::adc(cpu.a, d8, cpu.f);
+}
+
+template <typename Bus>
+void RST_08(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    RST(cpu, mmu, 0x08);
+}
 
 // 0xD0
 
-void RET_NC(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void POP_DE(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void JP_NC_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CALL_NC_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void PUSH_DE(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SUB_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RST_10(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RET_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RETI(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void JP_C_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CALL_C_IMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SBC_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RST_18(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void RET_NC(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (!(cpu.af & FLAGS_CARRY)) {
+        cpu.pc = mmu.read16(cpu.sp);
+        cpu.sp += 2;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void POP_DE(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.de = mmu.read16(cpu.sp);
+    cpu.sp += 2;
+}
+
+template <typename Bus>
+void JP_NC_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (!(cpu.af & FLAGS_CARRY)) {
+        cpu.pc = d16;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void CALL_NC_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (!(cpu.af & FLAGS_CARRY)) {
+        cpu.sp -= 2;
+        mmu.write16(cpu.sp, cpu.pc);
+        cpu.pc = d16;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void PUSH_DE(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.sp -= 2;
+    mmu.write16(cpu.sp, cpu.de);
+}
+
+template <typename Bus>
+void RET_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (cpu.af & FLAGS_CARRY) {
+        cpu.pc = mmu.read16(cpu.sp);
+        cpu.sp += 2;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void RETI(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.enable_interrupts();
+    cpu.pc = mmu.read16(cpu.sp);
+    cpu.sp += 2;
+}
+
+template <typename Bus>
+void JP_C_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (cpu.af & FLAGS_CARRY) {
+        cpu.pc = d16;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void SUB_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = alu::sub(cpu.a, d8, cpu.f);
+}
+
+template <typename Bus>
+void RST_10(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    RST(cpu, mmu, 0x10);
+}
+
+template <typename Bus>
+void CALL_C_IMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if (cpu.af & FLAGS_CARRY) {
+        cpu.sp -= 2;
+        mmu.write16(cpu.sp, cpu.pc);
+        cpu.pc = d16;
+        extraCycles = true;
+    }
+}
+
+template <typename Bus>
+void SBC_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::sbc(cpu.a, d8, cpu.f);
+}
+
+template <typename Bus>
+void RST_18(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    RST(cpu, mmu, 0x18);
+}
 
 // 0xE0
 
-void LDH_IMM8_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void POP_HL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LDH_C_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void PUSH_HL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void AND_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RST_20(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void ADD_SP_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void JP_HL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_AIMM16_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void XOR_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RST_28(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void LDH_IMM8_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(0xFF00 + d8, cpu.a);
+}
+
+template <typename Bus>
+void POP_HL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.hl = mmu.read16(cpu.sp);
+    cpu.sp += 2;
+}
+
+template <typename Bus>
+void LDH_C_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(0xFF00 + cpu.c, cpu.a);
+}
+
+template <typename Bus>
+void PUSH_HL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.sp -= 2;
+    mmu.write16(cpu.sp, cpu.hl);
+}
+
+template <typename Bus>
+void AND_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    AND(cpu.a, d8, cpu.f);
+}
+
+template <typename Bus>
+void RST_20(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    RST(cpu, mmu, 0x20);
+}
+
+template <typename Bus>
+void ADD_SP_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    // 00HC
+    u8 flags = 0;
+
+    if (((cpu.sp & 0xF) + (d8 & 0xF)) & 0x10)
+        flags |= FLAGS_HALFCARRY;
+
+    if (((cpu.sp & 0xFF) + d8) > 0xFF)
+        flags |= FLAGS_CARRY;
+
+    cpu.sp = cpu.sp + int8_t(d8);
+    cpu.f = flags;
+}
+
+template <typename Bus>
+void JP_HL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.pc = cpu.hl;
+}
+
+template <typename Bus>
+void LD_AIMM16_A(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    mmu.write8(d16, cpu.a);
+}
+
+template <typename Bus>
+void XOR_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    XOR(cpu.a, d8, cpu.f);
+}
+
+template <typename Bus>
+void RST_28(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    RST(cpu, mmu, 0x28);
+}
 
 // 0xF0
 
-void LDH_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void POP_AF(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LDH_A_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void DI(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void PUSH_AF(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void OR_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RST_30(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_HL_SPIMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_SP_HL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void LD_A_AIMM16(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void EI(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-// void INVALID(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void CP_A_IMM8(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RST_38(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+void LDH_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = mmu.read8(0xFF00 + d8);
+}
+
+template <typename Bus>
+void POP_AF(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.af = mmu.read16(cpu.sp) & 0xFFF0;
+    cpu.sp += 2;
+}
+
+template <typename Bus>
+void LDH_A_C(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = mmu.read8(0xFF00 + cpu.c);
+}
+
+template <typename Bus>
+void DI(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.disable_interrupts();
+}
+
+template <typename Bus>
+void PUSH_AF(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.sp -= 2;
+    mmu.write16(cpu.sp, cpu.af);
+}
+
+template <typename Bus>
+void OR_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    OR(cpu.a, d8, cpu.f);
+}
+
+template <typename Bus>
+void RST_30(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    RST(cpu, mmu, 0x30);
+}
+
+template <typename Bus>
+void LD_HL_SPIMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    u8 flags = 0;
+
+    int8_t s8 = d8;
+    u16 sp = cpu.sp + s8;
+    if (s8 > 0) {
+        if (((cpu.sp & 0xFF) + s8) > 0xFF) {
+            flags |= FLAGS_CARRY;
+        }
+        if (((cpu.sp & 0xF) + (s8 & 0xF)) > 0xF) {
+            flags |= FLAGS_HALFCARRY;
+        }
+    }
+    else {
+        if ((sp & 0xFF) < (cpu.sp & 0xFF)) {
+            flags |= FLAGS_CARRY;
+        }
+        if ((sp & 0xF) < (cpu.sp & 0xF)) {
+            flags |= FLAGS_HALFCARRY;
+        }
+    }
+
+    cpu.f = flags;
+
+    cpu.hl = sp;
+}
+
+template <typename Bus>
+void LD_SP_HL(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.sp = cpu.hl;
+}
+
+template <typename Bus>
+void LD_A_AIMM16(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.a = mmu.read8(d16);
+}
+
+template <typename Bus>
+void EI(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    cpu.enable_interrupts();
+}
+
+template <typename Bus>
+void CP_A_IMM8(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    alu::cp(cpu.a, d8, cpu.f);
+}
+
+template <typename Bus>
+void RST_38(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    RST(cpu, mmu, 0x38);
+}
 
 // 0xCB // Extended
+//
+// Bits 0-2 of a CB opcode pick the operand (B, C, D, E, H, L, (HL), A) and bits
+// 3-7 the operation and bit index, so all 256 handlers come from one template.
+// The (HL) variants are separate instantiations that go through the bus.
 
-// 0x00
+template <int Reg>
+u8 &cb_operand(Cpu &cpu)
+{
+    static_assert(Reg != 6, "(HL) goes through the bus");
+    if constexpr (Reg == 0) {
+        return cpu.b;
+    }
+    else if constexpr (Reg == 1) {
+        return cpu.c;
+    }
+    else if constexpr (Reg == 2) {
+        return cpu.d;
+    }
+    else if constexpr (Reg == 3) {
+        return cpu.e;
+    }
+    else if constexpr (Reg == 4) {
+        return cpu.h;
+    }
+    else if constexpr (Reg == 5) {
+        return cpu.l;
+    }
+    else {
+        return cpu.a;
+    }
+}
 
-void RLC_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RLC_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RLC_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RLC_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RLC_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RLC_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RLC_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RLC_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRC_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRC_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRC_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRC_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRC_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRC_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRC_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RRC_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <int Op>
+void cb_apply(u8 &value, u8 &f)
+{
+    constexpr u8 kMask = 1 << ((Op >> 3) & 7);
 
-// 0x10
+    if constexpr (Op < 0x08) {
+        u8 flags = 0;
+        u8 result = 0;
+        RLC(value, &result, &flags, Op == 0x07);    // RLC A clears Z, like RLCA
+        value = result;
+        f = flags;
+    }
+    else if constexpr (Op < 0x10) {
+        u8 flags = 0;
+        u8 result = 0;
+        RRC(value, &result, &flags);
+        value = result;
+        f = flags;
+    }
+    else if constexpr (Op < 0x18) {
+        u8 flags = f & FLAGS_CARRY;
+        u8 result = 0;
+        RL(value, &result, &flags);
+        value = result;
+        f = flags;
+    }
+    else if constexpr (Op < 0x20) {
+        u8 flags = f & FLAGS_CARRY;
+        u8 result = 0;
+        RR(value, &result, &flags);
+        value = result;
+        f = flags;
+    }
+    else if constexpr (Op < 0x28) {
+        SLA(value, f);
+    }
+    else if constexpr (Op < 0x30) {
+        SRA(value, f);
+    }
+    else if constexpr (Op < 0x38) {
+        SWAP(value, f);
+    }
+    else if constexpr (Op < 0x40) {
+        SRL(value, f);
+    }
+    else if constexpr (Op < 0x80) {
+        TestBit(value & kMask, f);
+    }
+    else if constexpr (Op < 0xC0) {
+        value &= static_cast<u8>(~kMask);
+    }
+    else {
+        value |= kMask;
+    }
+}
 
-void RL_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RL_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RL_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RL_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RL_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RL_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RL_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RL_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RR_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RR_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RR_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RR_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RR_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RR_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RR_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void RR_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus, int Op>
+void CB(Cpu &cpu, Bus &mmu, u8 d8, u16 d16, bool &extraCycles)
+{
+    if constexpr ((Op & 7) == 6) {
+        u8 value {mmu.read8(cpu.hl)};
+        cb_apply<Op>(value, cpu.f);
+        if constexpr (Op < 0x40 || Op >= 0x80) {    // BIT only reads
+            mmu.write8(cpu.hl, value);
+        }
+    }
+    else {
+        cb_apply<Op>(cb_operand<Op & 7>(cpu), cpu.f);
+    }
+}
 
-// 0x20
+// clang-format off
 
-void SLA_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SLA_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SLA_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SLA_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SLA_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SLA_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SLA_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SLA_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRA_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRA_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRA_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRA_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRA_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRA_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRA_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRA_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus, int... Op>
+constexpr std::array<Instruction<Bus>, 0x200> make_instructions(std::integer_sequence<int, Op...>)
+{
+    return {
+/*      0                1                 2                 3              4                   5              6                 7              8                  9               A                 B             C                  D                E                F   */
+/* 0 */ NOP<Bus>,        LD_BC_IMM16<Bus>, LD_ABC_A<Bus>,    INC_BC<Bus>,   INC_B<Bus>,         DEC_B<Bus>,    LD_B_IMM8<Bus>,   RLCA<Bus>,     LD_AIMM16_SP<Bus>, ADD_HL_BC<Bus>, LD_A_ABC<Bus>,    DEC_BC<Bus>,  INC_C<Bus>,        DEC_C<Bus>,      LD_C_IMM8<Bus>,  RRCA<Bus>,
+/* 1 */ STOP<Bus>,       LD_DE_IMM16<Bus>, LD_ADE_A<Bus>,    INC_DE<Bus>,   INC_D<Bus>,         DEC_D<Bus>,    LD_D_IMM8<Bus>,   RLA<Bus>,      JR_IMM8<Bus>,      ADD_HL_DE<Bus>, LD_A_ADE<Bus>,    DEC_DE<Bus>,  INC_E<Bus>,        DEC_E<Bus>,      LD_E_IMM8<Bus>,  RRA<Bus>,
+/* 2 */ JR_NZ_IMM8<Bus>, LD_HL_IMM16<Bus>, LDI_HL_A<Bus>,    INC_HL<Bus>,   INC_H<Bus>,         DEC_H<Bus>,    LD_H_IMM8<Bus>,   DAA<Bus>,      JR_Z_IMM8<Bus>,    ADD_HL_HL<Bus>, LDI_A_HL<Bus>,    DEC_HL<Bus>,  INC_L<Bus>,        DEC_L<Bus>,      LD_L_IMM8<Bus>,  CPL<Bus>,
+/* 3 */ JR_NC_IMM8<Bus>, LD_SP_IMM16<Bus>, LDD_HL_A<Bus>,    INC_SP<Bus>,   INC_AHL<Bus>,       DEC_AHL<Bus>,  LD_AHL_IMM8<Bus>, SCF<Bus>,      JR_C_IMM8<Bus>,    ADD_HL_SP<Bus>, LDD_A_HL<Bus>,    DEC_SP<Bus>,  INC_A<Bus>,        DEC_A<Bus>,      LD_A_IMM8<Bus>,  CCF<Bus>,
+/* 4 */ LD_B_B<Bus>,     LD_B_C<Bus>,      LD_B_D<Bus>,      LD_B_E<Bus>,   LD_B_H<Bus>,        LD_B_L<Bus>,   LD_B_AHL<Bus>,    LD_B_A<Bus>,   LD_C_B<Bus>,       LD_C_C<Bus>,    LD_C_D<Bus>,      LD_C_E<Bus>,  LD_C_H<Bus>,       LD_C_L<Bus>,     LD_C_AHL<Bus>,   LD_C_A<Bus>,
+/* 5 */ LD_D_B<Bus>,     LD_D_C<Bus>,      LD_D_D<Bus>,      LD_D_E<Bus>,   LD_D_H<Bus>,        LD_D_L<Bus>,   LD_D_AHL<Bus>,    LD_D_A<Bus>,   LD_E_B<Bus>,       LD_E_C<Bus>,    LD_E_D<Bus>,      LD_E_E<Bus>,  LD_E_H<Bus>,       LD_E_L<Bus>,     LD_E_AHL<Bus>,   LD_E_A<Bus>,
+/* 6 */ LD_H_B<Bus>,     LD_H_C<Bus>,      LD_H_D<Bus>,      LD_H_E<Bus>,   LD_H_H<Bus>,        LD_H_L<Bus>,   LD_H_AHL<Bus>,    LD_H_A<Bus>,   LD_L_B<Bus>,       LD_L_C<Bus>,    LD_L_D<Bus>,      LD_L_E<Bus>,  LD_L_H<Bus>,       LD_L_L<Bus>,     LD_L_AHL<Bus>,   LD_L_A<Bus>,
+/* 7 */ LD_AHL_B<Bus>,   LD_AHL_C<Bus>,    LD_AHL_D<Bus>,    LD_AHL_E<Bus>, LD_AHL_H<Bus>,      LD_AHL_L<Bus>, HALT<Bus>,        LD_AHL_A<Bus>, LD_A_B<Bus>,       LD_A_C<Bus>,    LD_A_D<Bus>,      LD_A_E<Bus>,  LD_A_H<Bus>,       LD_A_L<Bus>,     LD_A_AHL<Bus>,   LD_A_A<Bus>,
+/* 8 */ ADD_A_B<Bus>,    ADD_A_C<Bus>,     ADD_A_D<Bus>,     ADD_A_E<Bus>,  ADD_A_H<Bus>,       ADD_A_L<Bus>,  ADD_A_AHL<Bus>,   ADD_A_A<Bus>,  ADC_A_B<Bus>,      ADC_A_C<Bus>,   ADC_A_D<Bus>,     ADC_A_E<Bus>, ADC_A_H<Bus>,      ADC_A_L<Bus>,    ADC_A_AHL<Bus>,  ADC_A_A<Bus>,
+/* 9 */ SUB_A_B<Bus>,    SUB_A_C<Bus>,     SUB_A_D<Bus>,     SUB_A_E<Bus>,  SUB_A_H<Bus>,       SUB_A_L<Bus>,  SUB_A_AHL<Bus>,   SUB_A_A<Bus>,  SBC_A_B<Bus>,      SBC_A_C<Bus>,   SBC_A_D<Bus>,     SBC_A_E<Bus>, SBC_A_H<Bus>,      SBC_A_L<Bus>,    SBC_A_AHL<Bus>,  SBC_A_A<Bus>,
+/* A */ AND_A_B<Bus>,    AND_A_C<Bus>,     AND_A_D<Bus>,     AND_A_E<Bus>,  AND_A_H<Bus>,       AND_A_L<Bus>,  AND_A_AHL<Bus>,   AND_A_A<Bus>,  XOR_A_B<Bus>,      XOR_A_C<Bus>,   XOR_A_D<Bus>,     XOR_A_E<Bus>, XOR_A_H<Bus>,      XOR_A_L<Bus>,    XOR_A_AHL<Bus>,  XOR_A_A<Bus>,
+/* B */ OR_A_B<Bus>,     OR_A_C<Bus>,      OR_A_D<Bus>,      OR_A_E<Bus>,   OR_A_H<Bus>,        OR_A_L<Bus>,   OR_A_AHL<Bus>,    OR_A_A<Bus>,   CP_A_B<Bus>,       CP_A_C<Bus>,    CP_A_D<Bus>,      CP_A_E<Bus>,  CP_A_H<Bus>,       CP_A_L<Bus>,     CP_A_AHL<Bus>,   CP_A_A<Bus>,
+/* C */ RET_NZ<Bus>,     POP_BC<Bus>,      JP_NZ_IMM16<Bus>, JP_IMM16<Bus>, CALL_NZ_IMM16<Bus>, PUSH_BC<Bus>,  ADD_A_IMM8<Bus>,  RST_00<Bus>,   RET_Z<Bus>,        RET<Bus>,       JP_Z_IMM16<Bus>,  CB<Bus>,      CALL_Z_IMM16<Bus>, CALL_IMM16<Bus>, ADC_A_IMM8<Bus>, RST_08<Bus>,
+/* D */ RET_NC<Bus>,     POP_DE<Bus>,      JP_NC_IMM16<Bus>, INVALID<Bus>,  CALL_NC_IMM16<Bus>, PUSH_DE<Bus>,  SUB_A_IMM8<Bus>,  RST_10<Bus>,   RET_C<Bus>,        RETI<Bus>,      JP_C_IMM16<Bus>,  INVALID<Bus>, CALL_C_IMM16<Bus>, INVALID<Bus>,    SBC_A_IMM8<Bus>, RST_18<Bus>,
+/* E */ LDH_IMM8_A<Bus>, POP_HL<Bus>,      LDH_C_A<Bus>,     INVALID<Bus>,  INVALID<Bus>,       PUSH_HL<Bus>,  AND_A_IMM8<Bus>,  RST_20<Bus>,   ADD_SP_IMM8<Bus>,  JP_HL<Bus>,     LD_AIMM16_A<Bus>, INVALID<Bus>, INVALID<Bus>,      INVALID<Bus>,    XOR_A_IMM8<Bus>, RST_28<Bus>,
+/* F */ LDH_A_IMM8<Bus>, POP_AF<Bus>,      LDH_A_C<Bus>,     DI<Bus>,       INVALID<Bus>,       PUSH_AF<Bus>,  OR_A_IMM8<Bus>,   RST_30<Bus>,   LD_HL_SPIMM8<Bus>, LD_SP_HL<Bus>,  LD_A_AIMM16<Bus>, EI<Bus>,      INVALID<Bus>,      INVALID<Bus>,    CP_A_IMM8<Bus>,  RST_38<Bus>,
+/* CB */ CB<Bus, Op>...,
+    };
+}
 
-// 0x30
+template <typename Bus>
+inline constexpr std::array<Instruction<Bus>, 0x200> kInstructions {make_instructions<Bus>(std::make_integer_sequence<int, 0x100> {})};
 
-void SWAP_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SWAP_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SWAP_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SWAP_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SWAP_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SWAP_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SWAP_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SWAP_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRL_B(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRL_C(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRL_D(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRL_E(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRL_H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRL_L(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRL_AHL(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
-void SRL_A(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+// clang-format on
 
-// 0x70
+template <typename Bus>
+bool cpu_interrupt(Cpu* cpu, Bus* mmu, u8 interrupt_bit)
+{
+    constexpr static u16 kInterruptVectors[] = {0x40, 0x48, 0x50, 0x58, 0x60};
+
+    if (interrupt_bit > 5) {    // there is no interrupt past bit 5
+        fprintf(stderr, "Bad interrupt bit: %02x. Must be one of {0, 1, 2, 3, 4}\n", interrupt_bit);
+        return false;
+    }
+
+    cpu->ime = false;
+    cpu->registers.if_ &= ~(1u << interrupt_bit);
+    cpu->sp -= 2;
+    mmu->write16(cpu->sp, cpu->pc);
+
+    /* I can't remember why I originally had this. */
+    if (0 /* || alt_behaviour */) {
+        mmu->write8(--cpu->sp, (cpu->pc & 0xFF00) >> 8);
+        u8 new_if = cpu->registers.if_ & cpu->registers.ie;
+        if (new_if == 0)
+            cpu->pc = 0;
+        mmu->write8(--cpu->sp, cpu->pc & 0xFF);
+    }
+
+    cpu->pc = kInterruptVectors[interrupt_bit];
+
+    return true;
+}
+
+template <typename Bus>
+bool cpu_process_interrupts(Cpu* cpu, Bus* mmu)
+{
+    bool did_interrupt {false};
+
+    if (cpu->ime && (cpu->registers.ie & cpu->registers.if_)) {
+        for (int i = 0; i < 5; i++) {
+            if (cpu->registers.ie & (cpu->registers.if_ & (1u << i))) {
+                did_interrupt = cpu_interrupt(cpu, mmu, i);
+                break;
+            }
+        }
+    }
+
+    return did_interrupt;
+}
+
+template <typename Bus>
+int Cpu::tick(Bus& mmu)
+{
+    int cycles = 0;
+
+    if (cpu_process_interrupts(this, &mmu)) {
+        cycles += 4;
+        halted = false;
+    }
+    else if (halted) {
+        // Wakes on any pending interrupt, even with IME off
+        if (!interrupt_pending()) {
+            return 4;
+        }
+        halted = false;
+    }
+
+    u16 op {mmu.read8(pc)};
+    u16 d16 {mmu.read16(pc + 1)};
+    u8 d8 = d16 & 0xFF;
+
+    if (op == 0xCB)
+        op = d8 + 0x100;
+
+    if (debug) {
+        print_instruction(op, d8, d16);
+    }
+
+    pc += kInstSizes[op];
+
+    if (op > 0xFF)    // CB
+        pc++;
+
+    cycles += do_instruction(op, d8, d16, mmu);
+
+    halt_bug();
+    ei_bug();
+
+    return cycles;
+}
 
-void BIT_7H(Cpu &cpu, Component &mmu, u8 d8, u16 d16, bool &extraCycles);
+template <typename Bus>
+int Cpu::do_instruction(u16 op, u8 d8, u16 d16, Bus& mmu)
+{
+    bool extra_cycles {false};
+    kInstructions<Bus>[op](*this, mmu, d8, d16, extra_cycles);
+    return extra_cycles ? kInstCyclesAlt[op] : kInstCycles[op];
+}
 
 #endif    // CPU_INSTRUCTIONS_H
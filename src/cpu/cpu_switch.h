@@ -0,0 +1,2222 @@
+#ifndef KORLOW_CPU_SWITCH_H
+#define KORLOW_CPU_SWITCH_H
+
+/*
+ * Switch-dispatched interpreter. Does the same thing as tick() but keeps the
+ * registers in locals for the whole run, so they live in host registers instead
+ * of being loaded from and stored to the Cpu on every instruction.
+ *
+ * Instructions come pre-fetched and pre-decoded from the block cache, so the
+ * bytes at PC are only read once per block rather than once per instruction.
+ *
+ * Each case mirrors its handler in cpu_instructions.h exactly, including the
+ * flag quirks; tests/cpu_core.cpp checks the two against each other.
+ *
+ * Idioms the block cache marks as fused (copy, poll and delay loops) run as one
+ * case with the same results and cycle counts as running them one by one. Idle
+ * loops (see BlockCache) are skipped up to the next event, and poll loops up to
+ * when the register they read next changes (Mmu::next_change).
+ *
+ * With KORLOW_LAZY_FLAGS, F is a LazyFlags that only computes the flags when
+ * they're read.
+ */
+
+#include <algorithm>
+
+#include "cpu/alu_tables.h"
+#include "cpu/block_cache.h"
+#include "cpu/cpu.h"
+#include "cpu/cpu_base.h"
+#include "cpu/inst_data.h"
+#include "emu_types.h"
+
+#ifdef KORLOW_LAZY_FLAGS
+#include "cpu/lazy_flags.h"
+#endif
+
+template <typename Bus>
+u64 Cpu::run_until(Bus& mmu, BlockCache& cache, u64& now, const u64& deadline, u64 end)
+{
+    u8 a {this->a};
+#ifdef KORLOW_LAZY_FLAGS
+    LazyFlags f {this->f};
+#else
+    u8 f {this->f};
+#endif
+    u8 b {this->b};
+    u8 c {this->c};
+    u8 d {this->d};
+    u8 e {this->e};
+    u8 h {this->h};
+    u8 l {this->l};
+    u16 sp {this->sp};
+    u16 pc {this->pc};
+
+    const auto bc = [&] { return u16(b << 8 | c); };
+    const auto de = [&] { return u16(d << 8 | e); };
+    const auto hl = [&] { return u16(h << 8 | l); };
+    const auto set_bc = [&](u16 v) { b = v >> 8; c = v & 0xFF; };
+    const auto set_de = [&](u16 v) { d = v >> 8; e = v & 0xFF; };
+    const auto set_hl = [&](u16 v) { h = v >> 8; l = v & 0xFF; };
+
+    u64 count {0};
+
+    // Registers, time and count when an idle loop was last entered
+    const Block* idle_block {nullptr};
+    u64 idle_state {0};
+    u16 idle_sp {0};
+    bool idle_ime {false};
+    u64 idle_now {0};
+    u64 idle_count {0};
+    u64 idle_timed_reads {0};
+
+    // `deadline` is re-read every instruction since a write may schedule an earlier event
+    while (now < deadline && now < end && enabled) {
+        int cycles {0};
+
+        const u8 pending {static_cast<u8>(registers.ie & registers.if_ & 0x1F)};
+        if (ime && pending) {
+            const int bit {__builtin_ctz(pending)};
+            ime = false;
+            registers.if_ &= ~(1u << bit);
+            sp -= 2;
+            mmu.write16(sp, pc);
+            pc = 0x40 + bit * 8;
+            cycles += 4;
+            halted = false;
+        }
+        else if (halted) {
+            if (!pending) {
+                break;    // The caller fast-forwards to the next event
+            }
+            halted = false;
+        }
+
+        const Block& block {cache.lookup(mmu, pc)};
+
+        // An idle loop whose last pass left every register as it was repeats
+        // identically until the next event, so skip the passes that fit
+        if (block.idle && cycles == 0 && halt_bug_state == HaltBug::None && ei_bug_state == EIBug::None) {
+            const u64 state {u64(a) << 56 | u64(f) << 48 | u64(b) << 40 | u64(c) << 32 | u64(d) << 24 | u64(e) << 16 | u64(h) << 8 | l};
+            if (idle_block == &block && state == idle_state && sp == idle_sp && ime == idle_ime && cache.timed_reads == idle_timed_reads) {
+                const u64 period {now - idle_now};
+                const u64 passes {(std::min(deadline, end) - now) / period};
+                now += passes * period;
+                count += passes * (count - idle_count);
+                cache.idle_passes += passes;
+                if (now >= deadline || now >= end) {
+                    break;
+                }
+            }
+            idle_block = &block;
+            idle_state = state;
+            idle_sp = sp;
+            idle_ime = ime;
+            idle_now = now;
+            idle_count = count;
+            idle_timed_reads = cache.timed_reads;
+        }
+        else {
+            idle_block = nullptr;
+        }
+
+        const DecodedOp* inst {block.ops};
+        const DecodedOp* const block_end {inst + block.length};
+
+        for (;;) {
+            const u16 op {inst->op};
+            const u16 d16 {inst->d16};
+            const u8 d8 {static_cast<u8>(d16)};
+            pc = inst->pc + inst->size;
+            cycles += inst->cycles;
+
+            switch (inst->dispatch) {
+                case 0x00:    // NOP
+                    break;
+                case 0x01:    // LD BC, d16
+                    set_bc(d16);
+                    break;
+                case 0x02:    // LD (BC), A
+                    mmu.write8(bc(), a);
+                    break;
+                case 0x03:    // INC BC
+                    set_bc(bc() + 1);
+                    break;
+                case 0x04:    // INC B
+                    alu::inc(b, f);
+                    break;
+                case 0x05:    // DEC B
+                    alu::dec(b, f);
+                    break;
+                case 0x06:    // LD B, d8
+                    b = d8;
+                    break;
+                case 0x07:    // RLCA
+                {
+                    const u8 bit7 = a >> 7;
+                    f = bit7 << 4;
+                    a = (a << 1) | bit7;
+                    break;
+                }
+                case 0x08:    // LD (d16), SP
+                    mmu.write16(d16, sp);
+                    break;
+                case 0x09:    // ADD HL, BC
+                {
+                    u8 flags = 0;
+                    u16 result = 0;
+                    ADD16(hl(), bc(), &result, &flags);
+                    set_hl(result);
+                    f = (f & FLAGS_ZERO) | (flags & 0b0111'0000);
+                    break;
+                }
+                case 0x0A:    // LD A, (BC)
+                    a = mmu.read8(bc());
+                    break;
+                case 0x0B:    // DEC BC
+                    set_bc(bc() - 1);
+                    break;
+                case 0x0C:    // INC C
+                    alu::inc(c, f);
+                    break;
+                case 0x0D:    // DEC C
+                    alu::dec(c, f);
+                    break;
+                case 0x0E:    // LD C, d8
+                    c = d8;
+                    break;
+                case 0x0F:    // RRCA
+                {
+                    const u8 bit0 = a & 0x1;
+                    f = bit0 << 4;
+                    a = (a >> 1) | (bit0 << 7);
+                    break;
+                }
+                case 0x10:    // STOP
+                    break;
+                case 0x11:    // LD DE, d16
+                    set_de(d16);
+                    break;
+                case 0x12:    // LD (DE), A
+                    mmu.write8(de(), a);
+                    break;
+                case 0x13:    // INC DE
+                    set_de(de() + 1);
+                    break;
+                case 0x14:    // INC D
+                    alu::inc(d, f);
+                    break;
+                case 0x15:    // DEC D
+                    alu::dec(d, f);
+                    break;
+                case 0x16:    // LD D, d8
+                    d = d8;
+                    break;
+                case 0x17:    // RLA
+                {
+                    u8 flags = f;
+                    u8 result = 0;
+                    RL(a, &result, &flags);
+                    a = result;
+                    f = flags & 0b0111'0000;
+                    break;
+                }
+                case 0x18:    // JR d8
+                    pc += int8_t(d8);
+                    break;
+                case 0x19:    // ADD HL, DE
+                {
+                    u8 flags = 0;
+                    u16 result = 0;
+                    ADD16(hl(), de(), &result, &flags);
+                    set_hl(result);
+                    f = (f & FLAGS_ZERO) | (flags & 0b0111'0000);
+                    break;
+                }
+                case 0x1A:    // LD A, (DE)
+                    a = mmu.read8(de());
+                    break;
+                case 0x1B:    // DEC DE
+                    set_de(de() - 1);
+                    break;
+                case 0x1C:    // INC E
+                    alu::inc(e, f);
+                    break;
+                case 0x1D:    // DEC E
+                    alu::dec(e, f);
+                    break;
+                case 0x1E:    // LD E, d8
+                    e = d8;
+                    break;
+                case 0x1F:    // RRA
+                {
+                    u8 flags = f;
+                    u8 result = 0;
+                    RR(a, &result, &flags);
+                    f = flags & FLAGS_CARRY;
+                    a = result;
+                    break;
+                }
+                case 0x20:    // JR NZ, d8
+                    if (!(f & FLAGS_ZERO)) {
+                        pc += int8_t(d8);
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0x21:    // LD HL, d16
+                    set_hl(d16);
+                    break;
+                case 0x22:    // LD (HL+), A
+                    mmu.write8(hl(), a);
+                    set_hl(hl() + 1);
+                    break;
+                case 0x23:    // INC HL
+                    set_hl(hl() + 1);
+                    break;
+                case 0x24:    // INC H
+                    alu::inc(h, f);
+                    break;
+                case 0x25:    // DEC H
+                    alu::dec(h, f);
+                    break;
+                case 0x26:    // LD H, d8
+                    h = d8;
+                    break;
+                case 0x27:    // DAA
+                    if (!(f & FLAGS_SUBTRACT)) {
+                        if ((f & FLAGS_CARRY) || a > 0x99) {
+                            a += 0x60;
+                            f |= FLAGS_CARRY;
+                        }
+                        if ((f & FLAGS_HALFCARRY) || (a & 0xF) > 0x9)
+                            a += 0x6;
+                    }
+                    else {
+                        if (f & FLAGS_CARRY)
+                            a -= 0x60;
+                        if (f & FLAGS_HALFCARRY)
+                            a -= 0x6;
+                    }
+                    f &= 0b1101'0000;
+                    f = a ? f & 0b0111'0000 : f | 0b1000'0000;
+                    break;
+                case 0x28:    // JR Z, d8
+                    if (f & FLAGS_ZERO) {
+                        pc += int8_t(d8);
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0x29:    // ADD HL, HL
+                {
+                    u8 flags = 0;
+                    u16 result = 0;
+                    ADD16(hl(), hl(), &result, &flags);
+                    set_hl(result);
+                    f = (f & FLAGS_ZERO) | (flags & 0b0111'0000);
+                    break;
+                }
+                case 0x2A:    // LD A, (HL+)
+                    a = mmu.read8(hl());
+                    set_hl(hl() + 1);
+                    break;
+                case 0x2B:    // DEC HL
+                    set_hl(hl() - 1);
+                    break;
+                case 0x2C:    // INC L
+                    alu::inc(l, f);
+                    break;
+                case 0x2D:    // DEC L
+                    alu::dec(l, f);
+                    break;
+                case 0x2E:    // LD L, d8
+                    l = d8;
+                    break;
+                case 0x2F:    // CPL
+                    a = ~a;
+                    f = (f & (FLAGS_ZERO | FLAGS_CARRY)) | (FLAGS_SUBTRACT | FLAGS_HALFCARRY);
+                    break;
+                case 0x30:    // JR NC, d8
+                    if (!(f & FLAGS_CARRY)) {
+                        pc += int8_t(d8);
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0x31:    // LD SP, d16
+                    sp = d16;
+                    break;
+                case 0x32:    // LD (HL-), A
+                    mmu.write8(hl(), a);
+                    set_hl(hl() - 1);
+                    break;
+                case 0x33:    // INC SP
+                    sp = sp + 1;
+                    break;
+                case 0x34:    // INC (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    alu::inc(r, f);
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x35:    // DEC (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    alu::dec(r, f);
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x36:    // LD (HL), d8
+                    mmu.write8(hl(), d8);
+                    break;
+                case 0x37:    // SCF
+                    f = (f & 0b1000'0000) | FLAGS_CARRY;
+                    break;
+                case 0x38:    // JR C, d8
+                    if (f & FLAGS_CARRY) {
+                        pc += int8_t(d8);
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0x39:    // ADD HL, SP
+                {
+                    u8 flags = 0;
+                    u16 result = 0;
+                    ADD16(hl(), sp, &result, &flags);
+                    set_hl(result);
+                    f = (f & FLAGS_ZERO) | (flags & 0b0011'0000);
+                    break;
+                }
+                case 0x3A:    // LD A, (HL-)
+                    a = mmu.read8(hl());
+                    set_hl(hl() - 1);
+                    break;
+                case 0x3B:    // DEC SP
+                    sp = sp - 1;
+                    break;
+                case 0x3C:    // INC A
+                    alu::inc(a, f);
+                    break;
+                case 0x3D:    // DEC A
+                    alu::dec(a, f);
+                    break;
+                case 0x3E:    // LD A, d8
+                    a = d8;
+                    break;
+                case 0x3F:    // CCF
+                    f = (f & FLAGS_ZERO) | (~f & FLAGS_CARRY);
+                    break;
+                case 0x40:    // LD B, B
+                    break;
+                case 0x41:    // LD B, C
+                    b = c;
+                    break;
+                case 0x42:    // LD B, D
+                    b = d;
+                    break;
+                case 0x43:    // LD B, E
+                    b = e;
+                    break;
+                case 0x44:    // LD B, H
+                    b = h;
+                    break;
+                case 0x45:    // LD B, L
+                    b = l;
+                    break;
+                case 0x46:    // LD B, (HL)
+                    b = mmu.read8(hl());
+                    break;
+                case 0x47:    // LD B, A
+                    b = a;
+                    break;
+                case 0x48:    // LD C, B
+                    c = b;
+                    break;
+                case 0x49:    // LD C, C
+                    break;
+                case 0x4A:    // LD C, D
+                    c = d;
+                    break;
+                case 0x4B:    // LD C, E
+                    c = e;
+                    break;
+                case 0x4C:    // LD C, H
+                    c = h;
+                    break;
+                case 0x4D:    // LD C, L
+                    c = l;
+                    break;
+                case 0x4E:    // LD C, (HL)
+                    c = mmu.read8(hl());
+                    break;
+                case 0x4F:    // LD C, A
+                    c = a;
+                    break;
+                case 0x50:    // LD D, B
+                    d = b;
+                    break;
+                case 0x51:    // LD D, C
+                    d = c;
+                    break;
+                case 0x52:    // LD D, D
+                    break;
+                case 0x53:    // LD D, E
+                    d = e;
+                    break;
+                case 0x54:    // LD D, H
+                    d = h;
+                    break;
+                case 0x55:    // LD D, L
+                    d = l;
+                    break;
+                case 0x56:    // LD D, (HL)
+                    d = mmu.read8(hl());
+                    break;
+                case 0x57:    // LD D, A
+                    d = a;
+                    break;
+                case 0x58:    // LD E, B
+                    e = b;
+                    break;
+                case 0x59:    // LD E, C
+                    e = c;
+                    break;
+                case 0x5A:    // LD E, D
+                    e = d;
+                    break;
+                case 0x5B:    // LD E, E
+                    break;
+                case 0x5C:    // LD E, H
+                    e = h;
+                    break;
+                case 0x5D:    // LD E, L
+                    e = l;
+                    break;
+                case 0x5E:    // LD E, (HL)
+                    e = mmu.read8(hl());
+                    break;
+                case 0x5F:    // LD E, A
+                    e = a;
+                    break;
+                case 0x60:    // LD H, B
+                    h = b;
+                    break;
+                case 0x61:    // LD H, C
+                    h = c;
+                    break;
+                case 0x62:    // LD H, D
+                    h = d;
+                    break;
+                case 0x63:    // LD H, E
+                    h = e;
+                    break;
+                case 0x64:    // LD H, H
+                    break;
+                case 0x65:    // LD H, L
+                    h = l;
+                    break;
+                case 0x66:    // LD H, (HL)
+                    h = mmu.read8(hl());
+                    break;
+                case 0x67:    // LD H, A
+                    h = a;
+                    break;
+                case 0x68:    // LD L, B
+                    l = b;
+                    break;
+                case 0x69:    // LD L, C
+                    l = c;
+                    break;
+                case 0x6A:    // LD L, D
+                    l = d;
+                    break;
+                case 0x6B:    // LD L, E
+                    l = e;
+                    break;
+                case 0x6C:    // LD L, H
+                    l = h;
+                    break;
+                case 0x6D:    // LD L, L
+                    break;
+                case 0x6E:    // LD L, (HL)
+                    l = mmu.read8(hl());
+                    break;
+                case 0x6F:    // LD L, A
+                    l = a;
+                    break;
+                case 0x70:    // LD (HL), B
+                    mmu.write8(hl(), b);
+                    break;
+                case 0x71:    // LD (HL), C
+                    mmu.write8(hl(), c);
+                    break;
+                case 0x72:    // LD (HL), D
+                    mmu.write8(hl(), d);
+                    break;
+                case 0x73:    // LD (HL), E
+                    mmu.write8(hl(), e);
+                    break;
+                case 0x74:    // LD (HL), H
+                    mmu.write8(hl(), h);
+                    break;
+                case 0x75:    // LD (HL), L
+                    mmu.write8(hl(), l);
+                    break;
+                case 0x76:    // HALT
+                    halt();
+                    break;
+                case 0x77:    // LD (HL), A
+                    mmu.write8(hl(), a);
+                    break;
+                case 0x78:    // LD A, B
+                    a = b;
+                    break;
+                case 0x79:    // LD A, C
+                    a = c;
+                    break;
+                case 0x7A:    // LD A, D
+                    a = d;
+                    break;
+                case 0x7B:    // LD A, E
+                    a = e;
+                    break;
+                case 0x7C:    // LD A, H
+                    a = h;
+                    break;
+                case 0x7D:    // LD A, L
+                    a = l;
+                    break;
+                case 0x7E:    // LD A, (HL)
+                    a = mmu.read8(hl());
+                    break;
+                case 0x7F:    // LD A, A
+                    break;
+                case 0x80:    // ADD A, B
+                    a = alu::add(a, b, f);
+                    break;
+                case 0x81:    // ADD A, C
+                    a = alu::add(a, c, f);
+                    break;
+                case 0x82:    // ADD A, D
+                    a = alu::add(a, d, f);
+                    break;
+                case 0x83:    // ADD A, E
+                    a = alu::add(a, e, f);
+                    break;
+                case 0x84:    // ADD A, H
+                    a = alu::add(a, h, f);
+                    break;
+                case 0x85:    // ADD A, L
+                    a = alu::add(a, l, f);
+                    break;
+                case 0x86:    // ADD A, (HL)
+                    a = alu::add(a, mmu.read8(hl()), f);
+                    break;
+                case 0x87:    // ADD A, A
+                    a = alu::add(a, a, f);
+                    break;
+                case 0x88:    // ADC A, B
+                    alu::adc(a, b, f);
+                    break;
+                case 0x89:    // ADC A, C
+                    alu::adc(a, c, f);
+                    break;
+                case 0x8A:    // ADC A, D
+                    alu::adc(a, d, f);
+                    break;
+                case 0x8B:    // ADC A, E
+                    alu::adc(a, e, f);
+                    break;
+                case 0x8C:    // ADC A, H
+                    alu::adc(a, h, f);
+                    break;
+                case 0x8D:    // ADC A, L
+                    alu::adc(a, l, f);
+                    break;
+                case 0x8E:    // ADC A, (HL)
+                    alu::adc(a, mmu.read8(hl()), f);
+                    break;
+                case 0x8F:    // ADC A, A
+                    alu::adc(a, a, f);
+                    break;
+                case 0x90:    // SUB A, B
+                    a = alu::sub(a, b, f);
+                    break;
+                case 0x91:    // SUB A, C
+                    a = alu::sub(a, c, f);
+                    break;
+                case 0x92:    // SUB A, D
+                    a = alu::sub(a, d, f);
+                    break;
+                case 0x93:    // SUB A, E
+                    a = alu::sub(a, e, f);
+                    break;
+                case 0x94:    // SUB A, H
+                    a = alu::sub(a, h, f);
+                    break;
+                case 0x95:    // SUB A, L
+                    a = alu::sub(a, l, f);
+                    break;
+                case 0x96:    // SUB A, (HL)
+                    a = alu::sub(a, mmu.read8(hl()), f);
+                    break;
+                case 0x97:    // SUB A, A
+                    a = alu::sub(a, a, f);
+                    break;
+                case 0x98:    // SBC A, B
+                    alu::sbc(a, b, f);
+                    break;
+                case 0x99:    // SBC A, C
+                    alu::sbc(a, c, f);
+                    break;
+                case 0x9A:    // SBC A, D
+                    alu::sbc(a, d, f);
+                    break;
+                case 0x9B:    // SBC A, E
+                    alu::sbc(a, e, f);
+                    break;
+                case 0x9C:    // SBC A, H
+                    alu::sbc(a, h, f);
+                    break;
+                case 0x9D:    // SBC A, L
+                    alu::sbc(a, l, f);
+                    break;
+                case 0x9E:    // SBC A, (HL)
+                    alu::sbc(a, mmu.read8(hl()), f);
+                    break;
+                case 0x9F:    // SBC A, A
+                    alu::sbc(a, a, f);
+                    break;
+                case 0xA0:    // AND A, B
+                    AND(a, b, f);
+                    break;
+                case 0xA1:    // AND A, C
+                    AND(a, c, f);
+                    break;
+                case 0xA2:    // AND A, D
+                    AND(a, d, f);
+                    break;
+                case 0xA3:    // AND A, E
+                    AND(a, e, f);
+                    break;
+                case 0xA4:    // AND A, H
+                    AND(a, h, f);
+                    break;
+                case 0xA5:    // AND A, L
+                    AND(a, l, f);
+                    break;
+                case 0xA6:    // AND A, (HL)
+                    AND(a, mmu.read8(hl()), f);
+                    break;
+                case 0xA7:    // AND A, A
+                    AND(a, a, f);
+                    break;
+                case 0xA8:    // XOR A, B
+                    XOR(a, b, f);
+                    break;
+                case 0xA9:    // XOR A, C
+                    XOR(a, c, f);
+                    break;
+                case 0xAA:    // XOR A, D
+                    XOR(a, d, f);
+                    break;
+                case 0xAB:    // XOR A, E
+                    XOR(a, e, f);
+                    break;
+                case 0xAC:    // XOR A, H
+                    XOR(a, h, f);
+                    break;
+                case 0xAD:    // XOR A, L
+                    XOR(a, l, f);
+                    break;
+                case 0xAE:    // XOR A, (HL)
+                    XOR(a, mmu.read8(hl()), f);
+                    break;
+                case 0xAF:    // XOR A, A
+                    XOR(a, a, f);
+                    break;
+                case 0xB0:    // OR A, B
+                    OR(a, b, f);
+                    break;
+                case 0xB1:    // OR A, C
+                    OR(a, c, f);
+                    break;
+                case 0xB2:    // OR A, D
+                    OR(a, d, f);
+                    break;
+                case 0xB3:    // OR A, E
+                    OR(a, e, f);
+                    break;
+                case 0xB4:    // OR A, H
+                    OR(a, h, f);
+                    break;
+                case 0xB5:    // OR A, L
+                    OR(a, l, f);
+                    break;
+                case 0xB6:    // OR A, (HL)
+                    OR(a, mmu.read8(hl()), f);
+                    break;
+                case 0xB7:    // OR A, A
+                    OR(a, a, f);
+                    break;
+                case 0xB8:    // CP A, B
+                    alu::cp(a, b, f);
+                    break;
+                case 0xB9:    // CP A, C
+                    alu::cp(a, c, f);
+                    break;
+                case 0xBA:    // CP A, D
+                    alu::cp(a, d, f);
+                    break;
+                case 0xBB:    // CP A, E
+                    alu::cp(a, e, f);
+                    break;
+                case 0xBC:    // CP A, H
+                    alu::cp(a, h, f);
+                    break;
+                case 0xBD:    // CP A, L
+                    alu::cp(a, l, f);
+                    break;
+                case 0xBE:    // CP A, (HL)
+                    alu::cp(a, mmu.read8(hl()), f);
+                    break;
+                case 0xBF:    // CP A, A
+                    alu::cp(a, a, f);
+                    break;
+                case 0xC0:    // RET NZ
+                    if (!(f & FLAGS_ZERO)) {
+                        pc = mmu.read16(sp);
+                        sp += 2;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xC1:    // POP BC
+                    set_bc(mmu.read16(sp));
+                    sp += 2;
+                    break;
+                case 0xC2:    // JP NZ, d16
+                    if (!(f & FLAGS_ZERO)) {
+                        pc = d16;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xC3:    // JP d16
+                    pc = d16;
+                    break;
+                case 0xC4:    // CALL NZ, d16
+                    if (!(f & FLAGS_ZERO)) {
+                        sp -= 2;
+                        mmu.write16(sp, pc);
+                        pc = d16;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xC5:    // PUSH BC
+                    sp -= 2;
+                    mmu.write16(sp, bc());
+                    break;
+                case 0xC6:    // ADD A, d8
+                    a = alu::add(a, d8, f);
+                    break;
+                case 0xC7:    // RST 00
+                    sp -= 2;
+                    mmu.write16(sp, pc);
+                    pc = 0x00;
+                    break;
+                case 0xC8:    // RET Z
+                    if (f & FLAGS_ZERO) {
+                        pc = mmu.read16(sp);
+                        sp += 2;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xC9:    // RET
+                    pc = mmu.read16(sp);
+                    sp += 2;
+                    break;
+                case 0xCA:    // JP Z, d16
+                    if (f & FLAGS_ZERO) {
+                        pc = d16;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xCC:    // CALL Z, d16
+                    if (f & FLAGS_ZERO) {
+                        sp -= 2;
+                        mmu.write16(sp, pc);
+                        pc = d16;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xCD:    // CALL d16
+                    sp -= 2;
+                    mmu.write16(sp, pc);
+                    pc = d16;
+                    break;
+                case 0xCE:    // ADC A, d8
+                    alu::adc(a, d8, f);
+                    break;
+                case 0xCF:    // RST 08
+                    sp -= 2;
+                    mmu.write16(sp, pc);
+                    pc = 0x08;
+                    break;
+                case 0xD0:    // RET NC
+                    if (!(f & FLAGS_CARRY)) {
+                        pc = mmu.read16(sp);
+                        sp += 2;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xD1:    // POP DE
+                    set_de(mmu.read16(sp));
+                    sp += 2;
+                    break;
+                case 0xD2:    // JP NC, d16
+                    if (!(f & FLAGS_CARRY)) {
+                        pc = d16;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xD3:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xD4:    // CALL NC, d16
+                    if (!(f & FLAGS_CARRY)) {
+                        sp -= 2;
+                        mmu.write16(sp, pc);
+                        pc = d16;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xD5:    // PUSH DE
+                    sp -= 2;
+                    mmu.write16(sp, de());
+                    break;
+                case 0xD6:    // SUB A, d8
+                    a = alu::sub(a, d8, f);
+                    break;
+                case 0xD7:    // RST 10
+                    sp -= 2;
+                    mmu.write16(sp, pc);
+                    pc = 0x10;
+                    break;
+                case 0xD8:    // RET C
+                    if (f & FLAGS_CARRY) {
+                        pc = mmu.read16(sp);
+                        sp += 2;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xD9:    // RETI
+                    enable_interrupts();
+                    pc = mmu.read16(sp);
+                    sp += 2;
+                    break;
+                case 0xDA:    // JP C, d16
+                    if (f & FLAGS_CARRY) {
+                        pc = d16;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xDB:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xDC:    // CALL C, d16
+                    if (f & FLAGS_CARRY) {
+                        sp -= 2;
+                        mmu.write16(sp, pc);
+                        pc = d16;
+                        cycles += kInstCyclesAlt[op] - kInstCycles[op];
+                    }
+                    break;
+                case 0xDD:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xDE:    // SBC A, d8
+                    alu::sbc(a, d8, f);
+                    break;
+                case 0xDF:    // RST 18
+                    sp -= 2;
+                    mmu.write16(sp, pc);
+                    pc = 0x18;
+                    break;
+                case 0xE0:    // LDH (d8), A
+                    mmu.write8(0xFF00 + d8, a);
+                    break;
+                case 0xE1:    // POP HL
+                    set_hl(mmu.read16(sp));
+                    sp += 2;
+                    break;
+                case 0xE2:    // LD (C), A
+                    mmu.write8(0xFF00 + c, a);
+                    break;
+                case 0xE3:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xE4:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xE5:    // PUSH HL
+                    sp -= 2;
+                    mmu.write16(sp, hl());
+                    break;
+                case 0xE6:    // AND A, d8
+                    AND(a, d8, f);
+                    break;
+                case 0xE7:    // RST 20
+                    sp -= 2;
+                    mmu.write16(sp, pc);
+                    pc = 0x20;
+                    break;
+                case 0xE8:    // ADD SP, d8
+                {
+                    u8 flags = 0;
+                    if (((sp & 0xF) + (d8 & 0xF)) & 0x10)
+                        flags |= FLAGS_HALFCARRY;
+                    if (((sp & 0xFF) + d8) > 0xFF)
+                        flags |= FLAGS_CARRY;
+                    sp = sp + int8_t(d8);
+                    f = flags;
+                    break;
+                }
+                case 0xE9:    // JP HL
+                    pc = hl();
+                    break;
+                case 0xEA:    // LD (d16), A
+                    mmu.write8(d16, a);
+                    break;
+                case 0xEB:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xEC:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xED:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xEE:    // XOR A, d8
+                    XOR(a, d8, f);
+                    break;
+                case 0xEF:    // RST 28
+                    sp -= 2;
+                    mmu.write16(sp, pc);
+                    pc = 0x28;
+                    break;
+                case 0xF0:    // LDH A, (d8)
+                    a = mmu.read8(0xFF00 + d8);
+                    break;
+                case 0xF1:    // POP AF
+                {
+                    const u16 af {u16(mmu.read16(sp) & 0xFFF0)};
+                    a = af >> 8;
+                    f = af & 0xFF;
+                    sp += 2;
+                    break;
+                }
+                case 0xF2:    // LD A, (C)
+                    a = mmu.read8(0xFF00 + c);
+                    break;
+                case 0xF3:    // DI
+                    disable_interrupts();
+                    break;
+                case 0xF4:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xF5:    // PUSH AF
+                    sp -= 2;
+                    mmu.write16(sp, u16(a << 8 | f));
+                    break;
+                case 0xF6:    // OR A, d8
+                    OR(a, d8, f);
+                    break;
+                case 0xF7:    // RST 30
+                    sp -= 2;
+                    mmu.write16(sp, pc);
+                    pc = 0x30;
+                    break;
+                case 0xF8:    // LD HL, SP+d8
+                {
+                    u8 flags = 0;
+                    const int8_t s8 = d8;
+                    const u16 result = sp + s8;
+                    if (s8 > 0) {
+                        if (((sp & 0xFF) + s8) > 0xFF)
+                            flags |= FLAGS_CARRY;
+                        if (((sp & 0xF) + (s8 & 0xF)) > 0xF)
+                            flags |= FLAGS_HALFCARRY;
+                    }
+                    else {
+                        if ((result & 0xFF) < (sp & 0xFF))
+                            flags |= FLAGS_CARRY;
+                        if ((result & 0xF) < (sp & 0xF))
+                            flags |= FLAGS_HALFCARRY;
+                    }
+                    f = flags;
+                    set_hl(result);
+                    break;
+                }
+                case 0xF9:    // LD SP, HL
+                    sp = hl();
+                    break;
+                case 0xFA:    // LD A, (d16)
+                    a = mmu.read8(d16);
+                    break;
+                case 0xFB:    // EI
+                    enable_interrupts();
+                    break;
+                case 0xFC:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xFD:    // INVALID
+                    set_enabled(false);
+                    break;
+                case 0xFE:    // CP A, d8
+                    alu::cp(a, d8, f);
+                    break;
+                case 0xFF:    // RST 38
+                    sp -= 2;
+                    mmu.write16(sp, pc);
+                    pc = 0x38;
+                    break;
+                case 0x100:    // RLC B
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RLC(b, &result, &flags);
+                    b = result;
+                    f = flags;
+                    break;
+                }
+                case 0x101:    // RLC C
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RLC(c, &result, &flags);
+                    c = result;
+                    f = flags;
+                    break;
+                }
+                case 0x102:    // RLC D
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RLC(d, &result, &flags);
+                    d = result;
+                    f = flags;
+                    break;
+                }
+                case 0x103:    // RLC E
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RLC(e, &result, &flags);
+                    e = result;
+                    f = flags;
+                    break;
+                }
+                case 0x104:    // RLC H
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RLC(h, &result, &flags);
+                    h = result;
+                    f = flags;
+                    break;
+                }
+                case 0x105:    // RLC L
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RLC(l, &result, &flags);
+                    l = result;
+                    f = flags;
+                    break;
+                }
+                case 0x106:    // RLC (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RLC(r, &result, &flags);
+                    r = result;
+                    f = flags;
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x107:    // RLC A
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RLC(a, &result, &flags, true);
+                    a = result;
+                    f = flags;
+                    break;
+                }
+                case 0x108:    // RRC B
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RRC(b, &result, &flags);
+                    b = result;
+                    f = flags;
+                    break;
+                }
+                case 0x109:    // RRC C
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RRC(c, &result, &flags);
+                    c = result;
+                    f = flags;
+                    break;
+                }
+                case 0x10A:    // RRC D
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RRC(d, &result, &flags);
+                    d = result;
+                    f = flags;
+                    break;
+                }
+                case 0x10B:    // RRC E
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RRC(e, &result, &flags);
+                    e = result;
+                    f = flags;
+                    break;
+                }
+                case 0x10C:    // RRC H
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RRC(h, &result, &flags);
+                    h = result;
+                    f = flags;
+                    break;
+                }
+                case 0x10D:    // RRC L
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RRC(l, &result, &flags);
+                    l = result;
+                    f = flags;
+                    break;
+                }
+                case 0x10E:    // RRC (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RRC(r, &result, &flags);
+                    r = result;
+                    f = flags;
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x10F:    // RRC A
+                {
+                    u8 flags = 0;
+                    u8 result = 0;
+                    RRC(a, &result, &flags);
+                    a = result;
+                    f = flags;
+                    break;
+                }
+                case 0x110:    // RL B
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RL(b, &result, &flags);
+                    b = result;
+                    f = flags;
+                    break;
+                }
+                case 0x111:    // RL C
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RL(c, &result, &flags);
+                    c = result;
+                    f = flags;
+                    break;
+                }
+                case 0x112:    // RL D
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RL(d, &result, &flags);
+                    d = result;
+                    f = flags;
+                    break;
+                }
+                case 0x113:    // RL E
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RL(e, &result, &flags);
+                    e = result;
+                    f = flags;
+                    break;
+                }
+                case 0x114:    // RL H
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RL(h, &result, &flags);
+                    h = result;
+                    f = flags;
+                    break;
+                }
+                case 0x115:    // RL L
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RL(l, &result, &flags);
+                    l = result;
+                    f = flags;
+                    break;
+                }
+                case 0x116:    // RL (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RL(r, &result, &flags);
+                    r = result;
+                    f = flags;
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x117:    // RL A
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RL(a, &result, &flags);
+                    a = result;
+                    f = flags;
+                    break;
+                }
+                case 0x118:    // RR B
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RR(b, &result, &flags);
+                    b = result;
+                    f = flags;
+                    break;
+                }
+                case 0x119:    // RR C
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RR(c, &result, &flags);
+                    c = result;
+                    f = flags;
+                    break;
+                }
+                case 0x11A:    // RR D
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RR(d, &result, &flags);
+                    d = result;
+                    f = flags;
+                    break;
+                }
+                case 0x11B:    // RR E
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RR(e, &result, &flags);
+                    e = result;
+                    f = flags;
+                    break;
+                }
+                case 0x11C:    // RR H
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RR(h, &result, &flags);
+                    h = result;
+                    f = flags;
+                    break;
+                }
+                case 0x11D:    // RR L
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RR(l, &result, &flags);
+                    l = result;
+                    f = flags;
+                    break;
+                }
+                case 0x11E:    // RR (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RR(r, &result, &flags);
+                    r = result;
+                    f = flags;
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x11F:    // RR A
+                {
+                    u8 flags = f & FLAGS_CARRY;
+                    u8 result = 0;
+                    RR(a, &result, &flags);
+                    a = result;
+                    f = flags;
+                    break;
+                }
+                case 0x120:    // SLA B
+                    SLA(b, f);
+                    break;
+                case 0x121:    // SLA C
+                    SLA(c, f);
+                    break;
+                case 0x122:    // SLA D
+                    SLA(d, f);
+                    break;
+                case 0x123:    // SLA E
+                    SLA(e, f);
+                    break;
+                case 0x124:    // SLA H
+                    SLA(h, f);
+                    break;
+                case 0x125:    // SLA L
+                    SLA(l, f);
+                    break;
+                case 0x126:    // SLA (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    SLA(r, f);
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x127:    // SLA A
+                    SLA(a, f);
+                    break;
+                case 0x128:    // SRA B
+                    SRA(b, f);
+                    break;
+                case 0x129:    // SRA C
+                    SRA(c, f);
+                    break;
+                case 0x12A:    // SRA D
+                    SRA(d, f);
+                    break;
+                case 0x12B:    // SRA E
+                    SRA(e, f);
+                    break;
+                case 0x12C:    // SRA H
+                    SRA(h, f);
+                    break;
+                case 0x12D:    // SRA L
+                    SRA(l, f);
+                    break;
+                case 0x12E:    // SRA (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    SRA(r, f);
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x12F:    // SRA A
+                    SRA(a, f);
+                    break;
+                case 0x130:    // SWAP B
+                    SWAP(b, f);
+                    break;
+                case 0x131:    // SWAP C
+                    SWAP(c, f);
+                    break;
+                case 0x132:    // SWAP D
+                    SWAP(d, f);
+                    break;
+                case 0x133:    // SWAP E
+                    SWAP(e, f);
+                    break;
+                case 0x134:    // SWAP H
+                    SWAP(h, f);
+                    break;
+                case 0x135:    // SWAP L
+                    SWAP(l, f);
+                    break;
+                case 0x136:    // SWAP (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    SWAP(r, f);
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x137:    // SWAP A
+                    SWAP(a, f);
+                    break;
+                case 0x138:    // SRL B
+                    SRL(b, f);
+                    break;
+                case 0x139:    // SRL C
+                    SRL(c, f);
+                    break;
+                case 0x13A:    // SRL D
+                    SRL(d, f);
+                    break;
+                case 0x13B:    // SRL E
+                    SRL(e, f);
+                    break;
+                case 0x13C:    // SRL H
+                    SRL(h, f);
+                    break;
+                case 0x13D:    // SRL L
+                    SRL(l, f);
+                    break;
+                case 0x13E:    // SRL (HL)
+                {
+                    u8 r {mmu.read8(hl())};
+                    SRL(r, f);
+                    mmu.write8(hl(), r);
+                    break;
+                }
+                case 0x13F:    // SRL A
+                    SRL(a, f);
+                    break;
+                case 0x140:    // BIT 0, B
+                    TestBit(b & 0b0000'0001, f);
+                    break;
+                case 0x141:    // BIT 0, C
+                    TestBit(c & 0b0000'0001, f);
+                    break;
+                case 0x142:    // BIT 0, D
+                    TestBit(d & 0b0000'0001, f);
+                    break;
+                case 0x143:    // BIT 0, E
+                    TestBit(e & 0b0000'0001, f);
+                    break;
+                case 0x144:    // BIT 0, H
+                    TestBit(h & 0b0000'0001, f);
+                    break;
+                case 0x145:    // BIT 0, L
+                    TestBit(l & 0b0000'0001, f);
+                    break;
+                case 0x146:    // BIT 0, (HL)
+                    TestBit(mmu.read8(hl()) & 0b0000'0001, f);
+                    break;
+                case 0x147:    // BIT 0, A
+                    TestBit(a & 0b0000'0001, f);
+                    break;
+                case 0x148:    // BIT 1, B
+                    TestBit(b & 0b0000'0010, f);
+                    break;
+                case 0x149:    // BIT 1, C
+                    TestBit(c & 0b0000'0010, f);
+                    break;
+                case 0x14A:    // BIT 1, D
+                    TestBit(d & 0b0000'0010, f);
+                    break;
+                case 0x14B:    // BIT 1, E
+                    TestBit(e & 0b0000'0010, f);
+                    break;
+                case 0x14C:    // BIT 1, H
+                    TestBit(h & 0b0000'0010, f);
+                    break;
+                case 0x14D:    // BIT 1, L
+                    TestBit(l & 0b0000'0010, f);
+                    break;
+                case 0x14E:    // BIT 1, (HL)
+                    TestBit(mmu.read8(hl()) & 0b0000'0010, f);
+                    break;
+                case 0x14F:    // BIT 1, A
+                    TestBit(a & 0b0000'0010, f);
+                    break;
+                case 0x150:    // BIT 2, B
+                    TestBit(b & 0b0000'0100, f);
+                    break;
+                case 0x151:    // BIT 2, C
+                    TestBit(c & 0b0000'0100, f);
+                    break;
+                case 0x152:    // BIT 2, D
+                    TestBit(d & 0b0000'0100, f);
+                    break;
+                case 0x153:    // BIT 2, E
+                    TestBit(e & 0b0000'0100, f);
+                    break;
+                case 0x154:    // BIT 2, H
+                    TestBit(h & 0b0000'0100, f);
+                    break;
+                case 0x155:    // BIT 2, L
+                    TestBit(l & 0b0000'0100, f);
+                    break;
+                case 0x156:    // BIT 2, (HL)
+                    TestBit(mmu.read8(hl()) & 0b0000'0100, f);
+                    break;
+                case 0x157:    // BIT 2, A
+                    TestBit(a & 0b0000'0100, f);
+                    break;
+                case 0x158:    // BIT 3, B
+                    TestBit(b & 0b0000'1000, f);
+                    break;
+                case 0x159:    // BIT 3, C
+                    TestBit(c & 0b0000'1000, f);
+                    break;
+                case 0x15A:    // BIT 3, D
+                    TestBit(d & 0b0000'1000, f);
+                    break;
+                case 0x15B:    // BIT 3, E
+                    TestBit(e & 0b0000'1000, f);
+                    break;
+                case 0x15C:    // BIT 3, H
+                    TestBit(h & 0b0000'1000, f);
+                    break;
+                case 0x15D:    // BIT 3, L
+                    TestBit(l & 0b0000'1000, f);
+                    break;
+                case 0x15E:    // BIT 3, (HL)
+                    TestBit(mmu.read8(hl()) & 0b0000'1000, f);
+                    break;
+                case 0x15F:    // BIT 3, A
+                    TestBit(a & 0b0000'1000, f);
+                    break;
+                case 0x160:    // BIT 4, B
+                    TestBit(b & 0b0001'0000, f);
+                    break;
+                case 0x161:    // BIT 4, C
+                    TestBit(c & 0b0001'0000, f);
+                    break;
+                case 0x162:    // BIT 4, D
+                    TestBit(d & 0b0001'0000, f);
+                    break;
+                case 0x163:    // BIT 4, E
+                    TestBit(e & 0b0001'0000, f);
+                    break;
+                case 0x164:    // BIT 4, H
+                    TestBit(h & 0b0001'0000, f);
+                    break;
+                case 0x165:    // BIT 4, L
+                    TestBit(l & 0b0001'0000, f);
+                    break;
+                case 0x166:    // BIT 4, (HL)
+                    TestBit(mmu.read8(hl()) & 0b0001'0000, f);
+                    break;
+                case 0x167:    // BIT 4, A
+                    TestBit(a & 0b0001'0000, f);
+                    break;
+                case 0x168:    // BIT 5, B
+                    TestBit(b & 0b0010'0000, f);
+                    break;
+                case 0x169:    // BIT 5, C
+                    TestBit(c & 0b0010'0000, f);
+                    break;
+                case 0x16A:    // BIT 5, D
+                    TestBit(d & 0b0010'0000, f);
+                    break;
+                case 0x16B:    // BIT 5, E
+                    TestBit(e & 0b0010'0000, f);
+                    break;
+                case 0x16C:    // BIT 5, H
+                    TestBit(h & 0b0010'0000, f);
+                    break;
+                case 0x16D:    // BIT 5, L
+                    TestBit(l & 0b0010'0000, f);
+                    break;
+                case 0x16E:    // BIT 5, (HL)
+                    TestBit(mmu.read8(hl()) & 0b0010'0000, f);
+                    break;
+                case 0x16F:    // BIT 5, A
+                    TestBit(a & 0b0010'0000, f);
+                    break;
+                case 0x170:    // BIT 6, B
+                    TestBit(b & 0b0100'0000, f);
+                    break;
+                case 0x171:    // BIT 6, C
+                    TestBit(c & 0b0100'0000, f);
+                    break;
+                case 0x172:    // BIT 6, D
+                    TestBit(d & 0b0100'0000, f);
+                    break;
+                case 0x173:    // BIT 6, E
+                    TestBit(e & 0b0100'0000, f);
+                    break;
+                case 0x174:    // BIT 6, H
+                    TestBit(h & 0b0100'0000, f);
+                    break;
+                case 0x175:    // BIT 6, L
+                    TestBit(l & 0b0100'0000, f);
+                    break;
+                case 0x176:    // BIT 6, (HL)
+                    TestBit(mmu.read8(hl()) & 0b0100'0000, f);
+                    break;
+                case 0x177:    // BIT 6, A
+                    TestBit(a & 0b0100'0000, f);
+                    break;
+                case 0x178:    // BIT 7, B
+                    TestBit(b & 0b1000'0000, f);
+                    break;
+                case 0x179:    // BIT 7, C
+                    TestBit(c & 0b1000'0000, f);
+                    break;
+                case 0x17A:    // BIT 7, D
+                    TestBit(d & 0b1000'0000, f);
+                    break;
+                case 0x17B:    // BIT 7, E
+                    TestBit(e & 0b1000'0000, f);
+                    break;
+                case 0x17C:    // BIT 7, H
+                    TestBit(h & 0b1000'0000, f);
+                    break;
+                case 0x17D:    // BIT 7, L
+                    TestBit(l & 0b1000'0000, f);
+                    break;
+                case 0x17E:    // BIT 7, (HL)
+                    TestBit(mmu.read8(hl()) & 0b1000'0000, f);
+                    break;
+                case 0x17F:    // BIT 7, A
+                    TestBit(a & 0b1000'0000, f);
+                    break;
+                case 0x180:    // RES 0, B
+                    b &= ~0b0000'0001;
+                    break;
+                case 0x181:    // RES 0, C
+                    c &= ~0b0000'0001;
+                    break;
+                case 0x182:    // RES 0, D
+                    d &= ~0b0000'0001;
+                    break;
+                case 0x183:    // RES 0, E
+                    e &= ~0b0000'0001;
+                    break;
+                case 0x184:    // RES 0, H
+                    h &= ~0b0000'0001;
+                    break;
+                case 0x185:    // RES 0, L
+                    l &= ~0b0000'0001;
+                    break;
+                case 0x186:    // RES 0, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) & ~0b0000'0001);
+                    break;
+                case 0x187:    // RES 0, A
+                    a &= ~0b0000'0001;
+                    break;
+                case 0x188:    // RES 1, B
+                    b &= ~0b0000'0010;
+                    break;
+                case 0x189:    // RES 1, C
+                    c &= ~0b0000'0010;
+                    break;
+                case 0x18A:    // RES 1, D
+                    d &= ~0b0000'0010;
+                    break;
+                case 0x18B:    // RES 1, E
+                    e &= ~0b0000'0010;
+                    break;
+                case 0x18C:    // RES 1, H
+                    h &= ~0b0000'0010;
+                    break;
+                case 0x18D:    // RES 1, L
+                    l &= ~0b0000'0010;
+                    break;
+                case 0x18E:    // RES 1, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) & ~0b0000'0010);
+                    break;
+                case 0x18F:    // RES 1, A
+                    a &= ~0b0000'0010;
+                    break;
+                case 0x190:    // RES 2, B
+                    b &= ~0b0000'0100;
+                    break;
+                case 0x191:    // RES 2, C
+                    c &= ~0b0000'0100;
+                    break;
+                case 0x192:    // RES 2, D
+                    d &= ~0b0000'0100;
+                    break;
+                case 0x193:    // RES 2, E
+                    e &= ~0b0000'0100;
+                    break;
+                case 0x194:    // RES 2, H
+                    h &= ~0b0000'0100;
+                    break;
+                case 0x195:    // RES 2, L
+                    l &= ~0b0000'0100;
+                    break;
+                case 0x196:    // RES 2, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) & ~0b0000'0100);
+                    break;
+                case 0x197:    // RES 2, A
+                    a &= ~0b0000'0100;
+                    break;
+                case 0x198:    // RES 3, B
+                    b &= ~0b0000'1000;
+                    break;
+                case 0x199:    // RES 3, C
+                    c &= ~0b0000'1000;
+                    break;
+                case 0x19A:    // RES 3, D
+                    d &= ~0b0000'1000;
+                    break;
+                case 0x19B:    // RES 3, E
+                    e &= ~0b0000'1000;
+                    break;
+                case 0x19C:    // RES 3, H
+                    h &= ~0b0000'1000;
+                    break;
+                case 0x19D:    // RES 3, L
+                    l &= ~0b0000'1000;
+                    break;
+                case 0x19E:    // RES 3, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) & ~0b0000'1000);
+                    break;
+                case 0x19F:    // RES 3, A
+                    a &= ~0b0000'1000;
+                    break;
+                case 0x1A0:    // RES 4, B
+                    b &= ~0b0001'0000;
+                    break;
+                case 0x1A1:    // RES 4, C
+                    c &= ~0b0001'0000;
+                    break;
+                case 0x1A2:    // RES 4, D
+                    d &= ~0b0001'0000;
+                    break;
+                case 0x1A3:    // RES 4, E
+                    e &= ~0b0001'0000;
+                    break;
+                case 0x1A4:    // RES 4, H
+                    h &= ~0b0001'0000;
+                    break;
+                case 0x1A5:    // RES 4, L
+                    l &= ~0b0001'0000;
+                    break;
+                case 0x1A6:    // RES 4, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) & ~0b0001'0000);
+                    break;
+                case 0x1A7:    // RES 4, A
+                    a &= ~0b0001'0000;
+                    break;
+                case 0x1A8:    // RES 5, B
+                    b &= ~0b0010'0000;
+                    break;
+                case 0x1A9:    // RES 5, C
+                    c &= ~0b0010'0000;
+                    break;
+                case 0x1AA:    // RES 5, D
+                    d &= ~0b0010'0000;
+                    break;
+                case 0x1AB:    // RES 5, E
+                    e &= ~0b0010'0000;
+                    break;
+                case 0x1AC:    // RES 5, H
+                    h &= ~0b0010'0000;
+                    break;
+                case 0x1AD:    // RES 5, L
+                    l &= ~0b0010'0000;
+                    break;
+                case 0x1AE:    // RES 5, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) & ~0b0010'0000);
+                    break;
+                case 0x1AF:    // RES 5, A
+                    a &= ~0b0010'0000;
+                    break;
+                case 0x1B0:    // RES 6, B
+                    b &= ~0b0100'0000;
+                    break;
+                case 0x1B1:    // RES 6, C
+                    c &= ~0b0100'0000;
+                    break;
+                case 0x1B2:    // RES 6, D
+                    d &= ~0b0100'0000;
+                    break;
+                case 0x1B3:    // RES 6, E
+                    e &= ~0b0100'0000;
+                    break;
+                case 0x1B4:    // RES 6, H
+                    h &= ~0b0100'0000;
+                    break;
+                case 0x1B5:    // RES 6, L
+                    l &= ~0b0100'0000;
+                    break;
+                case 0x1B6:    // RES 6, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) & ~0b0100'0000);
+                    break;
+                case 0x1B7:    // RES 6, A
+                    a &= ~0b0100'0000;
+                    break;
+                case 0x1B8:    // RES 7, B
+                    b &= ~0b1000'0000;
+                    break;
+                case 0x1B9:    // RES 7, C
+                    c &= ~0b1000'0000;
+                    break;
+                case 0x1BA:    // RES 7, D
+                    d &= ~0b1000'0000;
+                    break;
+                case 0x1BB:    // RES 7, E
+                    e &= ~0b1000'0000;
+                    break;
+                case 0x1BC:    // RES 7, H
+                    h &= ~0b1000'0000;
+                    break;
+                case 0x1BD:    // RES 7, L
+                    l &= ~0b1000'0000;
+                    break;
+                case 0x1BE:    // RES 7, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) & ~0b1000'0000);
+                    break;
+                case 0x1BF:    // RES 7, A
+                    a &= ~0b1000'0000;
+                    break;
+                case 0x1C0:    // SET 0, B
+                    b |= 0b0000'0001;
+                    break;
+                case 0x1C1:    // SET 0, C
+                    c |= 0b0000'0001;
+                    break;
+                case 0x1C2:    // SET 0, D
+                    d |= 0b0000'0001;
+                    break;
+                case 0x1C3:    // SET 0, E
+                    e |= 0b0000'0001;
+                    break;
+                case 0x1C4:    // SET 0, H
+                    h |= 0b0000'0001;
+                    break;
+                case 0x1C5:    // SET 0, L
+                    l |= 0b0000'0001;
+                    break;
+                case 0x1C6:    // SET 0, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) | 0b0000'0001);
+                    break;
+                case 0x1C7:    // SET 0, A
+                    a |= 0b0000'0001;
+                    break;
+                case 0x1C8:    // SET 1, B
+                    b |= 0b0000'0010;
+                    break;
+                case 0x1C9:    // SET 1, C
+                    c |= 0b0000'0010;
+                    break;
+                case 0x1CA:    // SET 1, D
+                    d |= 0b0000'0010;
+                    break;
+                case 0x1CB:    // SET 1, E
+                    e |= 0b0000'0010;
+                    break;
+                case 0x1CC:    // SET 1, H
+                    h |= 0b0000'0010;
+                    break;
+                case 0x1CD:    // SET 1, L
+                    l |= 0b0000'0010;
+                    break;
+                case 0x1CE:    // SET 1, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) | 0b0000'0010);
+                    break;
+                case 0x1CF:    // SET 1, A
+                    a |= 0b0000'0010;
+                    break;
+                case 0x1D0:    // SET 2, B
+                    b |= 0b0000'0100;
+                    break;
+                case 0x1D1:    // SET 2, C
+                    c |= 0b0000'0100;
+                    break;
+                case 0x1D2:    // SET 2, D
+                    d |= 0b0000'0100;
+                    break;
+                case 0x1D3:    // SET 2, E
+                    e |= 0b0000'0100;
+                    break;
+                case 0x1D4:    // SET 2, H
+                    h |= 0b0000'0100;
+                    break;
+                case 0x1D5:    // SET 2, L
+                    l |= 0b0000'0100;
+                    break;
+                case 0x1D6:    // SET 2, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) | 0b0000'0100);
+                    break;
+                case 0x1D7:    // SET 2, A
+                    a |= 0b0000'0100;
+                    break;
+                case 0x1D8:    // SET 3, B
+                    b |= 0b0000'1000;
+                    break;
+                case 0x1D9:    // SET 3, C
+                    c |= 0b0000'1000;
+                    break;
+                case 0x1DA:    // SET 3, D
+                    d |= 0b0000'1000;
+                    break;
+                case 0x1DB:    // SET 3, E
+                    e |= 0b0000'1000;
+                    break;
+                case 0x1DC:    // SET 3, H
+                    h |= 0b0000'1000;
+                    break;
+                case 0x1DD:    // SET 3, L
+                    l |= 0b0000'1000;
+                    break;
+                case 0x1DE:    // SET 3, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) | 0b0000'1000);
+                    break;
+                case 0x1DF:    // SET 3, A
+                    a |= 0b0000'1000;
+                    break;
+                case 0x1E0:    // SET 4, B
+                    b |= 0b0001'0000;
+                    break;
+                case 0x1E1:    // SET 4, C
+                    c |= 0b0001'0000;
+                    break;
+                case 0x1E2:    // SET 4, D
+                    d |= 0b0001'0000;
+                    break;
+                case 0x1E3:    // SET 4, E
+                    e |= 0b0001'0000;
+                    break;
+                case 0x1E4:    // SET 4, H
+                    h |= 0b0001'0000;
+                    break;
+                case 0x1E5:    // SET 4, L
+                    l |= 0b0001'0000;
+                    break;
+                case 0x1E6:    // SET 4, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) | 0b0001'0000);
+                    break;
+                case 0x1E7:    // SET 4, A
+                    a |= 0b0001'0000;
+                    break;
+                case 0x1E8:    // SET 5, B
+                    b |= 0b0010'0000;
+                    break;
+                case 0x1E9:    // SET 5, C
+                    c |= 0b0010'0000;
+                    break;
+                case 0x1EA:    // SET 5, D
+                    d |= 0b0010'0000;
+                    break;
+                case 0x1EB:    // SET 5, E
+                    e |= 0b0010'0000;
+                    break;
+                case 0x1EC:    // SET 5, H
+                    h |= 0b0010'0000;
+                    break;
+                case 0x1ED:    // SET 5, L
+                    l |= 0b0010'0000;
+                    break;
+                case 0x1EE:    // SET 5, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) | 0b0010'0000);
+                    break;
+                case 0x1EF:    // SET 5, A
+                    a |= 0b0010'0000;
+                    break;
+                case 0x1F0:    // SET 6, B
+                    b |= 0b0100'0000;
+                    break;
+                case 0x1F1:    // SET 6, C
+                    c |= 0b0100'0000;
+                    break;
+                case 0x1F2:    // SET 6, D
+                    d |= 0b0100'0000;
+                    break;
+                case 0x1F3:    // SET 6, E
+                    e |= 0b0100'0000;
+                    break;
+                case 0x1F4:    // SET 6, H
+                    h |= 0b0100'0000;
+                    break;
+                case 0x1F5:    // SET 6, L
+                    l |= 0b0100'0000;
+                    break;
+                case 0x1F6:    // SET 6, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) | 0b0100'0000);
+                    break;
+                case 0x1F7:    // SET 6, A
+                    a |= 0b0100'0000;
+                    break;
+                case 0x1F8:    // SET 7, B
+                    b |= 0b1000'0000;
+                    break;
+                case 0x1F9:    // SET 7, C
+                    c |= 0b1000'0000;
+                    break;
+                case 0x1FA:    // SET 7, D
+                    d |= 0b1000'0000;
+                    break;
+                case 0x1FB:    // SET 7, E
+                    e |= 0b1000'0000;
+                    break;
+                case 0x1FC:    // SET 7, H
+                    h |= 0b1000'0000;
+                    break;
+                case 0x1FD:    // SET 7, L
+                    l |= 0b1000'0000;
+                    break;
+                case 0x1FE:    // SET 7, (HL)
+                    mmu.write8(hl(), mmu.read8(hl()) | 0b1000'0000);
+                    break;
+                case 0x1FF:    // SET 7, A
+                    a |= 0b1000'0000;
+                    break;
+
+                // Fused idioms. Whole loop iterations run while they end before
+                // `deadline` and `end` and can't have side effects the per-
+                // instruction checks would catch: no pending EI/HALT delay, no
+                // IO or MBC writes, no writes to this block. Otherwise only the
+                // first instruction runs and the rest go through the cases above.
+                case kFusedOps + static_cast<u16>(Idiom::Copy):
+                {
+                    const DecodedOp& jr {inst[4]};
+                    const int taken {kInstCycles[0x2A] + kInstCycles[0x12] + kInstCycles[0x13] + kInstCycles[0x05] + kInstCyclesAlt[0x20]};
+                    const int not_taken {taken - kInstCyclesAlt[0x20] + kInstCycles[0x20]};
+                    const auto can_fuse = [&] {
+                        const u8 page {static_cast<u8>(de() >> 8)};
+                        return now + taken <= std::min(deadline, end) && hl() < 0xFE00 && de() >= 0x8000 && de() < 0xE000 && page != block.first_page && page != block.last_page;
+                    };
+                    if (cycles != inst->cycles || halt_bug_state != HaltBug::None || ei_bug_state != EIBug::None || !can_fuse()) {
+                        a = mmu.read8(hl());
+                        set_hl(hl() + 1);
+                        break;
+                    }
+                    cycles = 0;
+                    count--;
+                    do {
+                        a = mmu.read8(hl());
+                        set_hl(hl() + 1);
+                        mmu.write8(de(), a);
+                        set_de(de() + 1);
+                        alu::dec(b, f);
+                        pc = jr.pc + jr.size;
+                        if (!(f & FLAGS_ZERO)) {
+                            pc += int8_t(jr.d16 & 0xFF);
+                            now += taken;
+                        }
+                        else {
+                            now += not_taken;
+                        }
+                        count += 5;
+                        cache.fused[static_cast<int>(Idiom::Copy)]++;
+                    } while (pc == inst->pc && can_fuse());
+                    break;
+                }
+                case kFusedOps + static_cast<u16>(Idiom::Poll):
+                {
+                    const DecodedOp& cp {inst[1]};
+                    const DecodedOp& jr {inst[2]};
+                    const int taken {kInstCycles[0xF0] + kInstCycles[0xFE] + kInstCyclesAlt[0x20]};
+                    const int not_taken {taken - kInstCyclesAlt[0x20] + kInstCycles[0x20]};
+                    const auto can_fuse = [&] { return now + taken <= std::min(deadline, end); };
+                    if (cycles != inst->cycles || halt_bug_state != HaltBug::None || ei_bug_state != EIBug::None || !can_fuse()) {
+                        a = mmu.read8(0xFF00 + d8);
+                        break;
+                    }
+                    cycles = 0;
+                    count--;
+                    do {
+                        const u64 change {mmu.next_change(0xFF00 + d8)};
+                        a = mmu.read8(0xFF00 + d8);
+                        alu::cp(a, cp.d16 & 0xFF, f);
+                        pc = jr.pc + jr.size;
+                        if (!(f & FLAGS_ZERO)) {
+                            pc += int8_t(jr.d16 & 0xFF);
+                            now += taken;
+                        }
+                        else {
+                            now += not_taken;
+                        }
+                        count += 3;
+                        cache.fused[static_cast<int>(Idiom::Poll)]++;
+
+                        // The register reads the same until `change`, so
+                        // A and F come out the same in every pass that starts
+                        // before it: skip those, up to the next event
+                        if (pc == inst->pc && cache.idle_skip && change > now) {
+                            const u64 until {std::min(deadline, end)};
+                            u64 passes {(until - now) / taken};
+                            if (change < until) {
+                                passes = std::min(passes, (change - now + taken - 1) / taken);
+                            }
+                            now += passes * taken;
+                            count += 3 * passes;
+                            cache.idle_passes += passes;
+                        }
+                    } while (pc == inst->pc && can_fuse());
+                    break;
+                }
+                case kFusedOps + static_cast<u16>(Idiom::Delay):
+                {
+                    const DecodedOp& jr {inst[3]};
+                    const int taken {kInstCycles[0x0B] + kInstCycles[0x78] + kInstCycles[0xB1] + kInstCyclesAlt[0x20]};
+                    const int not_taken {taken - kInstCyclesAlt[0x20] + kInstCycles[0x20]};
+                    const auto can_fuse = [&] { return now + taken <= std::min(deadline, end); };
+                    if (cycles != inst->cycles || halt_bug_state != HaltBug::None || ei_bug_state != EIBug::None || !can_fuse()) {
+                        set_bc(bc() - 1);
+                        break;
+                    }
+                    cycles = 0;
+                    count--;
+                    do {
+                        set_bc(bc() - 1);
+                        a = b;
+                        OR(a, c, f);
+                        pc = jr.pc + jr.size;
+                        if (!(f & FLAGS_ZERO)) {
+                            pc += int8_t(jr.d16 & 0xFF);
+                            now += taken;
+                        }
+                        else {
+                            now += not_taken;
+                        }
+                        count += 4;
+                        cache.fused[static_cast<int>(Idiom::Delay)]++;
+                    } while (pc == inst->pc && can_fuse());
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            now += cycles;
+            count++;
+
+            if (halt_bug_state != HaltBug::None || ei_bug_state != EIBug::None) [[unlikely]] {
+                this->pc = pc;
+                halt_bug();
+                ei_bug();
+                pc = this->pc;
+            }
+
+            // Carry on in this block while execution falls through to the next
+            // decoded instruction and nothing needs the checks above
+            if (inst->store && !cache.is_current(block)) {
+                break;
+            }
+            if (++inst == block_end || inst->pc != pc) {
+                break;
+            }
+            if (now >= deadline || now >= end || (ime && interrupt_pending())) {
+                break;
+            }
+            cycles = 0;
+        }
+    }
+
+    this->a = a;
+    this->f = f;
+    this->b = b;
+    this->c = c;
+    this->d = d;
+    this->e = e;
+    this->h = h;
+    this->l = l;
+    this->sp = sp;
+    this->pc = pc;
+
+    return count;
+}
+
+#endif    // KORLOW_CPU_SWITCH_H
@@ -0,0 +1,845 @@
+#include "cpu/jit.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "cpu/alu_tables.h"
+#include "cpu/block_cache.h"
+#include "cpu/cpu.h"
+#include "mmu.h"
+
+#if defined(__x86_64__) && defined(__unix__)
+#define KORLOW_JIT_X64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Everything generated code needs, reached through rbx
+struct JitContext {
+    Cpu* cpu;
+    Mmu* mmu;
+    u64* now;
+    const u64* deadline;
+    u64 end;
+    u64 count;
+    u64 carry_cycles;    // Interrupt dispatch cycles, added with the first instruction's
+    const u8* ie;
+    const u8* if_;
+};
+
+using NativeBlock = void (*)(JitContext*);
+
+// Runs one decoded instruction through the table core. Returns # of cycles taken.
+u64 interpret(Cpu& cpu, Mmu& mmu, const DecodedOp& inst)
+{
+    cpu.pc = inst.pc + inst.size;
+    bool extra_cycles {false};
+    kInstructions<Mmu>[inst.op](cpu, mmu, inst.d16 & 0xFF, inst.d16, extra_cycles);
+    return extra_cycles ? kInstCyclesAlt[inst.op] : kInstCycles[inst.op];
+}
+
+}    // namespace
+
+#ifdef KORLOW_JIT_X64
+
+namespace {
+
+// The buffer starts small and doubles whenever it fills up, to at most
+// kMaxBufferSize. Only then does it start over.
+constexpr u64 kMinBufferSize {64 << 10};
+constexpr u64 kMaxBufferSize {8 << 20};
+
+// Worst case for one block, prologue, exits and epilogue included
+constexpr u64 kMaxBlockBytes {BlockCode::kMaxOps * 512 + 1024};
+
+// ModRM byte of the shift group (D0 /n) for each of RLC, RRC, RL, RR, SLA, SRA,
+// SWAP and SRL on AL. SWAP is a rotate by 4 instead.
+constexpr u8 kShifts[8] {0xC0, 0xC8, 0xD0, 0xD8, 0xE0, 0xF8, 0x00, 0xE8};
+
+/* Just the handful of x86-64 encodings the translator needs. */
+struct Emitter {
+    explicit Emitter(u8* p)
+        : p(p)
+    {
+    }
+
+    void emit(std::initializer_list<u8> bytes)
+    {
+        for (u8 b : bytes) {
+            *p++ = b;
+        }
+    }
+
+    void emit16(u16 v)
+    {
+        std::memcpy(p, &v, 2);
+        p += 2;
+    }
+
+    void emit32(u32 v)
+    {
+        std::memcpy(p, &v, 4);
+        p += 4;
+    }
+
+    void emit64(u64 v)
+    {
+        std::memcpy(p, &v, 8);
+        p += 8;
+    }
+
+    // [r12 + disp32] operand with `reg` in ModRM.reg
+    void r12_operand(u8 reg, u32 disp)
+    {
+        emit({static_cast<u8>(0x84 | (reg << 3)), 0x24});
+        emit32(disp);
+    }
+
+    // Jump with a rel32 to be patched. cc is the second opcode byte of Jcc, or 0 for JMP.
+    u8* jump(u8 cc)
+    {
+        if (cc) {
+            emit({0x0F, cc});
+        }
+        else {
+            emit({0xE9});
+        }
+        u8* field {p};
+        emit32(0);
+        return field;
+    }
+
+    static void patch(u8* field, const u8* target)
+    {
+        const int32_t rel = static_cast<int32_t>(target - (field + 4));
+        std::memcpy(field, &rel, 4);
+    }
+
+    u8* p;
+};
+
+constexpr u8 kJe {0x84};
+constexpr u8 kJne {0x85};
+constexpr u8 kJae {0x83};
+
+bool is_branch(u16 op)
+{
+    switch (op) {
+        case 0x18:    // JR d8
+        case 0x20:    // JR NZ, d8
+        case 0x28:    // JR Z, d8
+        case 0x30:    // JR NC, d8
+        case 0x38:    // JR C, d8
+        case 0xC2:    // JP NZ, d16
+        case 0xC3:    // JP d16
+        case 0xCA:    // JP Z, d16
+        case 0xD2:    // JP NC, d16
+        case 0xDA:    // JP C, d16
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Sets the protection of the pages spanning `bytes` at `from`
+void protect(u8* from, u64 bytes, int prot)
+{
+    static const uintptr_t page {static_cast<uintptr_t>(sysconf(_SC_PAGESIZE))};
+    const uintptr_t first {reinterpret_cast<uintptr_t>(from) & ~(page - 1)};
+    const uintptr_t last {(reinterpret_cast<uintptr_t>(from) + bytes + page - 1) & ~(page - 1)};
+    mprotect(reinterpret_cast<void*>(first), last - first, prot);
+}
+
+}    // namespace
+
+Jit::Jit() = default;
+
+Jit::~Jit()
+{
+    if (buffer) {
+        munmap(buffer, size);
+    }
+}
+
+bool Jit::is_available() const
+{
+    return !failed;
+}
+
+bool Jit::reserve(BlockCache& cache)
+{
+    if (buffer && used + kMaxBlockBytes <= size) {
+        return true;
+    }
+
+    if (size == kMaxBufferSize) {
+        // Start over rather than track which code is still reachable
+        cache.drop_native();
+        used = 0;
+        flushes++;
+        return true;
+    }
+
+    const u64 grown {buffer ? size * 2 : kMinBufferSize};
+    void* p {mmap(nullptr, grown, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+    if (p == MAP_FAILED) {
+        failed = !buffer;
+        return false;
+    }
+
+    // Everything translated so far goes with the old buffer
+    if (buffer) {
+        cache.drop_native();
+        munmap(buffer, size);
+    }
+    buffer = static_cast<u8*>(p);
+    size = grown;
+    used = 0;
+    return true;
+}
+
+const void* Jit::translate(Block& block, Cpu& cpu, Mmu& mmu, BlockCache& cache)
+{
+    if (!reserve(cache)) {
+        return nullptr;
+    }
+
+    u8* const start {buffer + used};
+    protect(start, kMaxBlockBytes, PROT_READ | PROT_WRITE);
+    Emitter x {start};
+
+    // Every way out records how many instructions ran, and the PC if the last
+    // one was native and so didn't store it
+    struct Exit {
+        u8* field;
+        int count;
+        int pc;
+    };
+    std::vector<Exit> exits;
+
+    const auto offset = [&](const void* field) {
+        return static_cast<u32>(static_cast<const u8*>(field) - reinterpret_cast<const u8*>(&cpu));
+    };
+
+    // Register index as in the opcode encoding, 6 being (HL)
+    const u32 reg_offsets[8] {
+        offset(&cpu.b),
+        offset(&cpu.c),
+        offset(&cpu.d),
+        offset(&cpu.e),
+        offset(&cpu.h),
+        offset(&cpu.l),
+        0,
+        offset(&cpu.a),
+    };
+    const u32 pair_offsets[4] {offset(&cpu.bc), offset(&cpu.de), offset(&cpu.hl), offset(&cpu.sp)};
+    const u32 pc_offset {offset(&cpu.pc)};
+    const u32 af_offset {offset(&cpu.af)};
+    const u32 f_offset {offset(&cpu.f)};
+    const u32 a_offset {offset(&cpu.a)};
+    const u32 ime_offset {offset(&cpu.ime)};
+    const u32 enabled_offset {offset(&cpu.enabled)};
+
+    // movzx reg32, byte [r12 + field]
+    const auto load = [&](u8 reg, u32 field) {
+        x.emit({0x41, 0x0F, 0xB6});
+        x.r12_operand(reg, field);
+    };
+
+    // mov [r12 + field], reg8
+    const auto store = [&](u8 reg, u32 field) {
+        x.emit({0x41, 0x88});
+        x.r12_operand(reg, field);
+    };
+
+    // and/or/xor byte [r12 + field], imm8, by the ModRM.reg of 80 /n
+    const auto byte_op = [&](u8 ext, u32 field, u8 imm) {
+        x.emit({0x41, 0x80});
+        x.r12_operand(ext, field);
+        x.emit({imm});
+    };
+
+    const auto store_pc = [&](u16 pc) {
+        x.emit({0x66, 0x41, 0xC7});    // mov word [r12 + pc], imm16
+        x.r12_operand(0, pc_offset);
+        x.emit16(pc);
+    };
+
+    const auto store_now = [&] {
+        x.emit({0x48, 0x8B, 0x4B, offsetof(JitContext, now)});    // mov rcx, [rbx + now]
+        x.emit({0x48, 0x89, 0x29});                              // mov [rcx], rbp
+    };
+
+    // r13 = min(*deadline, end)
+    const auto load_limit = [&] {
+        x.emit({0x48, 0x8B, 0x4B, offsetof(JitContext, deadline)});    // mov rcx, [rbx + deadline]
+        x.emit({0x4C, 0x8B, 0x29});                                    // mov r13, [rcx]
+        x.emit({0x48, 0x8B, 0x43, offsetof(JitContext, end)});         // mov rax, [rbx + end]
+        x.emit({0x49, 0x39, 0xC5});                                    // cmp r13, rax
+        x.emit({0x4C, 0x0F, 0x47, 0xE8});                              // cmova r13, rax
+    };
+
+    // The returned jump is taken when IME is set and an enabled interrupt is requested
+    const auto check_interrupts = [&] {
+        x.emit({0x41, 0x80});    // cmp byte [r12 + ime], 0
+        x.r12_operand(7, ime_offset);
+        x.emit({0x00});
+        u8* no_ime {x.jump(kJe)};
+        x.emit({0x48, 0x8B, 0x4B, offsetof(JitContext, ie)});     // mov rcx, [rbx + ie]
+        x.emit({0x0F, 0xB6, 0x01});                               // movzx eax, byte [rcx]
+        x.emit({0x48, 0x8B, 0x4B, offsetof(JitContext, if_)});    // mov rcx, [rbx + if_]
+        x.emit({0x22, 0x01});                                     // and al, [rcx]
+        x.emit({0xA8, 0x1F});                                     // test al, 0x1F
+        u8* pending {x.jump(kJne)};
+        Emitter::patch(no_ime, x.p);
+        return pending;
+    };
+
+    // Runs the instruction's table core handler, cycles in eax
+    const auto call_handler = [&](const DecodedOp& inst) {
+        const u16 op {inst.op};
+        store_pc(inst.pc + inst.size);
+        store_now();                                              // Devices schedule events relative to now
+        x.emit({0x4C, 0x89, 0xE7});                               // mov rdi, r12
+        x.emit({0x48, 0x8B, 0x73, offsetof(JitContext, mmu)});    // mov rsi, [rbx + mmu]
+        x.emit({0xBA});                                           // mov edx, d8
+        x.emit32(inst.d16 & 0xFF);
+        x.emit({0xB9});    // mov ecx, d16
+        x.emit32(inst.d16);
+        x.emit({0x4C, 0x8D, 0x04, 0x24});    // lea r8, [rsp]
+        x.emit({0xC6, 0x04, 0x24, 0x00});    // mov byte [rsp], 0
+        x.emit({0x48, 0xB8});                // mov rax, handler
+        x.emit64(reinterpret_cast<u64>(kInstructions<Mmu>[op]));
+        x.emit({0xFF, 0xD0});    // call rax
+        x.emit({0xB8});          // mov eax, base cycles
+        x.emit32(kInstCycles[op]);
+        if (kInstCyclesAlt[op] != kInstCycles[op]) {
+            x.emit({0x80, 0x3C, 0x24, 0x00});    // cmp byte [rsp], 0
+            x.emit({0xB9});                      // mov ecx, alt cycles
+            x.emit32(kInstCyclesAlt[op]);
+            x.emit({0x0F, 0x45, 0xC1});    // cmovne eax, ecx
+        }
+    };
+
+    // al = byte at the address in the 16-bit field. The returned jump is taken
+    // when the page has no direct mapping.
+    const auto read8 = [&](u32 address_offset) {
+        x.emit({0x41, 0x0F, 0xB7});    // movzx eax, word [r12 + address]
+        x.r12_operand(0, address_offset);
+        x.emit({0x0F, 0xB6, 0xCC});    // movzx ecx, ah
+        x.emit({0x48, 0xBA});          // mov rdx, read_map
+        x.emit64(reinterpret_cast<u64>(mmu.read_map.data()));
+        x.emit({0x48, 0x8B, 0x14, 0xCA});    // mov rdx, [rdx + rcx * 8]
+        x.emit({0x48, 0x85, 0xD2});          // test rdx, rdx
+        u8* slow {x.jump(kJe)};
+        x.emit({0x0F, 0xB6, 0xC0});    // movzx eax, al
+        x.emit({0x8A, 0x04, 0x02});    // mov al, [rdx + rax]
+        return slow;
+    };
+
+    // Z from the last x86 op, H if set, N and C clear
+    const auto logic_flags = [&](bool halfcarry) {
+        x.emit({0x0F, 0x94, 0xC1});    // sete cl
+        x.emit({0xC0, 0xE1, 0x07});    // shl cl, 7
+        if (halfcarry) {
+            x.emit({0x80, 0xC9, 0x20});    // or cl, FLAGS_HALFCARRY
+        }
+        store(0, a_offset);
+        store(1, f_offset);
+    };
+
+    // A op= ecx for the 8-bit ALU group, kind being bits 3-5 of the opcode:
+    // ADD, ADC, SUB, SBC, AND, XOR, OR, CP. The arithmetic ones look their
+    // result and flags up in kAluTables, like the interpreters.
+    const auto alu = [&](int kind) {
+        if (kind >= 4 && kind <= 6) {
+            x.emit({0x41, 0x8A});    // mov al, [r12 + a]
+            x.r12_operand(0, a_offset);
+            const u8 logic {kind == 4 ? u8(0x20) : kind == 5 ? u8(0x30) : u8(0x08)};
+            x.emit({logic, 0xC8});    // and/xor/or al, cl
+            logic_flags(kind == 4);
+            return;
+        }
+
+        load(0, a_offset);
+        if (kind == 1 || kind == 3) {
+            // Carry in picks the ADC/SBC half of the table
+            load(2, f_offset);
+            x.emit({0x83, 0xE2, FLAGS_CARRY});    // and edx, FLAGS_CARRY
+            x.emit({0xC1, 0xE2, 0x04});           // shl edx, 4
+            x.emit({0x09, 0xD0});                 // or eax, edx
+        }
+        x.emit({0xC1, 0xE0, 0x08});    // shl eax, 8
+        x.emit({0x09, 0xC8});          // or eax, ecx
+        x.emit({0x48, 0xBA});          // mov rdx, table
+        x.emit64(reinterpret_cast<u64>(kind <= 1 ? kAluTables.add[0].data() : kAluTables.sub[0].data()));
+        x.emit({0x0F, 0xB7, 0x04, 0x42});    // movzx eax, word [rdx + rax * 2]
+        if (kind == 7) {
+            x.emit({0xC1, 0xE8, 0x08});    // shr eax, 8
+            store(0, f_offset);
+        }
+        else {
+            x.emit({0x66, 0xC1, 0xC0, 0x08});    // rol ax, 8
+            x.emit({0x66, 0x41, 0x89});          // mov [r12 + af], ax
+            x.r12_operand(0, af_offset);
+        }
+    };
+
+    // now += cycles, plus the interrupt dispatch's for the first instruction
+    const auto add_cycles = [&](u32 cycles, bool first) {
+        x.emit({0x48, 0x81, 0xC5});    // add rbp, imm32
+        x.emit32(cycles);
+        if (first) {
+            x.emit({0x48, 0x03, 0x6B, offsetof(JitContext, carry_cycles)});    // add rbp, [rbx + carry_cycles]
+        }
+    };
+
+    // Prologue. rbx = context, r12 = cpu, rbp = now, r13 = min(deadline, end).
+    // [rsp] is the handlers' extra cycles flag and keeps calls 16-byte aligned.
+    x.emit({0x53});                      // push rbx
+    x.emit({0x55});                      // push rbp
+    x.emit({0x41, 0x54});                // push r12
+    x.emit({0x41, 0x55});                // push r13
+    x.emit({0x48, 0x83, 0xEC, 0x08});    // sub rsp, 8
+    x.emit({0x48, 0x89, 0xFB});                                 // mov rbx, rdi
+    x.emit({0x4C, 0x8B, 0x63, offsetof(JitContext, cpu)});      // mov r12, [rbx + cpu]
+    x.emit({0x48, 0x8B, 0x4B, offsetof(JitContext, now)});      // mov rcx, [rbx + now]
+    x.emit({0x48, 0x8B, 0x29});                                 // mov rbp, [rcx]
+    load_limit();
+
+    // Blocks chained to from others start here, with the registers above set.
+    // Every block has the same prologue, so this is the same offset in all.
+    const u32 chain_entry {static_cast<u32>(x.p - start)};
+
+    // Goes straight on to the translated block at `target` when the
+    // dispatcher has nothing to do in between: it's still current, nothing's
+    // due and no interrupt is pending. Otherwise exits to the dispatcher.
+    const auto chain = [&](u16 target, int count) {
+        std::vector<u8*> fail;
+        load_limit();
+        x.emit({0x4C, 0x39, 0xED});    // cmp rbp, r13
+        fail.push_back(x.jump(kJae));
+        x.emit({0x41, 0x80});    // cmp byte [r12 + enabled], 0
+        x.r12_operand(7, enabled_offset);
+        x.emit({0x00});
+        fail.push_back(x.jump(kJe));
+        fail.push_back(check_interrupts());
+
+        // The hit check of BlockCache::lookup
+        x.emit({0x48, 0xB9});    // mov rcx, slot
+        x.emit64(reinterpret_cast<u64>(cache.slot(target)));
+        x.emit({0x66, 0x81, 0x79, offsetof(Block, pc)});    // cmp word [rcx + pc], target
+        x.emit16(target);
+        fail.push_back(x.jump(kJne));
+        x.emit({0x80, 0x79, offsetof(Block, length), 0x00});    // cmp byte [rcx + length], 0
+        fail.push_back(x.jump(kJe));
+        x.emit({0x48, 0x8B, 0x51, offsetof(Block, native)});    // mov rdx, [rcx + native]
+        x.emit({0x48, 0x85, 0xD2});                             // test rdx, rdx
+        fail.push_back(x.jump(kJe));
+        x.emit({0x48, 0xBE});    // mov rsi, generations
+        x.emit64(reinterpret_cast<u64>(cache.generations()));
+        x.emit({0x0F, 0xB6, 0x41, offsetof(Block, first_page)});    // movzx eax, byte [rcx + first_page]
+        x.emit({0x8B, 0x79, offsetof(Block, first_generation)});    // mov edi, [rcx + first_generation]
+        x.emit({0x39, 0x3C, 0x86});                                 // cmp [rsi + rax * 4], edi
+        fail.push_back(x.jump(kJne));
+        x.emit({0x0F, 0xB6, 0x41, offsetof(Block, last_page)});    // movzx eax, byte [rcx + last_page]
+        x.emit({0x8B, 0x79, offsetof(Block, last_generation)});    // mov edi, [rcx + last_generation]
+        x.emit({0x39, 0x3C, 0x86});                                // cmp [rsi + rax * 4], edi
+        fail.push_back(x.jump(kJne));
+
+        x.emit({0x48, 0x81, 0x43, offsetof(JitContext, count)});    // add qword [rbx + count], count
+        x.emit32(count);
+        x.emit({0x48, 0xC7, 0x43, offsetof(JitContext, carry_cycles)});    // mov qword [rbx + carry_cycles], 0
+        x.emit32(0);
+        x.emit({0x48, 0x81, 0xC2});    // add rdx, chain_entry
+        x.emit32(chain_entry);
+        x.emit({0xFF, 0xE2});    // jmp rdx
+
+        for (u8* field : fail) {
+            Emitter::patch(field, x.p);
+        }
+        exits.push_back({x.jump(0), count, target});
+    };
+
+    for (int i = 0; i < block.length; i++) {
+        const DecodedOp& inst {block.ops[i]};
+        const u16 op {inst.op};
+        const u16 next_pc = inst.pc + inst.size;
+        const u8 d8 = inst.d16 & 0xFF;
+        bool native {true};
+
+        if (is_branch(op)) {
+            // Always last. Both ways go on to the next block.
+            const u16 target {op < 0x40 ? u16(next_pc + int8_t(d8)) : inst.d16};
+            if (op == 0x18 || op == 0xC3) {
+                add_cycles(inst.cycles, i == 0);
+                chain(target, i + 1);
+                break;
+            }
+
+            // NZ, Z, NC, C
+            const int condition {(op >> 3) & 3};
+            x.emit({0x41, 0xF6});    // test byte [r12 + f], flag
+            x.r12_operand(0, f_offset);
+            x.emit({condition < 2 ? u8(FLAGS_ZERO) : u8(FLAGS_CARRY)});
+            u8* not_taken {x.jump(condition & 1 ? kJe : kJne)};
+            add_cycles(kInstCyclesAlt[op], i == 0);
+            chain(target, i + 1);
+            Emitter::patch(not_taken, x.p);
+            add_cycles(inst.cycles, i == 0);
+            chain(next_pc, i + 1);
+            break;
+        }
+
+        if (op == 0x00) {
+            // NOP
+        }
+        else if (op >= 0x40 && op < 0x80 && op != 0x76 && (op & 7) != 6 && ((op >> 3) & 7) != 6) {
+            // LD r, r
+            const int dst = (op >> 3) & 7;
+            const int src = op & 7;
+            if (dst != src) {
+                x.emit({0x41, 0x8A});    // mov al, [r12 + src]
+                x.r12_operand(0, reg_offsets[src]);
+                store(0, reg_offsets[dst]);
+            }
+        }
+        else if (op < 0x40 && (op & 7) == 6 && op != 0x36) {
+            // LD r, d8
+            x.emit({0x41, 0xC6});    // mov byte [r12 + r], imm8
+            x.r12_operand(0, reg_offsets[op >> 3]);
+            x.emit({d8});
+        }
+        else if (op < 0x40 && (op & 0xF) == 0x1) {
+            // LD rr, d16
+            x.emit({0x66, 0x41, 0xC7});    // mov word [r12 + rr], imm16
+            x.r12_operand(0, pair_offsets[op >> 4]);
+            x.emit16(inst.d16);
+        }
+        else if (op < 0x40 && ((op & 0xF) == 0x3 || (op & 0xF) == 0xB)) {
+            // INC rr, DEC rr
+            x.emit({0x66, 0x41, 0xFF});    // inc/dec word [r12 + rr]
+            x.r12_operand((op & 0xF) == 0x3 ? 0 : 1, pair_offsets[op >> 4]);
+        }
+        else if (op < 0x40 && ((op & 7) == 4 || (op & 7) == 5) && (op >> 3) != 6) {
+            // INC r, DEC r: Z, N and H from the table, C kept
+            const u32 reg {reg_offsets[op >> 3]};
+            load(0, reg);
+            x.emit({0x48, 0xBA});    // mov rdx, table
+            x.emit64(reinterpret_cast<u64>((op & 7) == 4 ? kAluTables.inc.data() : kAluTables.dec.data()));
+            x.emit({0x0F, 0xB7, 0x04, 0x42});    // movzx eax, word [rdx + rax * 2]
+            store(0, reg);
+            load(1, f_offset);
+            x.emit({0x83, 0xE1, FLAGS_CARRY});    // and ecx, FLAGS_CARRY
+            x.emit({0xC1, 0xE8, 0x08});           // shr eax, 8
+            x.emit({0x09, 0xC8});                 // or eax, ecx
+            store(0, f_offset);
+        }
+        else if (op == 0x07 || op == 0x0F || op == 0x17 || op == 0x1F) {
+            // RLCA, RRCA, RLA, RRA: only C is set
+            load(0, a_offset);
+            if (op >= 0x17) {
+                load(1, f_offset);
+                x.emit({0x0F, 0xBA, 0xE1, 0x04});    // bt ecx, 4
+            }
+            x.emit({0xD0, kShifts[op >> 3]});    // rol/ror/rcl/rcr al, 1
+            x.emit({0x0F, 0x92, 0xC1});          // setc cl
+            x.emit({0xC0, 0xE1, 0x04});          // shl cl, 4
+            store(0, a_offset);
+            store(1, f_offset);
+        }
+        else if (op == 0x2F) {
+            // CPL
+            x.emit({0x41, 0xF6});    // not byte [r12 + a]
+            x.r12_operand(2, a_offset);
+            byte_op(4, f_offset, FLAGS_ZERO | FLAGS_CARRY);
+            byte_op(1, f_offset, FLAGS_SUBTRACT | FLAGS_HALFCARRY);
+        }
+        else if (op == 0x37) {
+            // SCF
+            byte_op(4, f_offset, FLAGS_ZERO);
+            byte_op(1, f_offset, FLAGS_CARRY);
+        }
+        else if (op == 0x3F) {
+            // CCF
+            byte_op(6, f_offset, FLAGS_CARRY);
+            byte_op(4, f_offset, FLAGS_ZERO | FLAGS_CARRY);
+        }
+        else if ((op >= 0x80 && op < 0xC0) || (op >= 0xC0 && op < 0x100 && (op & 7) == 6)) {
+            // 8-bit ALU with a register, d8 or (HL). Unmapped pages go through the handler.
+            u8* slow {nullptr};
+            if (op >= 0xC0) {
+                x.emit({0xB9});    // mov ecx, d8
+                x.emit32(d8);
+            }
+            else if ((op & 7) != 6) {
+                load(1, reg_offsets[op & 7]);
+            }
+            else {
+                slow = read8(pair_offsets[2]);
+                x.emit({0x0F, 0xB6, 0xC8});    // movzx ecx, al
+            }
+            alu((op >> 3) & 7);
+            if (slow) {
+                u8* done {x.jump(0)};
+                Emitter::patch(slow, x.p);
+                call_handler(inst);
+                Emitter::patch(done, x.p);
+            }
+        }
+        else if ((op >= 0x40 && op < 0x80 && op != 0x76 && (op & 7) == 6) || op == 0x0A || op == 0x1A || op == 0x2A || op == 0x3A) {
+            // LD r, (HL), LD A, (BC), LD A, (DE), LD A, (HL+), LD A, (HL-).
+            // Unmapped pages go through the handler.
+            const u32 address {op == 0x0A ? pair_offsets[0] : op == 0x1A ? pair_offsets[1] : pair_offsets[2]};
+            const u32 dst {op < 0x40 ? a_offset : reg_offsets[(op >> 3) & 7]};
+            u8* slow {read8(address)};
+            store(0, dst);
+            if (op == 0x2A || op == 0x3A) {
+                x.emit({0x66, 0x41, 0xFF});    // inc/dec word [r12 + hl]
+                x.r12_operand(op == 0x2A ? 0 : 1, pair_offsets[2]);
+            }
+            u8* done {x.jump(0)};
+            Emitter::patch(slow, x.p);
+            call_handler(inst);
+            Emitter::patch(done, x.p);
+        }
+        else if (op >= 0x100 && (op & 7) != 6) {
+            // CB prefixed, on a register
+            const u32 reg {reg_offsets[op & 7]};
+            const int kind {(op >> 3) & 7};
+            const u8 mask {static_cast<u8>(1 << kind)};
+            if (op < 0x140) {
+                // Rotates, shifts and SWAP: Z and C
+                load(0, reg);
+                if (kind == 2 || kind == 3) {
+                    load(1, f_offset);
+                    x.emit({0x0F, 0xBA, 0xE1, 0x04});    // bt ecx, 4
+                }
+                if (kind == 6) {
+                    x.emit({0xC0, 0xC0, 0x04});    // rol al, 4
+                    x.emit({0xB9});                // mov ecx, 0
+                    x.emit32(0);
+                }
+                else {
+                    x.emit({0xD0, kShifts[kind]});    // shift al, 1
+                    x.emit({0x0F, 0x92, 0xC1});       // setc cl
+                    x.emit({0xC0, 0xE1, 0x04});       // shl cl, 4
+                }
+                x.emit({0x84, 0xC0});          // test al, al
+                x.emit({0x0F, 0x94, 0xC2});    // sete dl
+                x.emit({0xC0, 0xE2, 0x07});    // shl dl, 7
+                x.emit({0x08, 0xD1});          // or cl, dl
+                store(0, reg);
+                store(1, f_offset);
+            }
+            else if (op < 0x180) {
+                // BIT: Z if clear, H set, C kept
+                load(0, f_offset);
+                x.emit({0x83, 0xE0, FLAGS_CARRY});        // and eax, FLAGS_CARRY
+                x.emit({0x83, 0xC8, FLAGS_HALFCARRY});    // or eax, FLAGS_HALFCARRY
+                x.emit({0x41, 0xF6});                     // test byte [r12 + r], mask
+                x.r12_operand(0, reg);
+                x.emit({mask});
+                x.emit({0x0F, 0x94, 0xC1});    // sete cl
+                x.emit({0xC0, 0xE1, 0x07});    // shl cl, 7
+                x.emit({0x08, 0xC8});          // or al, cl
+                store(0, f_offset);
+            }
+            else if (op < 0x1C0) {
+                byte_op(4, reg, static_cast<u8>(~mask));    // RES
+            }
+            else {
+                byte_op(1, reg, mask);    // SET
+            }
+        }
+        else {
+            call_handler(inst);
+            native = false;
+            handler_ops++;
+        }
+
+        if (native) {
+            add_cycles(inst.cycles, i == 0);
+        }
+        else {
+            x.emit({0x48, 0x01, 0xC5});    // add rbp, rax
+            if (i == 0) {
+                x.emit({0x48, 0x03, 0x6B, offsetof(JitContext, carry_cycles)});    // add rbp, [rbx + carry_cycles]
+            }
+        }
+
+        const Exit exit {nullptr, i + 1, native ? next_pc : -1};
+
+        if (op == 0xFB) {
+            // EI, whose delay the caller applies
+            exits.push_back({x.jump(0), exit.count, exit.pc});
+            break;
+        }
+        if (i == block.length - 1) {
+            // Native instructions never end a block, so this one was cut short
+            // and carries on to the next. Handlers may have jumped anywhere.
+            if (native) {
+                chain(next_pc, exit.count);
+            }
+            else {
+                exits.push_back({x.jump(0), exit.count, exit.pc});
+            }
+            break;
+        }
+
+        if (inst.store) {
+            // Stores into this block end it
+            x.emit({0x48, 0xB9});    // mov rcx, generations
+            x.emit64(reinterpret_cast<u64>(cache.generations()));
+            x.emit({0x81, 0xB9});    // cmp dword [rcx + first_page * 4], first_generation
+            x.emit32(block.first_page * 4);
+            x.emit32(block.first_generation);
+            exits.push_back({x.jump(kJne), exit.count, exit.pc});
+            x.emit({0x81, 0xB9});    // cmp dword [rcx + last_page * 4], last_generation
+            x.emit32(block.last_page * 4);
+            x.emit32(block.last_generation);
+            exits.push_back({x.jump(kJne), exit.count, exit.pc});
+
+            // A store can schedule an earlier event or raise an interrupt
+            load_limit();
+            exits.push_back({check_interrupts(), exit.count, exit.pc});
+        }
+
+        x.emit({0x4C, 0x39, 0xED});    // cmp rbp, r13
+        exits.push_back({x.jump(kJae), exit.count, exit.pc});
+    }
+
+    // One stub per exit sets the PC and count, then they share the epilogue
+    std::vector<u8*> to_epilogue;
+    for (const Exit& exit : exits) {
+        Emitter::patch(exit.field, x.p);
+        if (exit.pc >= 0) {
+            store_pc(exit.pc);
+        }
+        x.emit({0xB8});    // mov eax, count
+        x.emit32(exit.count);
+        to_epilogue.push_back(x.jump(0));
+    }
+    for (u8* field : to_epilogue) {
+        Emitter::patch(field, x.p);
+    }
+    x.emit({0x48, 0x01, 0x43, offsetof(JitContext, count)});    // add [rbx + count], rax
+    store_now();
+    x.emit({0x48, 0x83, 0xC4, 0x08});    // add rsp, 8
+    x.emit({0x41, 0x5D});                // pop r13
+    x.emit({0x41, 0x5C});    // pop r12
+    x.emit({0x5D});          // pop rbp
+    x.emit({0x5B});          // pop rbx
+    x.emit({0xC3});          // ret
+
+    const u64 written {static_cast<u64>(x.p - start)};
+    protect(start, written, PROT_READ | PROT_EXEC);
+    used += (written + 15) & ~u64(15);
+
+    blocks_translated++;
+    return start;
+}
+
+#else
+
+Jit::Jit() = default;
+Jit::~Jit() = default;
+
+bool Jit::is_available() const
+{
+    return false;
+}
+
+bool Jit::reserve(BlockCache&)
+{
+    return false;
+}
+
+const void* Jit::translate(Block&, Cpu&, Mmu&, BlockCache&)
+{
+    return nullptr;
+}
+
+#endif
+
+u64 Jit::run_until(Cpu& cpu, Mmu& mmu, BlockCache& cache, u64& now, const u64& deadline, u64 end)
+{
+    if (!is_available()) {
+        return cpu.run_until(mmu, cache, now, deadline, end);
+    }
+
+    JitContext ctx {
+        .cpu = &cpu,
+        .mmu = &mmu,
+        .now = &now,
+        .deadline = &deadline,
+        .end = end,
+        .count = 0,
+        .carry_cycles = 0,
+        .ie = &cpu.registers.ie,
+        .if_ = &cpu.registers.if_,
+    };
+
+    while (now < deadline && now < end && cpu.enabled) {
+        u64 cycles {0};
+
+        const u8 pending {static_cast<u8>(cpu.registers.ie & cpu.registers.if_ & 0x1F)};
+        if (cpu.ime && pending) {
+            const int bit {__builtin_ctz(pending)};
+            cpu.ime = false;
+            cpu.registers.if_ &= ~(1u << bit);
+            cpu.sp -= 2;
+            mmu.write16(cpu.sp, cpu.pc);
+            cpu.pc = 0x40 + bit * 8;
+            cycles += 4;
+            cpu.halted = false;
+        }
+        else if (cpu.halted) {
+            if (!pending) {
+                break;    // The caller fast-forwards to the next event
+            }
+            cpu.halted = false;
+        }
+
+        Block& block {cache.lookup(mmu, cpu.pc)};
+        if (!block.native && ++block.runs >= threshold) {
+            block.native = translate(block, cpu, mmu, cache);
+        }
+
+        // Translated code doesn't apply HALT/EI delays, so runs one instruction at a time while they're pending
+        const bool delayed {cpu.halt_bug_state != HaltBug::None || cpu.ei_bug_state != EIBug::None};
+
+        if (block.native && !delayed) {
+            ctx.carry_cycles = cycles;
+            native_entries++;
+            reinterpret_cast<NativeBlock>(const_cast<void*>(block.native))(&ctx);
+        }
+        else {
+            for (int i = 0; i < block.length; i++) {
+                const DecodedOp& inst {block.ops[i]};
+                now += cycles + interpret(cpu, mmu, inst);
+                ctx.count++;
+                cycles = 0;
+
+                if (cpu.halt_bug_state != HaltBug::None || cpu.ei_bug_state != EIBug::None) {
+                    break;
+                }
+                if (inst.store && !cache.is_current(block)) {
+                    break;
+                }
+                if (now >= deadline || now >= end || (cpu.ime && cpu.interrupt_pending())) {
+                    break;
+                }
+            }
+        }
+
+        cpu.halt_bug();
+        cpu.ei_bug();
+    }
+
+    return ctx.count;
+}
@@ -0,0 +1,70 @@
+#ifndef KORLOW_JIT_H
+#define KORLOW_JIT_H
+
+#include "emu_types.h"
+
+struct Block;
+struct BlockCache;
+struct Cpu;
+struct Mmu;
+
+/*
+ * Translates hot blocks from the block cache into x86-64 code.
+ *
+ * Loads, 8- and 16-bit register arithmetic, rotates and shifts, bit operations
+ * and JR/JP are emitted natively, the arithmetic flags coming from kAluTables
+ * like the interpreters'. Stores, stack operations, CALL/RET and any load from
+ * a page without a direct mapping (IO) call the table core's handler for that
+ * instruction, so behaviour and cycle counts are the same as the interpreters'.
+ * After every instruction the generated code makes the same checks as
+ * Cpu::run_until: deadline, end of slice, pending interrupts, HALT/EI delays,
+ * and stores into the block itself.
+ *
+ * A block that ends in a jump, or runs into the next, goes straight on to the
+ * translated block there if it's current and the dispatcher has nothing to do,
+ * so hot loops stay in generated code.
+ *
+ * The code buffer is only mapped once something is translated, and grows as
+ * needed. Only the pages a block is written to are made writable meanwhile.
+ *
+ * Only built with KORLOW_JIT. Elsewhere than x86-64 Unix it just runs the
+ * switch core.
+ */
+struct Jit {
+    Jit();
+    ~Jit();
+
+    Jit(const Jit&) = delete;
+
+    // Same contract as Cpu::run_until
+    u64 run_until(Cpu& cpu, Mmu& mmu, BlockCache& cache, u64& now, const u64& deadline, u64 end);
+
+    // False if the code buffer couldn't be mapped or the host isn't supported
+    bool is_available() const;
+
+    // # of times a block is interpreted before it's translated
+    u32 threshold {16};
+
+    u64 blocks_translated {0};
+    u64 flushes {0};
+
+    // Instructions translated as calls to the table core
+    u64 handler_ops {0};
+
+    // Times the dispatcher ran translated code, rather than it chaining on
+    u64 native_entries {0};
+
+private:
+    // Makes room for a block, mapping, growing or flushing the buffer.
+    // False if it couldn't be mapped.
+    bool reserve(BlockCache& cache);
+
+    const void* translate(Block& block, Cpu& cpu, Mmu& mmu, BlockCache& cache);
+
+    u8* buffer {nullptr};
+    u64 size {0};
+    u64 used {0};
+    bool failed {false};
+};
+
+#endif    // KORLOW_JIT_H
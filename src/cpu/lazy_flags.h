@@ -0,0 +1,199 @@
+#ifndef KORLOW_LAZY_FLAGS_H
+#define KORLOW_LAZY_FLAGS_H
+
+#include "cpu/alu_tables.h"
+#include "cpu/cpu_base.h"
+#include "emu_types.h"
+
+/*
+ * F register for the switch core that remembers the last ALU operation and its
+ * operands instead of computing Z, N, H and C straight away. Most flags are
+ * overwritten before anything looks at them, so the work is only done when
+ * something reads F: a conditional branch, PUSH AF, ADC/SBC, DAA, rotates, or
+ * storing the registers back when Cpu::run_until returns.
+ *
+ * Converting to u8& materialises the flags, so the eager helpers work on it
+ * unchanged. The overloads below are the lazy versions of the common 8-bit
+ * operations; the cpu_core tests check both against the table core.
+ */
+class LazyFlags {
+public:
+    explicit LazyFlags(u8 value)
+        : value(value)
+    {
+    }
+
+    operator u8&()
+    {
+        materialize();
+        return value;
+    }
+
+    LazyFlags& operator=(u8 v)
+    {
+        kind = Kind::Value;
+        value = v;
+        return *this;
+    }
+
+    LazyFlags& operator&=(u8 v)
+    {
+        materialize();
+        value &= v;
+        return *this;
+    }
+
+    LazyFlags& operator|=(u8 v)
+    {
+        materialize();
+        value |= v;
+        return *this;
+    }
+
+    void add(u8 lhs, u8 rhs, u8 result)
+    {
+        kind = Kind::Add;
+        this->lhs = lhs;
+        this->rhs = rhs;
+        this->result = result;
+    }
+
+    void sub(u8 lhs, u8 rhs, u8 result)
+    {
+        kind = Kind::Sub;
+        this->lhs = lhs;
+        this->rhs = rhs;
+        this->result = result;
+    }
+
+    // INC and DEC keep the previous carry, which is all that's evaluated
+    void inc(u8 result)
+    {
+        value = carry();
+        kind = Kind::Inc;
+        this->result = result;
+    }
+
+    void dec(u8 result)
+    {
+        value = carry();
+        kind = Kind::Dec;
+        this->result = result;
+    }
+
+    // AND, XOR and OR: Z from the result, the rest fixed
+    void logic(u8 result, u8 fixed)
+    {
+        kind = Kind::Logic;
+        value = fixed;
+        this->result = result;
+    }
+
+private:
+    enum class Kind : u8 {
+        Value,    // `value` holds F
+        Add,
+        Sub,
+        Inc,      // `value` holds the carry
+        Dec,      // ditto
+        Logic,    // `value` holds N, H and C
+    };
+
+    u8 carry() const
+    {
+        switch (kind) {
+            case Kind::Add:
+                return result < lhs ? FLAGS_CARRY : 0;
+            case Kind::Sub:
+                return rhs > lhs ? FLAGS_CARRY : 0;
+            case Kind::Logic:
+                return 0;
+            default:
+                return value & FLAGS_CARRY;
+        }
+    }
+
+    void materialize()
+    {
+        const u8 zero = result ? 0 : FLAGS_ZERO;
+        switch (kind) {
+            case Kind::Value:
+                return;
+            case Kind::Add:
+                value = zero | ((lhs ^ rhs ^ result) & 0x10) << 1 | carry();
+                break;
+            case Kind::Sub:
+                value = FLAGS_SUBTRACT | zero | ((lhs & 0xF) < (rhs & 0xF) ? FLAGS_HALFCARRY : 0) | carry();
+                break;
+            case Kind::Inc:
+                value = zero | ((result & 0xF) == 0 ? FLAGS_HALFCARRY : 0) | value;
+                break;
+            case Kind::Dec:
+                value = FLAGS_SUBTRACT | zero | ((result & 0xF) == 0xF ? FLAGS_HALFCARRY : 0) | value;
+                break;
+            case Kind::Logic:
+                value = zero | value;
+                break;
+        }
+        kind = Kind::Value;
+    }
+
+    Kind kind {Kind::Value};
+    u8 value;
+    u8 lhs {0};
+    u8 rhs {0};
+    u8 result {0};
+};
+
+namespace alu {
+
+inline u8 add(u8 a, u8 b, LazyFlags &f)
+{
+    const u8 result = a + b;
+    f.add(a, b, result);
+    return result;
+}
+
+inline u8 sub(u8 a, u8 b, LazyFlags &f)
+{
+    const u8 result = a - b;
+    f.sub(a, b, result);
+    return result;
+}
+
+inline void cp(u8 a, u8 r, LazyFlags &f)
+{
+    f.sub(a, r, a - r);
+}
+
+inline void inc(u8 &r, LazyFlags &f)
+{
+    f.inc(++r);
+}
+
+inline void dec(u8 &r, LazyFlags &f)
+{
+    f.dec(--r);
+}
+
+}    // namespace alu
+
+inline void AND(u8 &a, u8 r, LazyFlags &f)
+{
+    a &= r;
+    f.logic(a, FLAGS_HALFCARRY);
+}
+
+inline void XOR(u8 &a, u8 r, LazyFlags &f)
+{
+    a ^= r;
+    f.logic(a, 0);
+}
+
+inline void OR(u8 &a, u8 r, LazyFlags &f)
+{
+    a |= r;
+    f.logic(a, 0);
+}
+
+#endif    // KORLOW_LAZY_FLAGS_H
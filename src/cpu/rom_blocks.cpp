@@ -0,0 +1,46 @@
+#include "cpu/rom_blocks.h"
+
+#include "cpu/block_cache.h"
+
+RomBlocks::RomBlocks(std::size_t size)
+    : page_count((size + 0xFF) >> 8)
+    , pages(std::make_unique<std::atomic<Page*>[]>(kVariants * page_count))
+{
+}
+
+RomBlocks::~RomBlocks()
+{
+    for (std::size_t i = 0; i < kVariants * page_count; i++) {
+        if (Page* page {pages[i].load(std::memory_order_relaxed)}) {
+            for (const auto& block : *page) {
+                delete block.load(std::memory_order_relaxed);
+            }
+            delete page;
+        }
+    }
+}
+
+const BlockCode* RomBlocks::find(u32 offset, int variant) const
+{
+    const Page* page {page_of(offset, variant).load(std::memory_order_acquire)};
+    return page ? (*page)[offset & 0xFF].load(std::memory_order_acquire) : nullptr;
+}
+
+const BlockCode* RomBlocks::publish(u32 offset, int variant, const BlockCode& code)
+{
+    std::atomic<Page*>& slot {page_of(offset, variant)};
+    Page* page {slot.load(std::memory_order_acquire)};
+    if (!page) {
+        auto fresh {std::make_unique<Page>()};
+        if (slot.compare_exchange_strong(page, fresh.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+            page = fresh.release();
+        }
+    }
+
+    auto fresh {std::make_unique<BlockCode>(code)};
+    const BlockCode* kept {nullptr};
+    if ((*page)[offset & 0xFF].compare_exchange_strong(kept, fresh.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return fresh.release();
+    }
+    return kept;
+}
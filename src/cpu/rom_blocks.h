@@ -0,0 +1,53 @@
+#ifndef KORLOW_ROM_BLOCKS_H
+#define KORLOW_ROM_BLOCKS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "emu_types.h"
+
+struct BlockCode;
+
+/*
+ * Code decoded from a ROM image, shared by every instance running it (see
+ * RomImage::blocks).
+ *
+ * ROM never changes, so a block decoded from it stays good whichever instance
+ * decoded it. Blocks are keyed by their offset into the image and the decode
+ * settings, in tables of a page each that are only allocated once code is
+ * found there. Both are published with a compare-and-swap: readers never
+ * wait, and when two instances decode the same block at once, the one that
+ * loses keeps the winner's and drops its own.
+ */
+struct RomBlocks {
+    // One set of blocks per combination of BlockCache::fusion and idle_skip
+    static constexpr int kVariants {4};
+
+    // For an image of `size` bytes
+    explicit RomBlocks(std::size_t size);
+
+    RomBlocks(const RomBlocks&) = delete;
+    ~RomBlocks();
+
+    // The block decoded at `offset`, nullptr if there's none yet
+    const BlockCode* find(u32 offset, int variant) const;
+
+    // Keeps a copy of `code` at `offset`, unless another thread got there
+    // first. Returns the one kept.
+    const BlockCode* publish(u32 offset, int variant, const BlockCode& code);
+
+private:
+    using Page = std::array<std::atomic<const BlockCode*>, 0x100>;
+
+    std::atomic<Page*>& page_of(u32 offset, int variant) const
+    {
+        return pages[variant * page_count + (offset >> 8)];
+    }
+
+    const std::size_t page_count;
+    const std::unique_ptr<std::atomic<Page*>[]> pages;
+};
+
+#endif    // KORLOW_ROM_BLOCKS_H
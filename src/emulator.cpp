@@ -0,0 +1,458 @@
+#include "emulator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "constants.h"
+#include "memory_map.h"
+
+Emulator::Emulator()
+    : Emulator(std::make_unique<State>())
+{
+}
+
+Emulator::Emulator(std::unique_ptr<State> block)
+    : state(std::move(block))
+    , mem(state->memory.data())
+    , cpu(CpuRegisters {
+          .io = mem[kIo],
+          .if_ = mem[kIf],
+          .ie = mem[kIe],
+      })
+    , ppu(
+          PpuRegisters {
+              .if_ = mem[kIf],
+              .lcdc = mem[kLcdc],
+              .stat = mem[kStat],
+              .scx = mem[kScx],
+              .scy = mem[kScy],
+              .ly = mem[kLy],
+              .lyc = mem[kLyc],
+              .wy = mem[kWy],
+              .wx = mem[kWx],
+          },
+          mem,
+          state->pixels.data())
+    , mmu(ppu, mem)
+    , timer(
+          TimerRegisters {
+              .if_ = mem[kIf],
+              .div = mem[kDiv],
+              .tima = mem[kTima],
+              .tma = mem[kTma],
+              .tac = mem[kTac],
+          },
+          scheduler)
+{
+    mmu.scheduler = &scheduler;
+    mmu.timer = &timer;
+    mmu.code_cache = &code_cache;
+    mmu.mbc.ram_storage = state->cart_ram;
+}
+
+void Emulator::reset(bool skip_bios)
+{
+    scheduler.reset();
+
+    cpu.reset(skip_bios);
+    mmu.reset(skip_bios);
+    ppu.reset(skip_bios);
+    timer.reset();
+    code_cache.reset();
+
+    scheduler.schedule(Event::Ppu, 0);
+
+    total_instructions = 0;
+
+    if (skip_bios) {
+        // Sound
+        mmu.write8(kNr10, 0x80);
+        mmu.write8(kNr11, 0xBF);
+        mmu.write8(kNr12, 0xF3);
+        mmu.write8(kNr14, 0xBF);
+        mmu.write8(kNr21, 0x3F);
+        mmu.write8(kNr24, 0xBF);
+        mmu.write8(kNr30, 0x7F);
+        mmu.write8(kNr31, 0xFF);
+        mmu.write8(kNr32, 0x9F);
+        mmu.write8(kNr34, 0xBF);
+        mmu.write8(kNr41, 0xFF);
+        mmu.write8(kNr44, 0xBF);
+        mmu.write8(kNr50, 0x77);
+        mmu.write8(kNr51, 0xF3);
+        mmu.write8(kNr52, 0xF1);
+
+        // CPU registers
+        mmu.write8(kIo, 0xCF);
+        mmu.write8(kIf, 0xE1);
+        mmu.write8(kIe, 0x00);
+
+        // PPU registers
+        mmu.write8(kLcdc, 0x91);
+        mmu.write8(kStat, 0x00);
+        mmu.write8(kScy, 0x00);
+        mmu.write8(kScy, 0x00);
+        mmu.write8(kLy, 0x00);
+        mmu.write8(kLyc, 0x00);
+        mmu.write8(kBgPalette, 0xFC);
+        mmu.write8(kObj0Palette, 0xFF);
+        mmu.write8(kObj1Palette, 0xFF);
+        mmu.write8(kWy, 0x00);
+        mmu.write8(kWx, 0x00);
+    }
+}
+
+u64 Emulator::run(u64 cycles, bool& redraw)
+{
+    const u64 start {scheduler.now};
+    const u64 end {cycles > kNever - start ? kNever : start + cycles};
+
+    while (!redraw && scheduler.now < end && cpu.is_enabled()) {
+        // An instruction may schedule an earlier event (TAC, DMA, serial), so re-read next.
+        while (scheduler.now < std::min(scheduler.next, end) && cpu.is_enabled()) {
+            if (cpu.halted && !cpu.interrupt_pending()) {
+                // Nothing can wake the CPU before the next event fires
+                scheduler.now = std::min(scheduler.next, end);
+                break;
+            }
+            switch (cpu.debug ? CpuCore::Table : core) {
+                case CpuCore::Table:
+                    scheduler.now += cpu.tick(mmu);
+                    total_instructions++;
+                    break;
+#ifdef KORLOW_JIT
+                case CpuCore::Jit:
+                    total_instructions += jit.run_until(cpu, mmu, code_cache, scheduler.now, scheduler.next, end);
+                    break;
+#endif
+                default:
+                    total_instructions += cpu.run_until(mmu, code_cache, scheduler.now, scheduler.next, end);
+                    break;
+            }
+        }
+        dispatch_events(redraw);
+    }
+
+    return scheduler.now - start;
+}
+
+static u16 cart_checksum(const Mbc& mbc)
+{
+    return mbc.loaded() ? u16(mbc.rom[0x14E] << 8 | mbc.rom[0x14F]) : 0;
+}
+
+// Copies the first `size` bytes of a state, but for the ROM window when a
+// cartridge covers it: the MBC maps ROM straight from the image, so that half
+// of `memory` is never read
+static void copy_state(State& to, const State& from, std::size_t size, bool rom_window)
+{
+    u8* const out {reinterpret_cast<u8*>(&to)};
+    const u8* const in {reinterpret_cast<const u8*>(&from)};
+    const std::size_t registers {std::size_t(from.memory.data() - in)};
+    const std::size_t skip {rom_window ? 0 : State::kRomWindow};
+
+    std::memcpy(out, in, registers);
+    std::memcpy(out + registers + skip, in + registers + skip, size - registers - skip);
+}
+
+void Emulator::gather_registers()
+{
+    State& live {*state};
+    const Mbc& mbc {mmu.mbc};
+
+    live.header = {
+        .magic = kStateMagic,
+        .version = kStateVersion,
+        .cart_checksum = cart_checksum(mbc),
+        .size = static_cast<u32>(State::size(mbc.ram.size())),
+    };
+
+    live.cpu = {
+        .pc = cpu.pc,
+        .sp = cpu.sp,
+        .af = cpu.af,
+        .bc = cpu.bc,
+        .de = cpu.de,
+        .hl = cpu.hl,
+        .halt_bug = static_cast<u8>(cpu.halt_bug_state),
+        .ei_bug = static_cast<u8>(cpu.ei_bug_state),
+        .halted = cpu.halted,
+        .enabled = cpu.enabled,
+        .ime = cpu.ime,
+        .unused = {},
+    };
+
+    live.ppu.mode = ppu.mode;
+    live.ppu.mode_counter = ppu.mode_counter;
+    live.ppu.line = ppu.line;
+    std::memcpy(live.ppu.bg_palette, ppu.bg_palette, sizeof(ppu.bg_palette));
+    std::memcpy(live.ppu.sprite_palette, ppu.sprite_palette, sizeof(ppu.sprite_palette));
+    live.ppu.sprites = ppu.sprites;
+    live.ppu.sprites_dirty = ppu.sprites_dirty;
+
+    timer.save(live.timer);
+    live.scheduler = scheduler;
+
+    live.mbc = {
+        .rtc_cycles = mbc.rtc.cycles,
+        .rtc_since = mbc.rtc.since,
+        .rom_bank = mbc.rom_bank,
+        .ram_enabled = mbc.ram_enabled,
+        .ram_bank = mbc.ram_bank,
+        .mode = mbc.mode,
+        .latch = mbc.latch,
+        .rtc_latched = mbc.rtc.latched,
+        .rtc_halted = mbc.rtc.halted,
+        .rtc_carry = mbc.rtc.carry,
+        .unused = {},
+    };
+
+    live.mmu = {
+        .dma_source = mmu.dma_source,
+        .boot_rom = mmu.boot_rom != nullptr,
+        .unused = {},
+    };
+}
+
+void Emulator::scatter_registers()
+{
+    State& live {*state};
+    Mbc& mbc {mmu.mbc};
+
+    cpu.pc = live.cpu.pc;
+    cpu.sp = live.cpu.sp;
+    cpu.af = live.cpu.af;
+    cpu.bc = live.cpu.bc;
+    cpu.de = live.cpu.de;
+    cpu.hl = live.cpu.hl;
+    cpu.halt_bug_state = static_cast<HaltBug>(live.cpu.halt_bug);
+    cpu.ei_bug_state = static_cast<EIBug>(live.cpu.ei_bug);
+    cpu.halted = live.cpu.halted;
+    cpu.enabled = live.cpu.enabled;
+    cpu.ime = live.cpu.ime;
+
+    ppu.mode = live.ppu.mode;
+    ppu.mode_counter = live.ppu.mode_counter;
+    ppu.line = live.ppu.line;
+    std::memcpy(ppu.bg_palette, live.ppu.bg_palette, sizeof(ppu.bg_palette));
+    std::memcpy(ppu.sprite_palette, live.ppu.sprite_palette, sizeof(ppu.sprite_palette));
+    ppu.sprites = live.ppu.sprites;
+    ppu.sprites_dirty = live.ppu.sprites_dirty;
+
+    timer.load(live.timer);
+    scheduler = live.scheduler;
+
+    mbc.ram_enabled = live.mbc.ram_enabled;
+    mbc.rom_bank = live.mbc.rom_bank;
+    mbc.ram_bank = live.mbc.ram_bank;
+    mbc.mode = live.mbc.mode;
+    mbc.latch = live.mbc.latch;
+    mbc.rtc.cycles = live.mbc.rtc_cycles;
+    mbc.rtc.since = live.mbc.rtc_since;
+    mbc.rtc.latched = live.mbc.rtc_latched;
+    mbc.rtc.halted = live.mbc.rtc_halted;
+    mbc.rtc.carry = live.mbc.rtc_carry;
+
+    mmu.dma_source = live.mmu.dma_source;
+    mmu.boot_rom = live.mmu.boot_rom ? mmu.bios : nullptr;
+
+    // Other banks may be mapped, and memory changed under any decoded code
+    mmu.map_pages();
+    code_cache.invalidate_all();
+
+    // The state loaded is the new checkpoint
+    mmu.clear_dirty();
+}
+
+void Emulator::check_header(const StateHeader& header) const
+{
+    const Mbc& mbc {mmu.mbc};
+
+    if (header.magic != kStateMagic || header.version != kStateVersion) {
+        throw std::runtime_error("Not a save state, or from another version");
+    }
+    if (header.cart_checksum != cart_checksum(mbc) || header.size != State::size(mbc.ram.size())) {
+        throw std::runtime_error("Save state is from another cartridge");
+    }
+}
+
+void Emulator::save_state(State& out)
+{
+    gather_registers();
+
+    State& live {*state};
+    const Mbc& mbc {mmu.mbc};
+
+    // Battery-backed RAM is in the save file rather than the block
+    const bool battery {mbc.ram.data() != live.cart_ram.data()};
+    copy_state(out, live, battery ? State::size(0) : live.header.size, !mbc.loaded());
+    if (battery) {
+        std::copy(mbc.ram.begin(), mbc.ram.end(), out.cart_ram.begin());
+    }
+
+    // Pages shared with a fork aren't in the block
+    if (mmu.base) {
+        for (int page = 0; page < 0x100; page++) {
+            if (mmu.shared[page]) {
+                std::memcpy(&out.memory[page << 8], mmu.memory_page(page), 0x100);
+            }
+        }
+        for (std::size_t page = 0; page < mbc.ram.size() >> 8; page++) {
+            if (mmu.ram_shared[page]) {
+                std::memcpy(&out.cart_ram[page << 8], mmu.ram_page(page), 0x100);
+            }
+        }
+        if (ppu.pixels_shared()) {
+            std::copy(ppu.pixels.begin(), ppu.pixels.end(), out.pixels.begin());
+        }
+    }
+}
+
+void Emulator::load_state(const State& in)
+{
+    check_header(in.header);
+
+    State& live {*state};
+    Mbc& mbc {mmu.mbc};
+
+    mmu.unshare_all(false);
+    const bool battery {mbc.ram.data() != live.cart_ram.data()};
+    copy_state(live, in, battery ? State::size(0) : in.header.size, !mbc.loaded());
+    if (battery) {
+        std::copy_n(in.cart_ram.begin(), mbc.ram.size(), mbc.ram.begin());
+    }
+
+    scatter_registers();
+}
+
+void Emulator::save_delta(StateDelta& out)
+{
+    gather_registers();
+    mmu.sync_dirty();
+
+    const State& live {*state};
+    const Mbc& mbc {mmu.mbc};
+
+    out.registers = live;
+    out.pages.clear();
+    out.data.clear();
+
+    const auto add = [&out](u16 page, const u8* data) {
+        out.pages.push_back(page);
+        out.data.insert(out.data.end(), data, data + 0x100);
+    };
+
+    for (int page = 0; page < 0x100; page++) {
+        // The PPU and timer write IO registers behind the MMU's back
+        if (mmu.dirty[page] || page == 0xFF) {
+            add(page, &live.memory[page << 8]);
+        }
+    }
+    for (std::size_t page = 0; page < mbc.ram.size() >> 8; page++) {
+        if (mbc.ram_dirty[page]) {
+            add(StateDelta::kCartRamPages + page, &mbc.ram[page << 8]);
+        }
+    }
+
+    mmu.clear_dirty();
+}
+
+void Emulator::load_delta(const StateDelta& in)
+{
+    check_header(in.registers.header);
+
+    State& live {*state};
+    Mbc& mbc {mmu.mbc};
+
+    static_cast<StateRegisters&>(live) = in.registers;
+    for (std::size_t i = 0; i < in.pages.size(); i++) {
+        const u16 page {in.pages[i]};
+        u8* to {nullptr};
+        // Overwritten whole, so there's no need to copy shared pages home first,
+        // but for the rest of VRAM
+        if (page < StateDelta::kCartRamPages) {
+            if (mmu.shared[page]) {
+                mmu.unshare(page);
+            }
+            to = &live.memory[page << 8];
+        }
+        else {
+            mmu.ram_shared[page - StateDelta::kCartRamPages] = false;
+            to = &mbc.ram[(page - StateDelta::kCartRamPages) << 8];
+        }
+        std::memcpy(to, &in.data[i << 8], 0x100);
+    }
+
+    scatter_registers();
+}
+
+std::unique_ptr<Emulator> Emulator::fork()
+{
+    mmu.freeze();
+    gather_registers();
+
+    // Not via make_unique: the constructor is private. The block isn't zeroed,
+    // so the pages the fork never touches aren't even committed.
+    std::unique_ptr<Emulator> child {new Emulator(std::make_unique_for_overwrite<State>())};
+    child->core = core;
+    child->cpu.debug = cpu.debug;
+    child->code_cache.fusion = code_cache.fusion;
+    child->code_cache.idle_skip = code_cache.idle_skip;
+
+    const State& from {*state};
+    State& to {*child->state};
+    static_cast<StateRegisters&>(to) = from;
+
+    // The registers the CPU, PPU and timer access directly
+    std::copy_n(&from.memory[kIo], 0x100, &to.memory[kIo]);
+
+    Mmu& child_mmu {child->mmu};
+    child_mmu.bios = mmu.bios;
+    child_mmu.mbc.share_cartridge(mmu.mbc);
+    child_mmu.base = mmu.base;
+    child_mmu.shared = mmu.shared;
+    child_mmu.ram_shared = mmu.ram_shared;
+    child->ppu.share_pixels(mmu.base->pixels.data());
+
+    // MBC2's RAM is never shared
+    const Mbc& mbc {mmu.mbc};
+    for (std::size_t page = 0; page < mbc.ram.size() >> 8; page++) {
+        if (!mmu.ram_shared[page]) {
+            std::copy_n(&mbc.ram[page << 8], 0x100, &child_mmu.mbc.ram[page << 8]);
+        }
+    }
+
+    child->scatter_registers();
+    return child;
+}
+
+u64 Emulator::run_frame()
+{
+    bool redraw = false;
+    return run(kNever, redraw);
+}
+
+void Emulator::dispatch_events(bool& redraw)
+{
+    while (scheduler.next <= scheduler.now) {
+        const u64 at {scheduler.next};
+        switch (scheduler.pop()) {
+            case Event::Ppu:
+                ppu.step_line(redraw);
+                scheduler.schedule(Event::Ppu, at + kCyclesPerLine);
+                break;
+            case Event::Tima:
+                timer.on_overflow(at);
+                break;
+            case Event::Dma:
+                mmu.dma_complete();
+                break;
+            case Event::Serial:
+                mmu.serial_complete();
+                break;
+            default:
+                break;
+        }
+    }
+}
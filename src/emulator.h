@@ -0,0 +1,97 @@
+#ifndef KORLOW_EMULATOR_H
+#define KORLOW_EMULATOR_H
+
+#include <memory>
+
+#include "cpu/block_cache.h"
+#include "cpu/cpu.h"
+#ifdef KORLOW_JIT
+#include "cpu/jit.h"
+#endif
+#include "emu_types.h"
+#include "mmu.h"
+#include "ppu.h"
+#include "scheduler.h"
+#include "state.h"
+#include "timer.h"
+
+enum class CpuCore {
+    Table,     // Function pointer table, one handler per opcode
+    Switch,    // Cpu::run_until, registers kept in locals
+    Jit,       // Hot blocks translated to x86-64. The switch core without KORLOW_JIT.
+};
+
+/* Everything needed to run a ROM without a frontend. */
+struct Emulator {
+    Emulator();
+
+    Emulator(const Emulator&) = delete;
+
+    // A new instance in the same state, that shares memory and cart RAM with
+    // this one page by page: either copies a page on its first write to it.
+    // VRAM comes home whole on the first write to it, and the frame when the
+    // next line is drawn. Only the registers and IO/HRAM are copied up front.
+    // The fork has no save file.
+    std::unique_ptr<Emulator> fork();
+
+    void reset(bool skip_bios);
+
+    // Runs the CPU for up to `cycles` cycles, stopping early when the PPU enters
+    // VBlank or the CPU stops. Returns # of cycles taken.
+    u64 run(u64 cycles, bool& redraw);
+
+    // Runs until the PPU enters VBlank or the CPU stops. Returns # of cycles taken.
+    u64 run_frame();
+
+    // Handles every event that is due.
+    void dispatch_events(bool& redraw);
+
+    // Copies the machine into `out`, State::size() bytes of it but the ROM
+    // window while a cartridge is loaded. See State.
+    void save_state(State& out);
+
+    // Throws if `in` is from another version or cartridge.
+    void load_state(const State& in);
+
+    // Copies the registers and the pages written since the last checkpoint
+    // into `out`. Saving a delta or loading anything makes a checkpoint.
+    void save_delta(StateDelta& out);
+
+    // Applies a delta on top of the checkpoint it was taken after, e.g. a chain
+    // of them on top of a full state. The frame is left as it was.
+    void load_delta(const StateDelta& in);
+
+    // The live state: memory and the PPU's buffers are in here
+    std::unique_ptr<State> state;
+
+    u8* mem {nullptr};
+
+    Scheduler scheduler;
+    Cpu cpu;
+    Ppu ppu;
+    Mmu mmu;
+    Timer timer;
+
+    // The table core is always used while cpu.debug is set, since only it traces.
+    CpuCore core {CpuCore::Switch};
+
+    // Decoded instructions for the switch and JIT cores
+    BlockCache code_cache;
+
+#ifdef KORLOW_JIT
+    Jit jit;
+#endif
+
+    u64 total_instructions {0};
+
+private:
+    explicit Emulator(std::unique_ptr<State> block);
+
+    // Between the live state's header and registers and the components
+    void gather_registers();
+    void scatter_registers();
+
+    void check_header(const StateHeader& header) const;
+};
+
+#endif    // KORLOW_EMULATOR_H
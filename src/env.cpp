@@ -0,0 +1,77 @@
+#include "env.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "emulator.h"
+
+namespace {
+
+const Env::Config& check(const Env::Config& config)
+{
+    if (config.frame_skip < 1 || config.downscale < 1) {
+        throw std::runtime_error("Env needs a frame skip and downscale of at least 1");
+    }
+    return config;
+}
+
+}    // namespace
+
+Env::Env(const Cartridge& cart, Config config)
+    : config(check(config))
+    , batch(cart, config.instances, config.threads, config.pin)
+    , start(std::make_unique<State>())
+{
+    if (size() > 0) {
+        batch[0].save_state(*start);
+    }
+}
+
+void Env::step(const u8* actions, u8* frames, u8* features)
+{
+    batch.for_each([&](std::size_t i) {
+        Emulator& emulator {batch[i]};
+        emulator.mmu.set_joypad(actions[i]);
+        for (int frame = 0; frame < config.frame_skip && emulator.cpu.is_enabled(); frame++) {
+            emulator.run_frame();
+        }
+
+        if (frames) {
+            shrink(emulator.ppu.get_pixels(), frames + i * frame_size());
+        }
+        if (features) {
+            u8* out {features + i * config.probes.size()};
+            for (const u16 address : config.probes) {
+                *out++ = emulator.mmu.read8(address);
+            }
+        }
+    });
+}
+
+void Env::reset(std::size_t i)
+{
+    batch[i].load_state(*start);
+}
+
+void Env::shrink(const u8* pixels, u8* out) const
+{
+    const int scale {config.downscale};
+    if (scale == 1) {
+        std::memcpy(out, pixels, frame_size());
+        return;
+    }
+
+    const int area {scale * scale};
+    for (int y = 0; y < frame_height(); y++) {
+        for (int x = 0; x < frame_width(); x++) {
+            int sum {0};
+            const u8* block {pixels + (y * kLcdWidth + x) * scale};
+            for (int dy = 0; dy < scale; dy++) {
+                for (int dx = 0; dx < scale; dx++) {
+                    sum += block[dy * kLcdWidth + dx];
+                }
+            }
+            *out++ = static_cast<u8>((sum + area / 2) / area);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef KORLOW_ENV_H
+#define KORLOW_ENV_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "batch.h"
+#include "cartridge.h"
+#include "constants.h"
+#include "emu_types.h"
+#include "state.h"
+
+/*
+ * A batch driven the way a training loop wants it: step() holds down one set
+ * of buttons per instance for `frame_skip` frames, then writes out the last
+ * frame, shrunk, and the bytes at `probes`, which the caller turns into rewards
+ * and observations. Both go straight into the caller's buffers; nothing is
+ * allocated per step.
+ */
+struct Env {
+    struct Config {
+        std::size_t instances {1};
+        unsigned threads {0};    // See Batch
+        bool pin {false};
+        int frame_skip {4};
+        int downscale {2};       // Each side is divided by this, averaging the pixels
+        std::vector<u16> probes;
+    };
+
+    // Throws if frame_skip or downscale is below 1
+    Env(const Cartridge& cart, Config config);
+
+    // `actions` holds a JoypadButton mask per instance. `frames` takes
+    // frame_size() bytes and `features` probes.size() bytes per instance, one
+    // after the other. Either can be null to skip it.
+    void step(const u8* actions, u8* frames, u8* features);
+
+    // Puts instance i back as it was when the Env was made
+    void reset(std::size_t i);
+
+    std::size_t size() const
+    {
+        return batch.size();
+    }
+
+    int frame_width() const
+    {
+        return kLcdWidth / config.downscale;
+    }
+    int frame_height() const
+    {
+        return kLcdHeight / config.downscale;
+    }
+    std::size_t frame_size() const
+    {
+        return static_cast<std::size_t>(frame_width()) * frame_height();
+    }
+
+    const Config config;
+    Batch batch;
+
+private:
+    void shrink(const u8* pixels, u8* out) const;
+
+    std::unique_ptr<State> start;
+};
+
+#endif    // KORLOW_ENV_H
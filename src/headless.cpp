@@ -0,0 +1,229 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "batch.h"
+#include "cartridge.h"
+#include "constants.h"
+#include "emulator.h"
+#include "rewind.h"
+
+void print_usage(const char* exe)
+{
+    fprintf(stderr, "Usage: %s <rom> [--frames N | --cycles N] [--bios <path>] [--core table|switch|jit] [--no-fusion] [--no-idle-skip] [--no-save] [--rewind] [--batch N [--threads N] [--pin]]\n", exe);
+}
+
+// Runs `count` instances for `max_frames` frames each, to measure how it scales
+int run_batch(const Cartridge& cart, std::size_t count, unsigned threads, bool pin, u64 max_frames, CpuCore core, bool fusion, bool idle_skip)
+{
+    Batch batch {cart, count, threads, pin};
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        batch[i].core = core;
+        batch[i].code_cache.fusion = fusion;
+        batch[i].code_cache.idle_skip = idle_skip;
+    }
+
+    const auto start {std::chrono::steady_clock::now()};
+    for (u64 frame = 0; frame < max_frames; frame++) {
+        batch.run_frame();
+    }
+    const auto end {std::chrono::steady_clock::now()};
+    const double seconds {std::chrono::duration<double>(end - start).count()};
+
+    u64 instructions {0};
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        instructions += batch[i].total_instructions;
+    }
+    const double frames {static_cast<double>(max_frames * batch.size())};
+
+    fprintf(stdout, "Instances:    %zu\n", batch.size());
+    fprintf(stdout, "Frames:       %llu each\n", static_cast<unsigned long long>(max_frames));
+    fprintf(stdout, "Instructions: %llu\n", static_cast<unsigned long long>(instructions));
+    fprintf(stdout, "Time:         %.3f s\n", seconds);
+    fprintf(stdout, "Frames/s:     %.0f\n", seconds > 0.0 ? frames / seconds : 0.0);
+    fprintf(stdout, "MIPS:         %.1f\n", seconds > 0.0 ? instructions / seconds / 1e6 : 0.0);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const char* rom_path {nullptr};
+    const char* bios_path {nullptr};
+    u64 max_frames {600};
+    u64 max_cycles {0};
+    CpuCore core {CpuCore::Switch};
+    bool fusion {true};
+    bool idle_skip {true};
+    bool save {true};
+    bool rewind {false};
+    std::size_t batch {0};
+    unsigned threads {0};
+    bool pin {false};
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) {
+            max_frames = std::strtoull(argv[++i], nullptr, 10);
+            max_cycles = 0;
+        }
+        else if (!std::strcmp(argv[i], "--cycles") && i + 1 < argc) {
+            max_cycles = std::strtoull(argv[++i], nullptr, 10);
+            max_frames = 0;
+        }
+        else if (!std::strcmp(argv[i], "--bios") && i + 1 < argc) {
+            bios_path = argv[++i];
+        }
+        else if (!std::strcmp(argv[i], "--core") && i + 1 < argc) {
+            const char* name {argv[++i]};
+            if (!std::strcmp(name, "table")) {
+                core = CpuCore::Table;
+            }
+            else if (!std::strcmp(name, "switch")) {
+                core = CpuCore::Switch;
+            }
+            else if (!std::strcmp(name, "jit")) {
+                core = CpuCore::Jit;
+            }
+            else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "--no-fusion")) {
+            fusion = false;
+        }
+        else if (!std::strcmp(argv[i], "--no-idle-skip")) {
+            idle_skip = false;
+        }
+        else if (!std::strcmp(argv[i], "--no-save")) {
+            save = false;
+        }
+        else if (!std::strcmp(argv[i], "--rewind")) {
+            rewind = true;
+        }
+        else if (!std::strcmp(argv[i], "--batch") && i + 1 < argc) {
+            batch = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (!std::strcmp(argv[i], "--pin")) {
+            pin = true;
+        }
+        else if (argv[i][0] != '-' && !rom_path) {
+            rom_path = argv[i];
+        }
+        else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!rom_path || (batch && max_cycles)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        const bool skip_bios {bios_path == nullptr};
+
+        Cartridge cart;
+        if (bios_path) {
+            cartridge_load_bios(&cart, bios_path);
+        }
+        cartridge_load_rom(&cart, rom_path);
+        if (!save) {
+            cart.save_path.clear();
+        }
+
+        if (batch) {
+            return run_batch(cart, batch, threads, pin, max_frames, core, fusion, idle_skip);
+        }
+
+        Emulator emulator;
+        emulator.core = core;
+        emulator.code_cache.fusion = fusion;
+        emulator.code_cache.idle_skip = idle_skip;
+        emulator.reset(skip_bios);
+        mmu_set_cartridge(&emulator.mmu, &cart, skip_bios);
+
+        // Captures every frame, to measure what that costs
+        std::unique_ptr<Rewind> rewinder;
+        if (rewind) {
+            rewinder = std::make_unique<Rewind>();
+        }
+
+        u64 frames {0};
+
+        const auto start {std::chrono::steady_clock::now()};
+
+        if (max_cycles) {
+            while (emulator.cpu.is_enabled() && emulator.scheduler.now < max_cycles) {
+                bool redraw {false};
+                emulator.run(max_cycles - emulator.scheduler.now, redraw);
+                if (redraw) {
+                    frames++;
+                    if (rewinder) {
+                        rewinder->capture(emulator);
+                    }
+                }
+            }
+        }
+        else {
+            while (emulator.cpu.is_enabled() && frames < max_frames) {
+                emulator.run_frame();
+                frames++;
+                if (rewinder) {
+                    rewinder->capture(emulator);
+                }
+            }
+        }
+
+        const auto end {std::chrono::steady_clock::now()};
+        const double seconds {std::chrono::duration<double>(end - start).count()};
+        const u64 cycles {emulator.scheduler.now};
+        const double cycles_per_second {seconds > 0.0 ? cycles / seconds : 0.0};
+        const double mips {seconds > 0.0 ? emulator.total_instructions / seconds / 1e6 : 0.0};
+
+        fprintf(stdout, "Frames:       %llu\n", static_cast<unsigned long long>(frames));
+        fprintf(stdout, "Cycles:       %llu\n", static_cast<unsigned long long>(cycles));
+        fprintf(stdout, "Instructions: %llu\n", static_cast<unsigned long long>(emulator.total_instructions));
+        fprintf(stdout, "Time:         %.3f s\n", seconds);
+        fprintf(stdout, "Cycles/s:     %.0f (%.1fx realtime)\n", cycles_per_second, cycles_per_second / kCpuFreq);
+        fprintf(stdout, "MIPS:         %.1f\n", mips);
+
+        const auto& fused {emulator.code_cache.fused};
+        fprintf(stdout,
+                "Fused loops:  copy %llu, poll %llu, delay %llu\n",
+                static_cast<unsigned long long>(fused[static_cast<int>(Idiom::Copy)]),
+                static_cast<unsigned long long>(fused[static_cast<int>(Idiom::Poll)]),
+                static_cast<unsigned long long>(fused[static_cast<int>(Idiom::Delay)]));
+        fprintf(stdout, "Idle skipped: %llu passes\n", static_cast<unsigned long long>(emulator.code_cache.idle_passes));
+
+        if (rewinder) {
+            rewinder->flush();
+            fprintf(stdout,
+                    "Rewind:       %zu frames in %zu KB\n",
+                    rewinder->frames(),
+                    rewinder->bytes_used() >> 10);
+        }
+
+        if (!emulator.cpu.is_enabled()) {
+            fprintf(stderr, "CPU stopped at %04X\n", emulator.cpu.pc);
+        }
+    }
+    catch (const std::runtime_error& e) {
+        fprintf(stderr, "Caught exception: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -9,11 +9,7 @@
 using namespace std::literals;
 
 #include "constants.h"
-#include "cpu/cpu.h"
 #include "fs.h"
-#include "memory_map.h"
-#include "mmu.h"
-#include "ppu.h"
 #include "render/gl_rect.h"
 #include "render/gl_shader.h"
 #include "render/gl_texture.h"
@@ -30,58 +26,10 @@ using namespace std::literals;
 /* clang-format on */
 
 #include "buttons.h"
+#include "cartridge.h"
+#include "emulator.h"
 #include "render/message_queue.h"
-
-struct Rom {
-    std::filesystem::path path;
-    std::vector<u8> data;
-};
-
-struct Cartridge {
-    Rom rom;
-    Rom bios;
-};
-
-void cartridge_load_bios(Cartridge* cart, const std::filesystem::path& file_path)
-{
-    assert(std::filesystem::file_size(file_path) == 0x100);
-
-    cart->bios.path = std::filesystem::absolute(file_path);
-    cart->bios.data = FS::read_bytes(file_path.string());
-
-    fprintf(stdout, "Loaded BIOS '%s'\n", file_path.string().c_str());
-}
-
-void cartridge_load_rom(Cartridge* cart, const std::filesystem::path& file_path)
-{
-    static constexpr int kMaxRomSize {0x10000};
-
-    const auto rom_size {std::filesystem::file_size(file_path)};
-
-    if (rom_size > kMaxRomSize) {
-        throw std::runtime_error("Rom too large: " + std::to_string(rom_size) + "/" + std::to_string(kMaxRomSize));
-    }
-
-    cart->rom.path = std::filesystem::absolute(file_path);
-    cart->rom.data = FS::read_bytes(file_path.string());
-
-    fprintf(stdout, "Loaded ROM '%s'\n", file_path.string().c_str());
-}
-
-void mmu_set_cartridge(Mmu* mmu, Cartridge* cart, bool skip_bios)
-{
-    assert(cart->rom.data.size());
-    assert(cart->bios.data.size());
-
-    if (skip_bios) {
-        std::copy(cart->rom.data.begin(), cart->rom.data.end(), mmu->memory);
-    }
-    else {
-        std::copy_n(cart->rom.data.begin() + 0x100, cart->rom.data.size() - 0x100, mmu->memory + 0x100);
-        std::copy(cart->bios.data.begin(), cart->bios.data.end(), mmu->memory);
-        mmu->set_rom_start(cart->rom.data.data());
-    }
-}
+#include "rewind.h"
 
 std::string get_time_as_string()
 {
@@ -93,7 +41,7 @@ std::string get_time_as_string()
     return std::string {buffer};
 }
 
-void dump_vram(const std::string& path, u8* memory)
+void dump_vram(const std::string& path, const u8* memory)
 {
     FILE* s {fopen(path.c_str(), "wb+")};
 
@@ -105,12 +53,32 @@ void dump_vram(const std::string& path, u8* memory)
     fclose(s);
 }
 
+// The joypad buttons held down on the keyboard, as JoypadButton bits
+u8 held_joypad(Window& window)
+{
+    u8 buttons = 0;
+    for (int i = 0; i < 8; i++) {
+        if (sdl_get_action(&window, ButtonRight + i, true))
+            buttons |= 1 << i;
+    }
+    return buttons;
+}
+
 void run(Window& window)
 {
     sdl_bind(&window, SDL_SCANCODE_Q, ButtonQuit);
     sdl_bind(&window, SDL_SCANCODE_O, ButtonOpenFile);
     sdl_bind(&window, SDL_SCANCODE_BACKSPACE, ButtonCloseDialog);
     sdl_bind(&window, SDL_SCANCODE_D, ButtonDumpVRAM);
+    sdl_bind(&window, SDL_SCANCODE_R, ButtonRewind);
+    sdl_bind(&window, SDL_SCANCODE_RIGHT, ButtonRight);
+    sdl_bind(&window, SDL_SCANCODE_LEFT, ButtonLeft);
+    sdl_bind(&window, SDL_SCANCODE_UP, ButtonUp);
+    sdl_bind(&window, SDL_SCANCODE_DOWN, ButtonDown);
+    sdl_bind(&window, SDL_SCANCODE_X, ButtonA);
+    sdl_bind(&window, SDL_SCANCODE_Z, ButtonB);
+    sdl_bind(&window, SDL_SCANCODE_RSHIFT, ButtonSelect);
+    sdl_bind(&window, SDL_SCANCODE_RETURN, ButtonStart);
 
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
@@ -123,69 +91,17 @@ void run(Window& window)
     ImGui::FileBrowser file_dialog;
     file_dialog.SetTitle("Choose a ROM");
 
-    u8* mem = new u8[0x10000]();
-
-    Cpu cpu(CpuRegisters {
-        .io = mem[kIo],
-        .if_ = mem[kIf],
-        .ie = mem[kIe],
-    });
-    Ppu ppu(PpuRegisters {
-        .if_ = mem[kIf],
-        .lcdc = mem[kLcdc],
-        .stat = mem[kStat],
-        .scx = mem[kScx],
-        .scy = mem[kScy],
-        .ly = mem[kLy],
-        .lyc = mem[kLyc],
-        .wy = mem[kWy],
-        .wx = mem[kWx],
-    });
-    Mmu mmu(cpu, ppu, mem);
+    Emulator emulator;
+    Cpu& cpu = emulator.cpu;
+    Ppu& ppu = emulator.ppu;
 
     cpu.debug = false;
 
+    Rewind rewind;
+
     bool skip_bios = true;
 
-    cpu.reset(skip_bios);
-    ppu.reset(skip_bios);
-
-    if (skip_bios) {
-        // Sound
-        mmu.write8(kNr10, 0x80);
-        mmu.write8(kNr11, 0xBF);
-        mmu.write8(kNr12, 0xF3);
-        mmu.write8(kNr14, 0xBF);
-        mmu.write8(kNr21, 0x3F);
-        mmu.write8(kNr24, 0xBF);
-        mmu.write8(kNr30, 0x7F);
-        mmu.write8(kNr31, 0xFF);
-        mmu.write8(kNr32, 0x9F);
-        mmu.write8(kNr34, 0xBF);
-        mmu.write8(kNr41, 0xFF);
-        mmu.write8(kNr44, 0xBF);
-        mmu.write8(kNr50, 0x77);
-        mmu.write8(kNr51, 0xF3);
-        mmu.write8(kNr52, 0xF1);
-
-        // CPU registers
-        mmu.write8(kIo, 0xCF);
-        mmu.write8(kIf, 0xE1);
-        mmu.write8(kIe, 0x00);
-
-        // PPU registers
-        mmu.write8(kLcdc, 0x91);
-        mmu.write8(kStat, 0x00);
-        mmu.write8(kScy, 0x00);
-        mmu.write8(kScy, 0x00);
-        mmu.write8(kLy, 0x00);
-        mmu.write8(kLyc, 0x00);
-        mmu.write8(kBgPalette, 0xFC);
-        mmu.write8(kObj0Palette, 0xFF);
-        mmu.write8(kObj1Palette, 0xFF);
-        mmu.write8(kWy, 0x00);
-        mmu.write8(kWx, 0x00);
-    }
+    emulator.reset(skip_bios);
 
     Cartridge cart;
     cartridge_load_bios(&cart, {"./bios.gb"});
@@ -209,19 +125,9 @@ void run(Window& window)
 
     file_dialog.Open();
 
-    int total_instructions = 0;
-
-    // This is the base timer speed. It updates once every 16 cycles.
-    u32 timer_counter = 0;
-    u8& timer_clock = mem[kTima];
-
-    // This updates once every 256 cycles.
-    u32 divider_counter = 0;
-    u8& divider_clock = mem[kDiv];
-
     MessageQueue message_queue;
 
-    TilesWindow tiles_window(mem, ppu.bg_palette);
+    TilesWindow tiles_window(emulator.mem, ppu.bg_palette);
     MapWindow map_window(&ppu);
 
     while (true) {
@@ -248,8 +154,8 @@ void run(Window& window)
         }
 
         if (sdl_get_action(&window, ButtonDumpVRAM, false)) {
-            if (!cart.rom.data.empty()) {
-                const auto dump_path = cart.rom.path.string() + "." + get_time_as_string() + ".vram_dump";
+            if (cart.rom) {
+                const auto dump_path = cart.rom->path.string() + "." + get_time_as_string() + ".vram_dump";
                 dump_vram(dump_path, ppu.memory.data());
                 const auto msg = "Dumped VRAM to '" + dump_path + "'\n";
                 message_queue.push(msg, 4s);
@@ -264,48 +170,23 @@ void run(Window& window)
 
         message_queue.update();
 
-        if (!paused) {
+        if (!paused && sdl_get_action(&window, ButtonRewind, true)) {
+            // A frame back for every frame shown
+            if (rewind.step_back(emulator)) {
+                texture_set_pixels(&screen, ppu.get_pixels());
+            }
+        }
+        else if (!paused) {
+            emulator.mmu.set_joypad(held_joypad(window));
             bool redraw = false;
-            int cycles = 0;
+            u64 cycles = 0;
             auto cpu_start = SDL_GetTicks();
-            while (cycles < kMaxCyclesPerFrame && cpu.is_enabled() && (SDL_GetTicks() - cpu_start) < 16) {
-                int instruction_cycles = cpu.tick(mmu);
-
-                int sync_ticks = 0;
-                while (sync_ticks != instruction_cycles) {
-                    ppu.tick(redraw);
-                    sync_ticks++;
-                }
-
-                cycles += instruction_cycles;
-                total_instructions++;
-
-                divider_counter++;
-                if (divider_counter == 16) {
-                    divider_counter = 0;
-                    divider_clock++;
-                }
-                timer_counter++;
-                int divider = 1;
-                int tac = mem[kTac];
-                if (tac == 0)
-                    divider = 64;
-                else if (tac == 1)
-                    divider = 4;
-                else if (tac == 2)
-                    divider = 8;
-                else if (tac == 3)
-                    divider = 16;
-                if ((++timer_counter % divider) == 0) {
-                    timer_counter = 0;
-                    if (++timer_clock == 0) {
-                        timer_clock = mem[kTma];
-                        cpu.registers.if_ |= 0x4;
-                    }
-                }
+            while (!redraw && cycles < kMaxCyclesPerFrame && cpu.is_enabled() && (SDL_GetTicks() - cpu_start) < 16) {
+                cycles += emulator.run(kMaxCyclesPerFrame - cycles, redraw);
             }
             if (redraw) {
                 texture_set_pixels(&screen, ppu.get_pixels());
+                rewind.capture(emulator);
             }
         }
 
@@ -316,13 +197,12 @@ void run(Window& window)
             if (file_dialog.HasSelected()) {
                 auto selection = file_dialog.GetSelected();
                 if (selection.extension() == ".bin" || selection.extension() == ".gb" || selection.extension() == ".dmg") {
-                    cpu.reset(skip_bios);
-                    mmu.reset(skip_bios);
-                    ppu.reset(skip_bios);
+                    emulator.reset(skip_bios);
+                    rewind.clear();
 
                     try {
                         cartridge_load_rom(&cart, selection);
-                        mmu_set_cartridge(&mmu, &cart, skip_bios);
+                        mmu_set_cartridge(&emulator.mmu, &cart, skip_bios);
                     }
                     catch (const std::runtime_error& e) {
                         fprintf(stderr, "ROM failed to load: %s\n", e.what());
@@ -390,8 +270,6 @@ void run(Window& window)
         sdl_flip(&window);
     }
 
-    delete[] mem;
-
     rect_free(&rect);
     texture_free(&screen);
     glDeleteProgram(rect_program);
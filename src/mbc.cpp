@@ -0,0 +1,375 @@
+#include "mbc.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
+#include "constants.h"
+
+namespace {
+
+struct CartInfo {
+    MbcType type;
+    bool ram {false};
+    bool battery {false};
+    bool rtc {false};
+};
+
+const std::map<u8, CartInfo> kCartTypes {
+    {0x00, {MbcType::None}},
+    {0x01, {MbcType::Mbc1}},
+    {0x02, {MbcType::Mbc1, true}},
+    {0x03, {MbcType::Mbc1, true, true}},
+    {0x05, {MbcType::Mbc2}},
+    {0x06, {MbcType::Mbc2, false, true}},
+    {0x08, {MbcType::None, true}},
+    {0x09, {MbcType::None, true, true}},
+    {0x0F, {MbcType::Mbc3, false, true, true}},
+    {0x10, {MbcType::Mbc3, true, true, true}},
+    {0x11, {MbcType::Mbc3}},
+    {0x12, {MbcType::Mbc3, true}},
+    {0x13, {MbcType::Mbc3, true, true}},
+    {0x19, {MbcType::Mbc5}},
+    {0x1A, {MbcType::Mbc5, true}},
+    {0x1B, {MbcType::Mbc5, true, true}},
+    {0x1C, {MbcType::Mbc5}},
+    {0x1D, {MbcType::Mbc5, true}},
+    {0x1E, {MbcType::Mbc5, true, true}},
+};
+
+// Indexed by the RAM size in the header (0x149)
+constexpr std::array<u32, 6> kRamSizes {0, 0x800, 0x2000, 0x8000, 0x20000, 0x10000};
+
+constexpr u64 kCyclesPerSecond {kCpuFreq};
+constexpr u64 kCyclesPerDay {kCyclesPerSecond * 60 * 60 * 24};
+
+}    // namespace
+
+bool mbc_supported(u8 cart_type)
+{
+    return kCartTypes.count(cart_type);
+}
+
+void Rtc::sync(u64 now)
+{
+    if (!halted && now > since) {
+        cycles += now - since;
+    }
+    since = now;
+
+    // The day counter is 9 bits
+    if (cycles >= 512 * kCyclesPerDay) {
+        cycles %= 512 * kCyclesPerDay;
+        carry = true;
+    }
+}
+
+u8 Rtc::read(Register reg) const
+{
+    const u64 seconds {cycles / kCyclesPerSecond};
+    const u64 days {seconds / (60 * 60 * 24)};
+
+    switch (reg) {
+        case Seconds:
+            return seconds % 60;
+        case Minutes:
+            return seconds / 60 % 60;
+        case Hours:
+            return seconds / (60 * 60) % 24;
+        case DaysLow:
+            return days & 0xFF;
+        default:
+            return ((days >> 8) & 1) | (halted << 6) | (carry << 7);
+    }
+}
+
+void Rtc::write(Register reg, u8 value, u64 now)
+{
+    sync(now);
+
+    u64 seconds {read(Seconds)};
+    u64 minutes {read(Minutes)};
+    u64 hours {read(Hours)};
+    u64 days {cycles / kCyclesPerDay};
+    u64 subsecond {cycles % kCyclesPerSecond};
+
+    // Out of range values carry into the next field instead of counting up to
+    // the register's limit as they would on hardware.
+    switch (reg) {
+        case Seconds:
+            seconds = value & 0x3F;
+            subsecond = 0;
+            break;
+        case Minutes:
+            minutes = value & 0x3F;
+            break;
+        case Hours:
+            hours = value & 0x1F;
+            break;
+        case DaysLow:
+            days = (days & 0x100) | value;
+            break;
+        default:
+            days = (days & 0xFF) | ((value & 1) << 8);
+            halted = value & 0x40;
+            carry = value & 0x80;
+            break;
+    }
+
+    cycles = (((days * 24 + hours) * 60 + minutes) * 60 + seconds) * kCyclesPerSecond + subsecond;
+}
+
+void Rtc::latch(u64 now)
+{
+    sync(now);
+    for (int reg = Seconds; reg <= DaysHigh; reg++) {
+        latched[reg] = read(Register(reg));
+    }
+}
+
+void Mbc::load(std::shared_ptr<const RomImage> rom_image)
+{
+    image = std::move(rom_image);
+    const u8* data {image->data};
+
+    const CartInfo info {kCartTypes.count(data[0x147]) ? kCartTypes.at(data[0x147]) : CartInfo {MbcType::None}};
+
+    type = info.type;
+    battery = info.battery;
+    has_rtc = info.rtc;
+
+    rom = data;
+    rom_banks = image->size / kRomBankSize;
+
+    std::size_t ram_size {0};
+    if (type == MbcType::Mbc2) {
+        // 512 4-bit values, built in
+        ram_size = 0x200;
+    }
+    else if (info.ram && data[0x149] < kRamSizes.size()) {
+        ram_size = kRamSizes[data[0x149]];
+    }
+
+    save.reset();
+    if (ram_size <= ram_storage.size()) {
+        ram = ram_storage.first(ram_size);
+        std::fill(ram.begin(), ram.end(), 0);
+        ram_buffer.clear();
+    }
+    else {
+        ram_buffer.assign(ram_size, 0);
+        ram = ram_buffer;
+    }
+    ram_dirty.fill(true);
+
+    rtc = {};
+    reset();
+}
+
+void Mbc::share_cartridge(const Mbc& other)
+{
+    image = other.image;
+    type = other.type;
+    battery = other.battery;
+    has_rtc = other.has_rtc;
+    rom = other.rom;
+    rom_banks = other.rom_banks;
+
+    save.reset();
+    if (other.ram.size() <= ram_storage.size()) {
+        ram = ram_storage.first(other.ram.size());
+        ram_buffer.clear();
+    }
+    else {
+        ram_buffer.resize(other.ram.size());
+        ram = ram_buffer;
+    }
+
+    ram_enabled = other.ram_enabled;
+    rom_bank = other.rom_bank;
+    ram_bank = other.ram_bank;
+    mode = other.mode;
+    latch = other.latch;
+    rtc = other.rtc;
+}
+
+void Mbc::reset()
+{
+    // Cartridges without an MBC have nothing to enable RAM with
+    ram_enabled = type == MbcType::None;
+    rom_bank = 1;
+    ram_bank = 0;
+    mode = 0;
+    latch = 0xFF;
+    rtc.since = 0;
+}
+
+void Mbc::attach_save(const std::filesystem::path& path)
+{
+    if (ram.empty()) {
+        return;
+    }
+
+    save = SaveFile::open(path, ram.size());
+    ram = {save->data, save->size};
+    ram_buffer.clear();
+    ram_dirty.fill(true);
+}
+
+bool Mbc::write_control(u16 address, u8 value, u64 now)
+{
+    const bool was_enabled {ram_enabled};
+    const bool remap {write_register(address, value, now)};
+
+    // Games disable RAM once they're done saving
+    if (save && was_enabled && !ram_enabled) {
+        save->request_flush();
+    }
+    return remap;
+}
+
+bool Mbc::write_register(u16 address, u8 value, u64 now)
+{
+    switch (type) {
+        case MbcType::Mbc1:
+            if (address < 0x2000) {
+                ram_enabled = (value & 0x0F) == 0x0A;
+            }
+            else if (address < 0x4000) {
+                rom_bank = std::max(value & 0x1F, 1);
+            }
+            else if (address < 0x6000) {
+                ram_bank = value & 0x03;
+            }
+            else {
+                mode = value & 0x01;
+            }
+            return true;
+        case MbcType::Mbc2:
+            if (address >= 0x4000) {
+                return false;
+            }
+            // Address bit 8 picks the register
+            if (address & 0x100) {
+                rom_bank = std::max(value & 0x0F, 1);
+            }
+            else {
+                ram_enabled = (value & 0x0F) == 0x0A;
+            }
+            return true;
+        case MbcType::Mbc3:
+            if (address < 0x2000) {
+                ram_enabled = (value & 0x0F) == 0x0A;
+            }
+            else if (address < 0x4000) {
+                rom_bank = std::max(value & 0x7F, 1);
+            }
+            else if (address < 0x6000) {
+                ram_bank = value;
+            }
+            else {
+                // Writing 0 then 1 latches the clock
+                if (has_rtc && latch == 0x00 && value == 0x01) {
+                    rtc.latch(now);
+                }
+                latch = value;
+                return false;
+            }
+            return true;
+        case MbcType::Mbc5:
+            if (address < 0x2000) {
+                ram_enabled = value == 0x0A;
+            }
+            else if (address < 0x3000) {
+                rom_bank = (rom_bank & 0x100) | value;
+            }
+            else if (address < 0x4000) {
+                rom_bank = (rom_bank & 0xFF) | ((value & 0x01) << 8);
+            }
+            else if (address < 0x6000) {
+                ram_bank = value & 0x0F;
+            }
+            else {
+                return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+const u8* Mbc::rom_page(u8 page) const
+{
+    u32 bank {page < 0x40 ? 0u : rom_bank};
+    if (type == MbcType::Mbc1) {
+        // The 2-bit register supplies bits 5-6, and in mode 1 also moves bank 0
+        bank = page < 0x40 ? (mode ? ram_bank << 5 : 0) : (ram_bank << 5 | rom_bank);
+    }
+    return rom + (bank % rom_banks) * kRomBankSize + ((page & 0x3F) << 8);
+}
+
+u8* Mbc::ram_page(u8 page)
+{
+    if (!ram_enabled || ram.empty() || type == MbcType::Mbc2) {
+        return nullptr;
+    }
+
+    u32 bank {ram_bank};
+    if (type == MbcType::Mbc1) {
+        bank = mode ? ram_bank : 0;
+    }
+    else if (type == MbcType::Mbc3 && ram_bank > 0x03) {
+        return nullptr;
+    }
+
+    // Smaller RAMs are mirrored
+    return ram.data() + (bank * kRamBankSize + ((page - 0xA0) << 8)) % ram.size();
+}
+
+u8 Mbc::read_ram(u16 address)
+{
+    if (!ram_enabled) {
+        return 0xFF;
+    }
+    if (type == MbcType::Mbc2) {
+        return ram[address & 0x1FF] | 0xF0;
+    }
+    if (type == MbcType::Mbc3 && ram_bank >= 0x08) {
+        return has_rtc && ram_bank <= 0x0C ? rtc.latched[ram_bank - 0x08] : 0xFF;
+    }
+    if (const u8* page = ram_page(address >> 8)) {
+        return page[address & 0xFF];
+    }
+    return 0xFF;
+}
+
+void Mbc::write_ram(u16 address, u8 value, u64 now)
+{
+    if (!ram_enabled) {
+        return;
+    }
+    if (type == MbcType::Mbc2) {
+        ram[address & 0x1FF] = value & 0x0F;
+        ram_dirty[(address & 0x1FF) >> 8] = true;
+        return;
+    }
+    if (type == MbcType::Mbc3 && ram_bank >= 0x08) {
+        if (has_rtc && ram_bank <= 0x0C) {
+            rtc.write(Rtc::Register(ram_bank - 0x08), value, now);
+        }
+        return;
+    }
+    if (u8* page = ram_page(address >> 8)) {
+        page[address & 0xFF] = value;
+        mark_dirty(page);
+    }
+}
+
+void Mbc::mark_dirty(const u8* page)
+{
+    // Not a plain comparison: `page` may be anywhere
+    const std::less<const u8*> less;
+    if (page && !less(page, ram.data()) && less(page, ram.data() + ram.size())) {
+        ram_dirty[(page - ram.data()) >> 8] = true;
+    }
+}
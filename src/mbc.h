@@ -0,0 +1,125 @@
+#ifndef KORLOW_MBC_H
+#define KORLOW_MBC_H
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "emu_types.h"
+#include "rom_image.h"
+#include "save_file.h"
+
+enum class MbcType : u8 {
+    None,    // 32KB ROM, optionally 8KB RAM
+    Mbc1,
+    Mbc2,
+    Mbc3,
+    Mbc5,
+};
+
+constexpr u32 kRomBankSize {0x4000};
+constexpr u32 kRamBankSize {0x2000};
+
+// Whether the cartridge type in the header (0x147) can be emulated
+bool mbc_supported(u8 cart_type);
+
+/*
+ * MBC3 clock, kept in emulated cycles so it stays in step with the game
+ * however fast the emulator runs.
+ */
+struct Rtc {
+    enum Register : u8 { Seconds, Minutes, Hours, DaysLow, DaysHigh };
+
+    // Folds the cycles since the last sync into `cycles`
+    void sync(u64 now);
+
+    // Current value of a register, not the latched one
+    u8 read(Register reg) const;
+    void write(Register reg, u8 value, u64 now);
+
+    void latch(u64 now);
+
+    u64 cycles {0};    // Time kept, as of `since`
+    u64 since {0};
+    bool halted {false};
+    bool carry {false};    // Day counter overflowed
+    std::array<u8, 5> latched {};
+};
+
+/*
+ * Cartridge bank controller.
+ *
+ * It never copies banks around: it keeps the bank registers and says where each
+ * ROM and cart RAM page points, and the MMU swaps its page pointers after a
+ * control write (see Mmu::map_cartridge). Accesses that aren't plain memory,
+ * i.e. disabled RAM, MBC2's 4-bit RAM and the MBC3 clock, go through read_ram
+ * and write_ram.
+ */
+struct Mbc {
+    void load(std::shared_ptr<const RomImage> image);
+
+    // Moves battery-backed RAM onto the .sav file at `path`, taking its contents
+    void attach_save(const std::filesystem::path& path);
+
+    // Runs the same cartridge as `other`, in the same state, but never with its
+    // save file. RAM is left for the caller to fill.
+    void share_cartridge(const Mbc& other);
+
+    // Back to the power-on registers. Cart RAM and the clock are kept.
+    void reset();
+
+    bool loaded() const
+    {
+        return rom != nullptr;
+    }
+
+    // Handles a write to 0x0000-0x7FFF. Returns whether the page mapping may
+    // have changed.
+    bool write_control(u16 address, u8 value, u64 now);
+
+    // Backing memory of ROM page 0x00-0x7F
+    const u8* rom_page(u8 page) const;
+
+    // Backing memory of cart RAM page 0xA0-0xBF, nullptr if it has to take the
+    // slow path
+    u8* ram_page(u8 page);
+
+    u8 read_ram(u16 address);
+    void write_ram(u16 address, u8 value, u64 now);
+
+    // Marks the 256 bytes of `ram` at `page` as written, if it's in there
+    void mark_dirty(const u8* page);
+
+    MbcType type {MbcType::None};
+    bool battery {false};
+    bool has_rtc {false};
+
+    std::shared_ptr<const RomImage> image;
+    const u8* rom {nullptr};    // image->data
+    u32 rom_banks {0};
+    // In ram_storage if it's big enough, otherwise ram_buffer, or the save file
+    std::span<u8> ram;
+    std::span<u8> ram_storage;    // Provided by the owner, see State::cart_ram
+    std::vector<u8> ram_buffer;
+    std::unique_ptr<SaveFile> save;
+
+    // One per 256 bytes of `ram`, written since the last checkpoint. Fed by
+    // write_ram and, for plain stores, Mmu::sync_dirty.
+    std::array<bool, 0x200> ram_dirty {};
+
+    // Registers
+    bool ram_enabled {false};
+    u16 rom_bank {1};
+    u8 ram_bank {0};    // MBC1: the 2-bit register that's also the upper ROM bits. MBC3: 0x08+ selects the clock.
+    u8 mode {0};        // MBC1 banking mode
+    u8 latch {0xFF};    // MBC3: last write to 0x6000-0x7FFF
+
+    Rtc rtc;
+
+private:
+    bool write_register(u16 address, u8 value, u64 now);
+};
+
+#endif    // KORLOW_MBC_H
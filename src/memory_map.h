@@ -17,6 +17,8 @@ constexpr inline u16 kEchoRam = 0xE000;
 constexpr inline u16 kOam = 0xFE00;
 //
 constexpr inline u16 kIo = 0xFF00;
+constexpr inline u16 kSb = 0xFF01;
+constexpr inline u16 kSc = 0xFF02;
 constexpr inline u16 kDiv = 0xFF04;
 constexpr inline u16 kTima = 0xFF05;
 constexpr inline u16 kTma = 0xFF06;
@@ -1,90 +1,509 @@
 #include "mmu.h"
 
+#include <cstdio>
+#include <cstring>
+
+#include "cpu/block_cache.h"
 #include "memory_map.h"
+#include "ppu.h"
+#include "scheduler.h"
+#include "timer.h"
+
+// 160 M-cycles
+static constexpr u64 kDmaCycles {640};
+
+// 8 bits at 8192Hz
+static constexpr u64 kSerialCycles {4096};
 
-bool is_ppu_address(u16 address)
+// Memory pages a fork can share: everything but IO/HRAM. Echo RAM shares the
+// WRAM pages behind it.
+static bool shareable(int page)
 {
-    return (address >= kOam && address < kIo) || (address >= kTileRamUnsigned && address < kCartRam) || (address >= kDmaStartAddr && address < kZeroPage);
+    return page < (kEchoRam >> 8) || page == (kOam >> 8);
 }
 
-bool is_cpu_address(u16 address)
+static bool is_vram(int page)
 {
-    return (address == kIo) || (address == kIe);
+    return page >= (kTileRamUnsigned >> 8) && page < (kCartRam >> 8);
 }
 
-Mmu::Mmu(Component &cpu, Component &ppu, u8 *memory)
-    : cpu(cpu)
+Mmu::Mmu(Ppu &ppu, u8 *memory)
+    : memory(memory)
     , ppu(ppu)
-    , memory(memory)
 {
+    map_pages();
 }
 
 void Mmu::reset(bool skip_bios)
 {
+    unshare_all(false);
     if (memory)
         std::fill_n(memory, 0x10000, 0);
+    mbc.reset();
+    map_pages();
+    mark_all_dirty();
 }
 
-u8 Mmu::read8(u16 address)
+void Mmu::map_pages()
 {
-    return memory[address];
+    sync_dirty();
+    read_map.fill(nullptr);
+    write_map.fill(nullptr);
+
+    if (!memory)
+        return;
+
+    for (int page = 0; page < 0x100; page++) {
+        read_map[page] = memory_page(page);
+    }
+
+    // Cart RAM and WRAM have no side effects, unless they're shared
+    for (int page = kCartRam >> 8; page < kEchoRam >> 8; page++) {
+        write_map[page] = shared[page] ? nullptr : memory + (page << 8);
+    }
+
+    // Echo RAM mirrors WRAM up to OAM
+    for (int page = kEchoRam >> 8; page < kOam >> 8; page++) {
+        read_map[page] = read_map[page - 0x20];
+        write_map[page] = write_map[page - 0x20];
+    }
+
+    // ROM, VRAM, OAM and IO/HRAM writes stay on the slow path. So do IO/HRAM
+    // reads, since DIV and TIMA are computed when read.
+    read_map[0xFF] = nullptr;
+
+    ppu.read_vram_from(shared[kTileRamUnsigned >> 8] ? base->memory.data() : memory);
+    ppu.read_oam_from(shared[kOam >> 8] ? base->memory.data() : memory);
+
+    map_cartridge();
 }
 
-u16 Mmu::read16(u16 address)
+void Mmu::map_cartridge()
 {
-    return u16(read8(address + 1) << 8) + read8(address);
+    if (!memory || !mbc.loaded())
+        return;
+
+    // Before the RAM bank the bits belong to is unmapped
+    sync_dirty();
+
+    // `data` is null for pages on the slow path, `writable` too for ROM
+    const auto map = [this](int page, const u8* data, u8* writable) {
+        if (read_map[page] == data)
+            return;
+        read_map[page] = data;
+        // Otherwise a page watched for code would lose its watch
+        write_map[page] = writable;
+        if (code_cache)
+            code_cache->invalidate(page << 8);
+    };
+
+    // Each half of the window is one bank
+    const u8* const banks[2] {mbc.rom_page(0x00), mbc.rom_page(0x40)};
+    for (int page = 0; page < kTileRamUnsigned >> 8; page++) {
+        map(page, banks[page >> 6] + ((page & 0x3F) << 8), nullptr);
+    }
+    if (boot_rom) {
+        map(0, boot_rom, nullptr);
+    }
+
+    for (int page = kCartRam >> 8; page < kWram >> 8; page++) {
+        u8* ram {mbc.ram_page(page)};
+        const std::size_t index {ram ? std::size_t(ram - mbc.ram.data()) >> 8 : 0};
+        if (ram && ram_shared[index]) {
+            map(page, ram_page(index), nullptr);
+        }
+        else {
+            map(page, ram, ram);
+        }
+    }
+}
+
+const u8* Mmu::memory_page(u8 page) const
+{
+    return shared[page] ? &base->memory[page << 8] : memory + (page << 8);
 }
 
-void Mmu::write8(u16 addr, u8 value)
+const u8* Mmu::ram_page(std::size_t page) const
 {
-    if (addr == kIf) {
-        value &= 0b0001'1111;
-        cpu.write8(kIf, value);
+    return ram_shared[page] ? &base->cart_ram[page << 8] : &mbc.ram[page << 8];
+}
+
+void Mmu::freeze()
+{
+    if (!memory)
+        return;
+
+    // Nothing has been written since the last fork, so its base still holds
+    const std::size_t ram_pages {mbc.type == MbcType::Mbc2 ? 0 : mbc.ram.size() >> 8};
+    bool current {base != nullptr && ppu.pixels_shared()};
+    for (int page = 0; current && page < 0x100; page++) {
+        current = shared[page] || !shareable(page);
     }
-    else if (addr == kIo)    // P1/JOYP
-    {
-        value |= 0xCF;
+    for (std::size_t page = 0; current && page < ram_pages; page++) {
+        current = ram_shared[page];
     }
-    else if (addr == 0xFF02)    // Serial transfer control
-    {
-        value |= 0b0111'1100;
+    if (current)
+        return;
+
+    // Every page is copied once here, and from then on only by the instances
+    // that write to it
+    auto fresh {std::make_shared_for_overwrite<ForkBase>()};
+    for (int page = 0; page < 0x100; page++) {
+        if (shareable(page))
+            std::memcpy(&fresh->memory[page << 8], memory_page(page), 0x100);
+    }
+    fresh->cart_ram.resize(ram_pages << 8);
+    for (std::size_t page = 0; page < ram_pages; page++) {
+        std::memcpy(&fresh->cart_ram[page << 8], ram_page(page), 0x100);
+    }
+    std::copy(ppu.pixels.begin(), ppu.pixels.end(), fresh->pixels.begin());
+
+    base = std::move(fresh);
+    for (int page = 0; page < 0x100; page++) {
+        shared[page] = shareable(page);
     }
-    else if (addr == 0xFF50) {
-        if (rom_start) {
-            printf("Exiting Boot ROM.\n");
-            std::memcpy(memory, rom_start, 0x100);
+    ram_shared.fill(false);
+    std::fill_n(ram_shared.begin(), ram_pages, true);
+    ppu.share_pixels(base->pixels.data());
+
+    // Writes to shared pages copy them home first and invalidate them, so
+    // watching for code carries on
+    map_pages();
+}
+
+void Mmu::unshare_all(bool copy)
+{
+    if (!base)
+        return;
+
+    if (copy) {
+        for (int page = 0; page < 0x100; page++) {
+            if (shared[page])
+                std::memcpy(memory + (page << 8), &base->memory[page << 8], 0x100);
+        }
+        for (std::size_t page = 0; page < mbc.ram.size() >> 8; page++) {
+            if (ram_shared[page])
+                std::memcpy(&mbc.ram[page << 8], &base->cart_ram[page << 8], 0x100);
         }
     }
-    else if (is_ppu_address(addr)) {
-        if (addr == kDmaStartAddr) {
-            for (int i = 0; i < 0xA0; i++)
-                write8(kOam + i, read8((u16(value) << 8) + i));
+
+    ppu.unshare_pixels(copy);
+    base.reset();
+    shared.fill(false);
+    ram_shared.fill(false);
+
+    // Pages are writable again without going past the block cache
+    map_pages();
+    invalidate_code();
+}
+
+void Mmu::unshare(u8 page)
+{
+    if (!is_vram(page)) {
+        unshare_page(page);
+        if (page == kOam >> 8)
+            ppu.read_oam_from(memory);
+        return;
+    }
+    for (int vram = kTileRamUnsigned >> 8; vram < kCartRam >> 8; vram++) {
+        if (shared[vram])
+            unshare_page(vram);
+    }
+    ppu.read_vram_from(memory);
+}
+
+void Mmu::unshare_page(u8 page)
+{
+    u8* home {memory + (page << 8)};
+    std::memcpy(home, &base->memory[page << 8], 0x100);
+    shared[page] = false;
+
+    // The MBC maps the cartridge's pages, and ROM is never writable. Nor are
+    // VRAM and OAM: the PPU has to see the writes.
+    const bool rom {page < (kTileRamUnsigned >> 8)};
+    const bool cartridge {rom || (page >= (kCartRam >> 8) && page < (kWram >> 8))};
+    const bool plain {page >= (kCartRam >> 8) && page < (kEchoRam >> 8)};
+    if (!(cartridge && mbc.loaded())) {
+        read_map[page] = home;
+        write_map[page] = plain ? home : nullptr;
+    }
+
+    // Any code decoded from it has lost its watch
+    if (code_cache)
+        code_cache->invalidate(page << 8);
+
+    if (page >= (kWram >> 8) && page < (kOam - 0x2000) >> 8) {
+        read_map[page + 0x20] = home;
+        write_map[page + 0x20] = home;
+        if (code_cache)
+            code_cache->invalidate((page + 0x20) << 8);
+    }
+}
+
+void Mmu::unshare_ram(u8 page)
+{
+    u8* ram {mbc.ram_page(page)};
+    if (!ram)
+        return;
+
+    const std::size_t index {std::size_t(ram - mbc.ram.data()) >> 8};
+    if (!ram_shared[index])
+        return;
+
+    std::memcpy(ram, &base->cart_ram[index << 8], 0x100);
+    ram_shared[index] = false;
+    map_cartridge();
+}
+
+void Mmu::watch_code(u8 page)
+{
+    write_map[page] = nullptr;
+
+    // Code in WRAM can also be overwritten through echo RAM, and vice versa
+    if (page >= (kWram >> 8) && page < (kOam - 0x2000) >> 8)
+        write_map[page + 0x20] = nullptr;
+    else if (page >= (kEchoRam >> 8) && page < (kOam >> 8))
+        write_map[page - 0x20] = nullptr;
+}
+
+RomBlocks* Mmu::rom_blocks(u16 address, u32& offset) const
+{
+    const RomImage* image {mbc.image.get()};
+    const u8* page {read_map[address >> 8]};
+    if (!mbc.loaded() || !page)
+        return nullptr;
+
+    // Wraps around below the image too
+    const std::uintptr_t at {reinterpret_cast<std::uintptr_t>(page) - reinterpret_cast<std::uintptr_t>(image->data)};
+    if (at >= image->size)
+        return nullptr;
+    offset = static_cast<u32>(at) + (address & 0xFF);
+    return image->blocks.get();
+}
+
+u64 Mmu::next_change(u16 address) const
+{
+    if (timer && address == kDiv) {
+        return timer->next_div_change();
+    }
+    if (timer && address == kTima) {
+        return timer->next_tima_change();
+    }
+    if (scheduler && (address == kLy || address == kStat) && scheduler->is_scheduled(Event::Ppu)) {
+        return scheduler->deadline(Event::Ppu);
+    }
+    return kNever;
+}
+
+void Mmu::invalidate_code()
+{
+    if (code_cache)
+        code_cache->invalidate_all();
+}
+
+void Mmu::sync_dirty()
+{
+    for (int page = kEchoRam >> 8; page < kOam >> 8; page++) {
+        if (dirty[page]) {
+            dirty[page - 0x20] = true;
+            dirty[page] = false;
         }
-        else if (addr == kLy) {
-            memory[kLy] = 0;
+    }
+
+    if (!mbc.loaded())
+        return;
+
+    for (int page = kCartRam >> 8; page < kWram >> 8; page++) {
+        if (dirty[page]) {
+            // Slow path writes were marked by the MBC itself
+            mbc.mark_dirty(read_map[page]);
+            dirty[page] = false;
         }
-        else {
-            ppu.write8(addr, value);
+    }
+}
+
+void Mmu::clear_dirty()
+{
+    dirty.fill(false);
+    mbc.ram_dirty.fill(false);
+}
+
+void Mmu::mark_all_dirty()
+{
+    dirty.fill(true);
+    mbc.ram_dirty.fill(true);
+}
+
+u8 Mmu::read8_slow(u16 address)
+{
+    if (timer && (address == kDiv || address == kTima)) {
+        if (code_cache)
+            code_cache->timed_reads++;
+        return address == kDiv ? timer->div() : timer->tima();
+    }
+    if (mbc.loaded() && address >= kCartRam && address < kWram) {
+        // Disabled RAM, MBC2 RAM and the MBC3 clock
+        return mbc.read_ram(address);
+    }
+    return memory[address];
+}
+
+u16 Mmu::read16(u16 address)
+{
+    return u16(read8(address + 1) << 8) + read8(address);
+}
+
+void Mmu::write8_slow(u16 addr, u8 value)
+{
+    const u64 now {scheduler ? scheduler->now : 0};
+
+    if (addr < kTileRamUnsigned) {
+        // ROM, only the MBC listens
+        if (mbc.write_control(addr, value, now))
+            map_cartridge();
+        return;
+    }
+
+    dirty[addr >> 8] = true;
+
+    if (mbc.loaded() && addr >= kCartRam && addr < kWram) {
+        // Cart RAM that isn't plain memory, holds decoded code or is shared
+        unshare_ram(addr >> 8);
+        mbc.write_ram(addr, value, now);
+        if (code_cache)
+            code_cache->invalidate(addr);
+        return;
+    }
+
+    if (addr >= kCartRam && addr < kOam) {
+        // Cart RAM, WRAM and echo RAM pages that hold decoded code or are shared
+        const u16 wram_addr = addr >= kEchoRam ? addr - 0x2000 : addr;
+        if (shared[wram_addr >> 8])
+            unshare(wram_addr >> 8);
+        memory[wram_addr] = value;
+        if (code_cache) {
+            code_cache->invalidate(wram_addr);
+            if (wram_addr >= kWram && wram_addr < kOam - 0x2000)
+                code_cache->invalidate(wram_addr + 0x2000);
         }
+        return;
     }
-    else if (is_cpu_address(addr)) {
-        cpu.write8(addr, value);
+
+    if (addr < kIo) {
+        // VRAM, OAM
+        if (shared[addr >> 8])
+            unshare(addr >> 8);
+        ppu.write8(addr, value);
+        memory[addr] = value;
+        if (code_cache)
+            code_cache->invalidate(addr);
+        return;
     }
 
-    if (addr == kDiv) {
-        memory[kDiv] = 0;
+    write_io(addr, value);
+
+    // Only HRAM can sensibly hold code on this page
+    if (code_cache && addr >= kZeroPage)
+        code_cache->invalidate(addr);
+}
+
+void Mmu::write_io(u16 addr, u8 value)
+{
+    switch (addr) {
+        case kIo:    // P1/JOYP
+            value = p1(value);
+            break;
+        case kSc:    // Serial transfer control
+            value |= 0b0111'1100;
+            // Transfer start with internal clock. Nothing is connected, so it just completes.
+            if ((value & 0x81) == 0x81 && scheduler) {
+                scheduler->schedule_in(Event::Serial, kSerialCycles);
+            }
+            break;
+        case kDiv:
+            memory[kDiv] = 0;
+            if (timer) {
+                timer->div_written();
+            }
+            return;
+        case kTima:
+            if (timer) {
+                timer->tima_written(value);
+                return;
+            }
+            break;
+        case kTac:
+            if (timer) {
+                timer->tac_written(value);
+                return;
+            }
+            break;
+        case kIf:
+            value &= 0b0001'1111;
+            break;
+        case kDmaStartAddr:
+            dma_source = value;
+            if (scheduler) {
+                scheduler->schedule_in(Event::Dma, kDmaCycles);
+            }
+            else {
+                dma_complete();
+            }
+            break;
+        case kExitBootRomReg:
+            if (boot_rom) {
+                printf("Exiting Boot ROM.\n");
+                boot_rom = nullptr;
+                map_cartridge();
+            }
+            break;
+        default:
+            // Palettes
+            if (addr > kDmaStartAddr && addr < kZeroPage) {
+                ppu.write8(addr, value);
+            }
+            break;
     }
 
     memory[addr] = value;
 }
 
+void Mmu::set_joypad(u8 buttons)
+{
+    joypad = buttons;
+
+    const u8 before {memory[kIo]};
+    memory[kIo] = p1(before);
+    dirty[kIo >> 8] = true;
+    if (before & ~memory[kIo] & 0x0F)
+        memory[kIf] |= 0x10;
+}
+
+u8 Mmu::p1(u8 select) const
+{
+    u8 lines {0};
+    if (!(select & 0x10))
+        lines |= joypad & 0x0F;
+    if (!(select & 0x20))
+        lines |= joypad >> 4;
+    return 0xC0 | (select & 0x30) | (~lines & 0x0F);
+}
+
 void Mmu::write16(u16 address, u16 value)
 {
     write8(address, static_cast<u8>(value));
     write8(address + 1, (value & 0xFF00) >> 8);
 }
 
-void Mmu::set_rom_start(u8 *data)
+void Mmu::dma_complete()
+{
+    for (int i = 0; i < 0xA0; i++)
+        write8(kOam + i, read8((u16(dma_source) << 8) + i));
+}
+
+void Mmu::serial_complete()
 {
-    rom_start = data;
+    memory[kSb] = 0xFF;
+    memory[kSc] &= 0x7F;
+    memory[kIf] |= 0x8;
 }
@@ -1,30 +1,175 @@
 #ifndef MMU_H
 #define MMU_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
-#include "component.h"
+#include "constants.h"
+#include "emu_types.h"
+#include "mbc.h"
 
-struct Mmu : Component {
-    Mmu(Component& cpu, Component& ppu, u8* memory);
+struct BlockCache;
+struct RomBlocks;
+struct Ppu;
+struct Scheduler;
+struct Timer;
 
-    void reset(bool) override;
-    u8 read8(u16 address) override;
-    u16 read16(u16 address) override;
-    void write8(u16 address, u8 value) override;
-    void write16(u16 address, u16 value) override;
+// Bits of Mmu::joypad, set while the button is held
+enum JoypadButton : u8 {
+    JoypadRight = 1 << 0,
+    JoypadLeft = 1 << 1,
+    JoypadUp = 1 << 2,
+    JoypadDown = 1 << 3,
+    JoypadA = 1 << 4,
+    JoypadB = 1 << 5,
+    JoypadSelect = 1 << 6,
+    JoypadStart = 1 << 7,
+};
+
+// Memory, cart RAM and the frame as they were at a fork, read by every
+// instance forked from that point until it writes to the page
+struct ForkBase {
+    std::array<u8, 0x10000> memory;
+    std::vector<u8> cart_ram;
+    std::array<u8, kLcdWidth * kLcdHeight> pixels;
+};
+
+struct Mmu {
+    Mmu(Ppu& ppu, u8* memory);
+
+    Mmu(const Mmu&) = delete;
+
+    void reset(bool);
+    u16 read16(u16 address);
+    void write16(u16 address, u16 value);
+
+    u8 read8(u16 address)
+    {
+        if (const u8* page = read_map[address >> 8])
+            return page[address & 0xFF];
+        return read8_slow(address);
+    }
+
+    void write8(u16 address, u8 value)
+    {
+        if (u8* page = write_map[address >> 8]) {
+            page[address & 0xFF] = value;
+            dirty[address >> 8] = true;
+            return;
+        }
+        write8_slow(address, value);
+    }
+
+    // Points every page at its backing memory. nullptr pages take the slow path.
+    void map_pages();
+
+    // Moves writes to a page holding decoded code onto the slow path, so they
+    // invalidate the block cache.
+    void watch_code(u8 page);
+
+    // Points the ROM and cart RAM pages at the banks the MBC has selected, and
+    // invalidates the pages that moved. Called after every MBC control write.
+    void map_cartridge();
+
+    // The cartridge's shared code, and where in its ROM image `address` reads
+    // from. nullptr if it doesn't read from the image, e.g. while the boot ROM
+    // covers it. See BlockCache.
+    RomBlocks* rom_blocks(u16 address, u32& offset) const;
+
+    // For when memory is replaced wholesale, e.g. loading a cartridge
+    void invalidate_code();
+
+    // Cycle the register at `address` can next change at if the CPU doesn't
+    // write it: DIV and TIMA count with the cycle counter, LY and STAT change
+    // with the PPU's line event. Anything else only changes in an event, which
+    // ends the CPU's slice anyway, so kNever.
+    u64 next_change(u16 address) const;
+
+    // Moves the dirty bits of echo RAM onto WRAM and those of cart RAM onto the
+    // bank it maps (Mbc::ram_dirty), so `dirty` covers `memory` only
+    void sync_dirty();
+
+    // Starts a checkpoint, see Emulator::save_delta
+    void clear_dirty();
+    void mark_all_dirty();
 
-    void set_rom_start(u8* data);
+    // Freezes memory and cart RAM into a new fork base unless nothing has been
+    // written since the last one, and shares every page of it. See
+    // Emulator::fork.
+    void freeze();
+
+    // Brings every shared page home. `copy` is false when the caller is about
+    // to overwrite them all anyway.
+    void unshare_all(bool copy = true);
+
+    // Brings a shared page home, or all of VRAM for a VRAM page: the PPU reads
+    // it as one
+    void unshare(u8 page);
+
+    // The page of memory or cart RAM (Mbc::ram) as it reads, from the fork
+    // base while it's shared
+    const u8* memory_page(u8 page) const;
+    const u8* ram_page(std::size_t page) const;
+
+    // Holds down `buttons` (JoypadButton bits) and lets go of the rest. P1
+    // (FF00) shows them on the lines the game selects, and pressing one that
+    // shows requests the joypad interrupt.
+    void set_joypad(u8 buttons);
+
+    // Scheduler event handlers
+    void dma_complete();
+    void serial_complete();
 
     u8* memory {nullptr};
-    u8* rom_start {nullptr};
+
+    // Mapped over the first page of ROM until it's unmapped through FF50
+    const u8* boot_rom {nullptr};
+    const u8* bios {nullptr};
+
+    // Without a ROM loaded, the ROM and cart RAM pages map to `memory`
+    Mbc mbc;
+
+    // Optional; without them DMA completes immediately and the timer isn't notified.
+    Scheduler* scheduler {nullptr};
+    Timer* timer {nullptr};
+    BlockCache* code_cache {nullptr};
+
+    u8 dma_source {0};
+    u8 joypad {0};
+
+    // One entry per 256-byte page
+    std::array<const u8*, 0x100> read_map {};
+    std::array<u8*, 0x100> write_map {};
+
+    // Pages written since the last checkpoint. Writes the MMU doesn't see, i.e.
+    // the PPU's and timer's registers, are all on page 0xFF.
+    std::array<bool, 0x100> dirty {};
+
+    // Pages still read from the fork base rather than `memory` or Mbc::ram.
+    // Their write_map entries are null, and the first write copies the page
+    // home. The PPU reads VRAM and OAM from wherever they are, see
+    // Ppu::read_vram_from. IO/HRAM is never shared: the CPU, PPU and timer
+    // access its registers directly.
+    std::shared_ptr<const ForkBase> base;
+    std::array<bool, 0x100> shared {};
+    std::array<bool, 0x200> ram_shared {};
 
 private:
-    Component& cpu;
-    Component& ppu;
+    void unshare_page(u8 page);
+    void unshare_ram(u8 page);
+
+    u8 read8_slow(u16 address);
+    void write8_slow(u16 address, u8 value);
+    void write_io(u16 address, u8 value);
+
+    // P1 with `select`'s lines low
+    u8 p1(u8 select) const;
+
+    Ppu& ppu;
 };
 
 #endif    // MMU_H
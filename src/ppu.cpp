@@ -1,6 +1,7 @@
 #include "ppu.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "constants.h"
 #include "memory_map.h"
@@ -16,13 +17,14 @@ u8 decodePixel(u16 row, int pixelIdx)
     return paletteIdx;
 }
 
-Ppu::Ppu(PpuRegisters registers)
+Ppu::Ppu(PpuRegisters registers, u8* memory, u8* pixels)
     : registers(registers)
-    , memory(0x2000)
-    , oam(0x100)
-    , pixels(kLcdWidth * kLcdHeight)
+    , pixels(pixels, kLcdWidth * kLcdHeight)
+    , home(memory)
+    , home_pixels(pixels)
 {
-    reset(true);
+    read_vram_from(memory);
+    read_oam_from(memory);
 }
 
 const u8* Ppu::get_pixels() const
@@ -30,7 +32,7 @@ const u8* Ppu::get_pixels() const
     return pixels.data();
 }
 
-std::array<u8, 8> get_row_colors(u8* row, u8* palette)
+std::array<u8, 8> get_row_colors(const u8* row, const u8* palette)
 {
     std::array<u8, 8> arr {0};
     for (int i = 0; i < 8; i++) {
@@ -51,16 +53,20 @@ void Ppu::draw_scanline(int line)
         return;
     }
 
+    if (pixels_shared()) {
+        unshare_pixels();
+    }
+
     bool is_signed = true;
 
-    u8* tiles = signedTiles;
+    const u8* tiles = signedTiles;
 
     if (registers.lcdc & 0x10) {
         tiles = unsignedTiles;
         is_signed = false;
     }
 
-    u8* bg_map = registers.lcdc & 0x8 ? map1 : map0;
+    const u8* bg_map = registers.lcdc & 0x8 ? map1 : map0;
 
     int y_abs = line + registers.scy;
     int y_map = y_abs / 8;
@@ -93,7 +99,7 @@ void Ppu::draw_scanline(int line)
     }
 
     if (registers.lcdc & 0x20) {
-        u8* windowMap = registers.lcdc & 0x40 ? map1 : map0;
+        const u8* windowMap = registers.lcdc & 0x40 ? map1 : map0;
 
         // window
         for (int x = 0; x < kLcdWidth; x++) {
@@ -135,33 +141,61 @@ void Ppu::draw_scanline(int line)
 
 void Ppu::set_pixel(int x, int y, u8 colour)
 {
-    pixels[(y * kLcdWidth + x) % (kLcdWidth * kLcdHeight)] = colour;
+    home_pixels[(y * kLcdWidth + x) % (kLcdWidth * kLcdHeight)] = colour;
+}
+
+void Ppu::read_vram_from(const u8* from)
+{
+    memory = {from + kTileRamUnsigned, 0x2000};
+    unsignedTiles = &memory[0];
+    signedTiles = &memory[0x1000];
+    map0 = &memory[0x1800];
+    map1 = &memory[0x1C00];
+}
+
+void Ppu::read_oam_from(const u8* from)
+{
+    oam = {from + kOam, 0x100};
+}
+
+void Ppu::share_pixels(const u8* frame)
+{
+    pixels = {frame, pixels.size()};
+}
+
+void Ppu::unshare_pixels(bool copy)
+{
+    if (copy && pixels_shared()) {
+        std::copy(pixels.begin(), pixels.end(), home_pixels);
+    }
+    pixels = {home_pixels, pixels.size()};
 }
 
 void Ppu::reset(bool)
 {
-    std::fill(std::begin(memory), std::end(memory), 0x00);
-    std::fill(std::begin(oam), std::end(oam), 0x00);
-    std::fill(std::begin(pixels), std::end(pixels), 0x00);
+    read_vram_from(home);
+    read_oam_from(home);
+    unshare_pixels(false);
+    std::fill_n(home + kTileRamUnsigned, 0x2000, 0x00);
+    std::fill_n(home + kOam, 0x100, 0x00);
+    std::fill(home_pixels, home_pixels + pixels.size(), 0x00);
+    sprites = {};
     std::memset(bg_palette, 0, 4);
     std::memset(sprite_palette, 0, 8);
     sprites_dirty = false;
     mode = MODE_OAM;
     mode_counter = 0;
-    unsignedTiles = &memory[0];
-    signedTiles = &memory[0x1000];
-    map0 = &memory[0x1800];
-    map1 = &memory[0x1C00];
+    line = 0;
 }
 
 void Ppu::write8(u16 address, u8 value)
 {
     if (address >= kTileRamUnsigned && address < kCartRam) {
-        memory[address - kTileRamUnsigned] = value;
+        home[address] = value;
         return;
     }
     else if (address >= kOam && address < kIo) {
-        oam[address - kOam] = value;
+        home[address] = value;
         return;
     }
 
@@ -202,34 +236,25 @@ void Ppu::write8(u16 address, u8 value)
     }
 }
 
-static constexpr int kCyclesPerLine = 456;
-static constexpr int kLinesPerVblank = 10;
-static constexpr int kMaxLines = kLcdHeight + kLinesPerVblank;
-static constexpr int kCyclesPerVblank = kCyclesPerLine * kMaxLines;
-
-void Ppu::tick(bool& redraw)
+void Ppu::step_line(bool& redraw)
 {
-    int frame_progress = cycles % kCyclesPerVblank;
-    int line = frame_progress / kCyclesPerLine;
-
     registers.ly = line;
 
-    if ((registers.lcdc & 0x80) && line != prev_line && line == registers.lyc && (registers.stat & 0x40)) {
+    if ((registers.lcdc & 0x80) && line == registers.lyc && (registers.stat & 0x40)) {
         registers.if_ |= 0x2;
         registers.stat |= 0x4;
     }
 
-    if ((registers.lcdc & 0x80) && line != prev_line && (registers.lcdc & 0x80)) {
+    if (registers.lcdc & 0x80) {
         draw_scanline(line);
     }
 
-    if (line == 144 && prev_line == 143) {
+    if (line == kLcdHeight) {
         redraw = true;
         registers.if_ |= 0x1;
     }
 
-    prev_line = line;
-    cycles += 4;
+    line = (line + 1) % kLinesPerFrame;
 }
 
 void Ppu::refresh()
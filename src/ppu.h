@@ -3,9 +3,9 @@
 
 #include <array>
 #include <cstdint>
-#include <vector>
+#include <span>
 
-#include "component.h"
+#include "emu_types.h"
 
 struct sprite_t {
     u8 y;
@@ -33,14 +33,21 @@ struct PpuRegisters {
     u8& wx;
 };
 
-struct Ppu : Component {
-    Ppu(PpuRegisters);
+struct Ppu {
+    // `memory` is the 64KB address space, VRAM and OAM are its regions. `pixels`
+    // holds kLcdWidth * kLcdHeight shades. See State. Neither is touched until
+    // reset().
+    Ppu(PpuRegisters, u8* memory, u8* pixels);
+
+    Ppu(const Ppu&) = delete;
 
     void refresh();
     const u8* get_pixels() const;
-    void reset(bool) override;
-    void write8(u16 address, u8 value) override;
-    void tick(bool& redraw);
+    void reset(bool);
+    void write8(u16 address, u8 value);
+
+    // Handles the start of the next scanline. Called every kCyclesPerLine cycles.
+    void step_line(bool& redraw);
 
     void set_pixel(int x, int y, u8 colour);
     void draw_sprite(const sprite_t& sprite)
@@ -48,7 +55,21 @@ struct Ppu : Component {
     }
     void draw_scanline(int line);
 
-    std::array<sprite_t, 40> sprites;
+    // Reads VRAM or OAM from `memory`, a 64KB address space: its own, or a fork
+    // base's until they're written (see Mmu::freeze). Writes go to its own.
+    void read_vram_from(const u8* memory);
+    void read_oam_from(const u8* memory);
+
+    // Reads the frame from a fork base's copy until the next line is drawn,
+    // which copies it home first
+    void share_pixels(const u8* frame);
+    void unshare_pixels(bool copy = true);
+    bool pixels_shared() const
+    {
+        return pixels.data() != home_pixels;
+    }
+
+    std::array<sprite_t, 40> sprites {};
     bool sprites_dirty {false};
 
     PpuRegisters registers;
@@ -56,21 +77,26 @@ struct Ppu : Component {
     int mode {MODE_OAM};
     int mode_counter {0};
 
-    u8 bg_palette[4];
-    u8 sprite_palette[2][4];
+    u8 bg_palette[4] {};
+    u8 sprite_palette[2][4] {};
+
+    // VRAM, OAM and the frame as they read, see read_vram_from()
+    std::span<const u8> memory;
+    std::span<const u8> oam;
 
-    std::vector<u8> memory;
-    std::vector<u8> oam;
+    const u8* unsignedTiles {nullptr};
+    const u8* signedTiles {nullptr};
+    const u8* map0 {nullptr};
+    const u8* map1 {nullptr};
 
-    u8* unsignedTiles {nullptr};
-    u8* signedTiles {nullptr};
-    u8* map0 {nullptr};
-    u8* map1 {nullptr};
+    std::span<const u8> pixels;
 
-    std::vector<u8> pixels;
+    int line {0};
 
-    int cycles {0};
-    int prev_line {-1};
+private:
+    // The address space and frame the PPU was constructed with
+    u8* home {nullptr};
+    u8* home_pixels {nullptr};
 };
 
 #endif    // GPU_H
@@ -0,0 +1,302 @@
+#include "rewind.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "emulator.h"
+
+namespace {
+
+// Runs of zeros and runs of other bytes, each pair as [zeros][literals] and
+// then the literals. XORed frames are mostly zeros.
+template <typename Byte>
+void encode(std::size_t size, Byte byte, std::vector<u8>& out)
+{
+    std::size_t i {0};
+    while (i < size) {
+        u8 zeros {0};
+        while (i < size && zeros < 0xFF && byte(i) == 0) {
+            zeros++;
+            i++;
+        }
+        out.push_back(zeros);
+
+        const std::size_t count_at {out.size()};
+        out.push_back(0);
+        u8 literals {0};
+        while (i < size && literals < 0xFF && byte(i) != 0) {
+            out.push_back(byte(i));
+            literals++;
+            i++;
+        }
+        out[count_at] = literals;
+    }
+}
+
+// Encodes `data` XOR `shadow`, then brings `shadow` up to `data`
+void encode_xor(const u8* data, u8* shadow, std::size_t size, std::vector<u8>& out)
+{
+    encode(size, [&](std::size_t i) { return u8(data[i] ^ shadow[i]); }, out);
+    std::memcpy(shadow, data, size);
+}
+
+// XORs the decoded bytes into `to`, or copies them over it. Returns the end of
+// the input.
+const u8* decode(const u8* in, u8* to, std::size_t size, bool xor_into)
+{
+    std::size_t i {0};
+    while (i < size) {
+        const u8 zeros {*in++};
+        const u8 literals {*in++};
+        if (!xor_into) {
+            std::fill_n(to + i, zeros, 0);
+        }
+        i += zeros;
+        for (int n = 0; n < literals; n++, i++) {
+            to[i] = xor_into ? to[i] ^ *in++ : *in++;
+        }
+    }
+    return in;
+}
+
+template <typename T>
+void append(std::vector<u8>& out, const T& value)
+{
+    const u8* bytes {reinterpret_cast<const u8*>(&value)};
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+template <typename T>
+const u8* read(const u8* in, T& value)
+{
+    std::memcpy(&value, in, sizeof(value));
+    return in + sizeof(value);
+}
+
+u8* state_page(State& state, u16 page)
+{
+    if (page < StateDelta::kCartRamPages) {
+        return &state.memory[page << 8];
+    }
+    return &state.cart_ram[(page - StateDelta::kCartRamPages) << 8];
+}
+
+}    // namespace
+
+Rewind::Rewind(std::size_t budget, int keyframe_interval)
+    : budget(budget)
+    , keyframe_interval(keyframe_interval)
+    , since_keyframe(keyframe_interval)
+    , ring(new u8[budget])    // Left uninitialized, so only the pages used are committed
+    , shadow(std::make_unique<State>())
+{
+    for (Capture& capture : queue.slots) {
+        capture.state = std::make_unique<State>();
+    }
+    worker = std::thread(&Rewind::run, this);
+}
+
+Rewind::~Rewind()
+{
+    Capture* capture {nullptr};
+    while (!(capture = queue.back())) {
+        queue.wait_empty();
+    }
+    capture->kind = Kind::Stop;
+    queue.push();
+    worker.join();
+}
+
+void Rewind::capture(Emulator& emulator)
+{
+    Capture* capture {queue.back()};
+    if (!capture) {
+        return;
+    }
+
+    if (since_keyframe >= keyframe_interval) {
+        capture->kind = Kind::Keyframe;
+        emulator.save_state(*capture->state);
+        since_keyframe = 0;
+    }
+    else {
+        capture->kind = Kind::Delta;
+        emulator.save_delta(capture->delta);
+        std::memcpy(capture->frame.data(), emulator.ppu.get_pixels(), capture->frame.size());
+    }
+    since_keyframe++;
+
+    queue.push();
+}
+
+bool Rewind::step_back(Emulator& emulator)
+{
+    flush();
+    if (records.size() < 2) {
+        return false;
+    }
+
+    const Record newest {records.back()};
+    records.pop_back();
+    used -= newest.size;
+
+    if (newest.keyframe) {
+        // Nothing to undo, so rebuild the frame before from its own keyframe
+        const auto keyframe {std::find_if(records.rbegin(), records.rend(), [](const Record& r) { return r.keyframe; })};
+        decode_keyframe(*keyframe);
+        for (auto it = keyframe.base(); it != records.end(); ++it) {
+            apply_delta(*it);
+        }
+    }
+    else {
+        // XORing the delta in again undoes it
+        apply_delta(newest);
+    }
+
+    const auto keyframe {std::find_if(records.rbegin(), records.rend(), [](const Record& r) { return r.keyframe; })};
+    since_keyframe = static_cast<int>(keyframe - records.rbegin()) + 1;
+    update_counts();
+
+    emulator.load_state(*shadow);
+    return true;
+}
+
+void Rewind::clear()
+{
+    flush();
+    records.clear();
+    used = 0;
+    broken = true;
+    since_keyframe = keyframe_interval;
+    update_counts();
+}
+
+void Rewind::flush()
+{
+    queue.wait_empty();
+}
+
+void Rewind::run()
+{
+    while (true) {
+        const Capture& capture {queue.front()};
+        if (capture.kind == Kind::Stop) {
+            queue.pop();
+            return;
+        }
+        store(capture);
+        queue.pop();
+    }
+}
+
+void Rewind::store(const Capture& capture)
+{
+    encoded.clear();
+
+    if (capture.kind == Kind::Keyframe) {
+        const State& state {*capture.state};
+        const u32 size {state.header.size};
+        const u8* bytes {reinterpret_cast<const u8*>(&state)};
+
+        append(encoded, size);
+        encode(size, [bytes](std::size_t i) { return bytes[i]; }, encoded);
+        std::memcpy(shadow.get(), &state, size);
+        broken = false;
+    }
+    else {
+        if (broken) {
+            return;
+        }
+        const StateDelta& delta {capture.delta};
+
+        append(encoded, static_cast<u16>(delta.pages.size()));
+        for (const u16 page : delta.pages) {
+            append(encoded, page);
+        }
+
+        StateRegisters& registers {*shadow};
+        encode_xor(reinterpret_cast<const u8*>(&delta.registers),
+                   reinterpret_cast<u8*>(&registers),
+                   sizeof(registers),
+                   encoded);
+        for (std::size_t i = 0; i < delta.pages.size(); i++) {
+            encode_xor(&delta.data[i << 8], state_page(*shadow, delta.pages[i]), 0x100, encoded);
+        }
+        encode_xor(capture.frame.data(), shadow->pixels.data(), shadow->pixels.size(), encoded);
+    }
+
+    const bool keyframe {capture.kind == Kind::Keyframe};
+    u8* to {allocate(encoded.size())};
+    if (!to || (!keyframe && records.empty())) {
+        // Its keyframe had to go
+        broken = true;
+        update_counts();
+        return;
+    }
+
+    std::memcpy(to, encoded.data(), encoded.size());
+    records.push_back({static_cast<std::size_t>(to - ring.get()), encoded.size(), keyframe});
+    used += encoded.size();
+    update_counts();
+}
+
+u8* Rewind::allocate(std::size_t size)
+{
+    if (size > budget) {
+        records.clear();
+        used = 0;
+        return nullptr;
+    }
+
+    std::size_t offset {records.empty() ? 0 : records.back().offset + records.back().size};
+    if (offset + size > budget) {
+        // Wrap around, once the records between here and the end are gone
+        while (!records.empty() && records.front().offset >= offset) {
+            evict_oldest();
+        }
+        offset = 0;
+    }
+    while (!records.empty() && records.front().offset >= offset && records.front().offset < offset + size) {
+        evict_oldest();
+    }
+    return ring.get() + offset;
+}
+
+void Rewind::evict_oldest()
+{
+    // Deltas are no use without the keyframe before them
+    do {
+        used -= records.front().size;
+        records.pop_front();
+    } while (!records.empty() && !records.front().keyframe);
+}
+
+void Rewind::decode_keyframe(const Record& record)
+{
+    u32 size {0};
+    const u8* in {read(ring.get() + record.offset, size)};
+    decode(in, reinterpret_cast<u8*>(shadow.get()), size, false);
+}
+
+void Rewind::apply_delta(const Record& record)
+{
+    u16 count {0};
+    const u8* in {read(ring.get() + record.offset, count)};
+    const u8* pages {in};
+    in += count * sizeof(u16);
+
+    StateRegisters& registers {*shadow};
+    in = decode(in, reinterpret_cast<u8*>(&registers), sizeof(registers), true);
+    for (int i = 0; i < count; i++) {
+        u16 page {0};
+        read(pages + i * sizeof(u16), page);
+        in = decode(in, state_page(*shadow, page), 0x100, true);
+    }
+    decode(in, shadow->pixels.data(), shadow->pixels.size(), true);
+}
+
+void Rewind::update_counts()
+{
+    frame_count.store(records.size(), std::memory_order_relaxed);
+    byte_count.store(used, std::memory_order_relaxed);
+}
@@ -0,0 +1,112 @@
+#ifndef KORLOW_REWIND_H
+#define KORLOW_REWIND_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "constants.h"
+#include "emu_types.h"
+#include "spsc_queue.h"
+#include "state.h"
+
+struct Emulator;
+
+/*
+ * The last few minutes of frames, to step back through.
+ *
+ * Every keyframe_interval frames a full state is kept, and a delta in between:
+ * the pages written that frame (see Emulator::save_delta) and the frame itself,
+ * XORed with the frame before and run-length encoded, which leaves a few
+ * hundred bytes. Stepping back XORs the newest delta out again.
+ *
+ * capture() only copies the frame's changes into a queue slot; the compression
+ * happens on a worker thread. Records go into a ring of `budget` bytes, and the
+ * oldest keyframe and its deltas make room when it's full.
+ */
+struct Rewind {
+    static constexpr std::size_t kDefaultBudget {64 << 20};
+    static constexpr int kDefaultKeyframeInterval {60};
+
+    explicit Rewind(std::size_t budget = kDefaultBudget, int keyframe_interval = kDefaultKeyframeInterval);
+
+    Rewind(const Rewind&) = delete;
+    ~Rewind();
+
+    // Call once a frame on the emulator thread. When the worker is behind the
+    // frame is skipped, and its pages carry over into the next delta.
+    void capture(Emulator& emulator);
+
+    // Restores the frame captured before the newest one, and forgets the
+    // newest. False when there's nothing older.
+    bool step_back(Emulator& emulator);
+
+    // Forgets every frame, e.g. when another ROM is loaded
+    void clear();
+
+    // Waits for the worker to store every frame captured so far
+    void flush();
+
+    // Kept, and the bytes they take in the ring
+    std::size_t frames() const
+    {
+        return frame_count.load(std::memory_order_relaxed);
+    }
+    std::size_t bytes_used() const
+    {
+        return byte_count.load(std::memory_order_relaxed);
+    }
+
+    const std::size_t budget;
+    const int keyframe_interval;
+
+private:
+    enum class Kind : u8 { Keyframe, Delta, Stop };
+
+    struct Capture {
+        Kind kind {Kind::Stop};
+        std::unique_ptr<State> state;    // Keyframes
+        StateDelta delta;
+        std::array<u8, kLcdWidth * kLcdHeight> frame;
+    };
+
+    struct Record {
+        std::size_t offset;
+        std::size_t size;
+        bool keyframe;
+    };
+
+    void run();
+    void store(const Capture& capture);
+
+    // The ring space for `size` more bytes, making room as needed
+    u8* allocate(std::size_t size);
+    void evict_oldest();
+
+    // Onto `shadow`. Applying a delta twice undoes it.
+    void decode_keyframe(const Record& record);
+    void apply_delta(const Record& record);
+    void update_counts();
+
+    SpscQueue<Capture, 8> queue;
+    int since_keyframe;
+
+    // Only the worker touches these while the queue isn't empty
+    std::unique_ptr<u8[]> ring;
+    std::deque<Record> records;
+    std::size_t used {0};
+    std::unique_ptr<State> shadow;    // The newest frame kept
+    std::vector<u8> encoded;
+    bool broken {true};               // Deltas have no keyframe to go on
+
+    std::atomic<std::size_t> frame_count {0};
+    std::atomic<std::size_t> byte_count {0};
+
+    std::thread worker;
+};
+
+#endif    // KORLOW_REWIND_H
@@ -0,0 +1,134 @@
+#include "rom_image.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <system_error>
+
+#include "cpu/rom_blocks.h"
+#include "fs.h"
+#include "mbc.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define KORLOW_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Images by canonical path. They remove themselves when the last user lets go.
+struct Registry {
+    std::mutex mutex;
+    std::map<std::filesystem::path, std::weak_ptr<const RomImage>> images;
+};
+
+Registry& registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+std::size_t padded_size(std::size_t size)
+{
+    return std::max<std::size_t>(2, (size + kRomBankSize - 1) / kRomBankSize) * kRomBankSize;
+}
+
+}    // namespace
+
+std::shared_ptr<const RomImage> RomImage::open(const std::filesystem::path& file_path)
+{
+    const auto path {std::filesystem::canonical(file_path)};
+
+    Registry& shared {registry()};
+    std::lock_guard lock {shared.mutex};
+
+    if (const auto it {shared.images.find(path)}; it != shared.images.end()) {
+        if (auto image {it->second.lock()}) {
+            return image;
+        }
+    }
+
+    // Not via make_shared: the constructor is private
+    std::shared_ptr<RomImage> image {new RomImage};
+
+#ifdef KORLOW_MMAP
+    const int fd {::open(path.c_str(), O_RDONLY)};
+    if (fd < 0) {
+        throw std::system_error(errno, std::system_category(), "Failed to open " + path.string());
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::system_error(errno, std::system_category(), "Failed to stat " + path.string());
+    }
+
+    image->file_size = info.st_size;
+    image->size = padded_size(image->file_size);
+
+    // Zero pages for the padding, with the file mapped over the start
+    void* mapping {mmap(nullptr, image->size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+    if (mapping == MAP_FAILED) {
+        ::close(fd);
+        throw std::system_error(errno, std::system_category(), "Failed to map " + path.string());
+    }
+    image->mapping = mapping;
+    image->map_size = image->size;
+
+    if (image->file_size && mmap(mapping, image->file_size, PROT_READ, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        ::close(fd);
+        throw std::system_error(errno, std::system_category(), "Failed to map " + path.string());
+    }
+    ::close(fd);
+
+    image->data = static_cast<const u8*>(mapping);
+#else
+    image->bytes = FS::read_bytes(path.string());
+    image->file_size = image->bytes.size();
+    image->size = padded_size(image->file_size);
+    image->bytes.resize(image->size);
+    image->data = image->bytes.data();
+#endif
+
+    image->blocks = std::make_unique<RomBlocks>(image->size);
+
+    // Only now, so an image that failed to load doesn't touch the registry
+    image->path = path;
+    shared.images[path] = image;
+    return image;
+}
+
+std::shared_ptr<const RomImage> RomImage::from_bytes(std::vector<u8> bytes)
+{
+    std::shared_ptr<RomImage> image {new RomImage};
+    image->file_size = bytes.size();
+    image->size = padded_size(image->file_size);
+    image->bytes = std::move(bytes);
+    image->bytes.resize(image->size);
+    image->data = image->bytes.data();
+    image->blocks = std::make_unique<RomBlocks>(image->size);
+    return image;
+}
+
+RomImage::~RomImage()
+{
+    if (!path.empty()) {
+        Registry& shared {registry()};
+        std::lock_guard lock {shared.mutex};
+
+        // Unless the path was opened again in the meantime
+        const auto it {shared.images.find(path)};
+        if (it != shared.images.end() && it->second.expired()) {
+            shared.images.erase(it);
+        }
+    }
+
+#ifdef KORLOW_MMAP
+    if (mapping) {
+        munmap(mapping, map_size);
+    }
+#endif
+}
@@ -0,0 +1,50 @@
+#ifndef KORLOW_ROM_IMAGE_H
+#define KORLOW_ROM_IMAGE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "emu_types.h"
+
+struct RomBlocks;
+
+/*
+ * Read-only ROM contents, shared by every cartridge loaded from the same file.
+ *
+ * Files are mmapped rather than read, so loading is zero-copy and any number of
+ * emulator instances running the same ROM share its pages. The image is padded
+ * with zeros to whole 16KB banks, at least two, so the MBC can map any page.
+ * Since the mapping is shared, truncating the file while it's open would fault.
+ */
+struct RomImage {
+    // Maps `path`, or returns the image already mapped from it
+    static std::shared_ptr<const RomImage> open(const std::filesystem::path& path);
+
+    // An image of `bytes`, e.g. a ROM built by a test
+    static std::shared_ptr<const RomImage> from_bytes(std::vector<u8> bytes);
+
+    RomImage(const RomImage&) = delete;
+    ~RomImage();
+
+    const u8* data {nullptr};
+    std::size_t size {0};         // Padded
+    std::size_t file_size {0};    // Before padding
+
+    // Canonical, empty for images not loaded from a file
+    std::filesystem::path path;
+
+    // Code decoded from the image so far, by any instance running it
+    std::unique_ptr<RomBlocks> blocks;
+
+private:
+    RomImage() = default;
+
+    // Either a mapping of `map_size` bytes or `bytes` backs `data`
+    void* mapping {nullptr};
+    std::size_t map_size {0};
+    std::vector<u8> bytes;
+};
+
+#endif    // KORLOW_ROM_IMAGE_H
@@ -0,0 +1,109 @@
+#include "save_file.h"
+
+#include <system_error>
+
+#include "fs.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define KORLOW_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::unique_ptr<SaveFile> SaveFile::open(const std::filesystem::path& path, std::size_t size)
+{
+    // Not via make_unique: the constructor is private
+    std::unique_ptr<SaveFile> save {new SaveFile};
+    save->path = path;
+    save->size = size;
+
+#ifdef KORLOW_MMAP
+    const int fd {::open(path.c_str(), O_RDWR | O_CREAT, 0644)};
+    if (fd < 0) {
+        throw std::system_error(errno, std::system_category(), "Failed to open " + path.string());
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || (std::size_t(info.st_size) < size && ftruncate(fd, size) != 0)) {
+        const int error {errno};
+        ::close(fd);
+        throw std::system_error(error, std::system_category(), "Failed to size " + path.string());
+    }
+
+    void* mapping {mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)};
+    const int error {errno};
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::system_error(error, std::system_category(), "Failed to map " + path.string());
+    }
+
+    save->mapping = mapping;
+    save->data = static_cast<u8*>(mapping);
+#else
+    if (std::filesystem::exists(path)) {
+        save->bytes = FS::read_bytes(path.string());
+    }
+    save->bytes.resize(size);
+    save->data = save->bytes.data();
+#endif
+
+    save->thread = std::thread(&SaveFile::run, save.get());
+    return save;
+}
+
+SaveFile::~SaveFile()
+{
+    {
+        std::lock_guard lock {mutex};
+        stopping = true;
+    }
+    wake.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+
+    flush();
+
+#ifdef KORLOW_MMAP
+    if (mapping) {
+        munmap(mapping, size);
+    }
+#endif
+}
+
+void SaveFile::request_flush()
+{
+    {
+        std::lock_guard lock {mutex};
+        requested = true;
+    }
+    wake.notify_one();
+}
+
+void SaveFile::flush()
+{
+#ifdef KORLOW_MMAP
+    // The kernel knows which pages are dirty, clean ones cost nothing
+    msync(mapping, size, MS_SYNC);
+#else
+    FS::write_bytes(path.string(), data, size);
+#endif
+}
+
+void SaveFile::run()
+{
+    std::unique_lock lock {mutex};
+    while (!stopping) {
+        wake.wait_for(lock, kFlushInterval, [this] { return requested || stopping; });
+        if (stopping) {
+            break;
+        }
+        requested = false;
+
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef KORLOW_SAVE_FILE_H
+#define KORLOW_SAVE_FILE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "emu_types.h"
+
+/*
+ * Battery-backed cart RAM, mapped read-write onto a .sav file.
+ *
+ * The MMU maps its pages straight at `data`, so guest writes are plain stores.
+ * A background thread writes dirty pages back (msync) every kFlushInterval, as
+ * soon as it's asked to, and once more when the file is closed.
+ */
+struct SaveFile {
+    static constexpr std::chrono::milliseconds kFlushInterval {1000};
+
+    // Creates the file if needed. Existing contents are kept, and the file grows
+    // to `size` if it's shorter.
+    static std::unique_ptr<SaveFile> open(const std::filesystem::path& path, std::size_t size);
+
+    SaveFile(const SaveFile&) = delete;
+    ~SaveFile();
+
+    // Wakes the flush thread now, e.g. when the game disables RAM after saving
+    void request_flush();
+
+    u8* data {nullptr};
+    std::size_t size {0};
+    std::filesystem::path path;
+
+private:
+    SaveFile() = default;
+
+    void flush();
+    void run();
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool requested {false};
+    bool stopping {false};
+
+    // Without mmap, `data` points here and flushing rewrites the file
+    std::vector<u8> bytes;
+    void* mapping {nullptr};
+};
+
+#endif    // KORLOW_SAVE_FILE_H
@@ -0,0 +1,167 @@
+#ifndef KORLOW_SCHEDULER_H
+#define KORLOW_SCHEDULER_H
+
+#include <array>
+#include <limits>
+#include <utility>
+
+#include "emu_types.h"
+
+enum class Event : u8 {
+    Ppu,       // Start of the next scanline
+    Tima,      // TIMA overflow
+    Dma,       // OAM DMA transfer complete
+    Serial,    // Serial transfer complete
+    Count,
+};
+
+constexpr inline u64 kNever {std::numeric_limits<u64>::max()};
+
+/*
+ * Keeps the next deadline of every device in an indexed binary min-heap keyed
+ * on absolute cycle count. There is a fixed, small set of events and each one
+ * is scheduled at most once, so the heap lives in fixed arrays.
+ *
+ * The CPU runs uninterrupted while now < next, then the owner pops and
+ * dispatches every event that is due.
+ */
+struct Scheduler {
+    static constexpr int kEventCount {static_cast<int>(Event::Count)};
+
+    Scheduler()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        now = 0;
+        next = kNever;
+        count = 0;
+        pos.fill(-1);
+    }
+
+    bool is_scheduled(Event e) const
+    {
+        return pos[idx(e)] != -1;
+    }
+
+    // Absolute cycle at which `e` fires. Only valid if it's scheduled.
+    u64 deadline(Event e) const
+    {
+        return when[idx(e)];
+    }
+
+    void schedule(Event e, u64 at)
+    {
+        const int i {idx(e)};
+        when[i] = at;
+        if (pos[i] == -1) {
+            pos[i] = count;
+            heap[count++] = e;
+            sift_up(pos[i]);
+        }
+        else {
+            sift_up(pos[i]);
+            sift_down(pos[i]);
+        }
+        next = when[idx(heap[0])];
+    }
+
+    void schedule_in(Event e, u64 cycles)
+    {
+        schedule(e, now + cycles);
+    }
+
+    void cancel(Event e)
+    {
+        const int p {pos[idx(e)]};
+        if (p == -1) {
+            return;
+        }
+        remove_at(p);
+    }
+
+    // Removes and returns the earliest event. Only valid if next <= now.
+    Event pop()
+    {
+        const Event e {heap[0]};
+        remove_at(0);
+        return e;
+    }
+
+    u64 now {0};
+    u64 next {kNever};
+
+private:
+    static int idx(Event e)
+    {
+        return static_cast<int>(e);
+    }
+
+    u64 key(int p) const
+    {
+        return when[idx(heap[p])];
+    }
+
+    void swap(int a, int b)
+    {
+        std::swap(heap[a], heap[b]);
+        pos[idx(heap[a])] = a;
+        pos[idx(heap[b])] = b;
+    }
+
+    void sift_up(int p)
+    {
+        while (p > 0) {
+            const int parent {(p - 1) / 2};
+            if (key(parent) <= key(p)) {
+                break;
+            }
+            swap(p, parent);
+            p = parent;
+        }
+    }
+
+    void sift_down(int p)
+    {
+        for (;;) {
+            const int l {2 * p + 1};
+            const int r {l + 1};
+            int smallest {p};
+            if (l < count && key(l) < key(smallest)) {
+                smallest = l;
+            }
+            if (r < count && key(r) < key(smallest)) {
+                smallest = r;
+            }
+            if (smallest == p) {
+                break;
+            }
+            swap(p, smallest);
+            p = smallest;
+        }
+    }
+
+    void remove_at(int p)
+    {
+        pos[idx(heap[p])] = -1;
+        count--;
+        if (p != count) {
+            const Event moved {heap[count]};
+            heap[p] = moved;
+            pos[idx(moved)] = p;
+            sift_up(p);
+            sift_down(pos[idx(moved)]);
+        }
+        next = count ? key(0) : kNever;
+    }
+
+    // Ordered so there's no padding, see State
+    std::array<u64, kEventCount> when {};
+    std::array<int, kEventCount> pos {};
+    int count {0};
+    std::array<Event, kEventCount> heap {};
+};
+
+#endif    // KORLOW_SCHEDULER_H
@@ -0,0 +1,70 @@
+#ifndef KORLOW_SPSC_QUEUE_H
+#define KORLOW_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "emu_types.h"
+
+/*
+ * Lock-free queue of N slots between one producer thread and one consumer.
+ *
+ * Slots are filled and drained in place and never moved, so they can hold big
+ * preallocated buffers: the producer fills back() and push()es it, the
+ * consumer reads front() and pop()s it. Either side can block until the other
+ * has caught up; there is no lock on the way.
+ */
+template <typename T, std::size_t N>
+struct SpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+
+    // Producer: the slot to fill next, nullptr while the queue is full
+    T* back()
+    {
+        const u64 t {tail.load(std::memory_order_relaxed)};
+        if (t - head.load(std::memory_order_acquire) == N)
+            return nullptr;
+        return &slots[t % N];
+    }
+
+    // Producer: hands the slot from back() over
+    void push()
+    {
+        tail.fetch_add(1, std::memory_order_release);
+        tail.notify_one();
+    }
+
+    // Producer: blocks until the consumer has popped everything
+    void wait_empty() const
+    {
+        const u64 t {tail.load(std::memory_order_relaxed)};
+        for (u64 h {head.load(std::memory_order_acquire)}; h != t; h = head.load(std::memory_order_acquire)) {
+            head.wait(h, std::memory_order_acquire);
+        }
+    }
+
+    // Consumer: blocks until there's a slot to read
+    T& front()
+    {
+        const u64 h {head.load(std::memory_order_relaxed)};
+        tail.wait(h, std::memory_order_acquire);
+        return slots[h % N];
+    }
+
+    // Consumer: gives the slot from front() back
+    void pop()
+    {
+        head.fetch_add(1, std::memory_order_release);
+        head.notify_one();
+    }
+
+    std::array<T, N> slots {};
+
+private:
+    // Apart, so the two threads don't share a cache line
+    alignas(64) std::atomic<u64> head {0};
+    alignas(64) std::atomic<u64> tail {0};
+};
+
+#endif    // KORLOW_SPSC_QUEUE_H
@@ -0,0 +1,154 @@
+#ifndef KORLOW_STATE_H
+#define KORLOW_STATE_H
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "constants.h"
+#include "emu_types.h"
+#include "ppu.h"
+#include "scheduler.h"
+
+constexpr u32 kStateMagic {0x574C524B};    // "KRLW"
+constexpr u16 kStateVersion {2};
+
+// The sections have no implicit padding, so identical machines save identical
+// bytes and states can be compared or hashed as they are.
+
+struct StateHeader {
+    u32 magic;
+    u16 version;
+    u16 cart_checksum;    // Global checksum from the ROM header, 0 without a cartridge
+    u32 size;             // Bytes in use, see State::size()
+};
+
+struct CpuState {
+    u16 pc;
+    u16 sp;
+    u16 af;
+    u16 bc;
+    u16 de;
+    u16 hl;
+    u8 halt_bug;
+    u8 ei_bug;
+    bool halted;
+    bool enabled;
+    bool ime;
+    u8 unused[3];
+};
+
+struct PpuState {
+    int mode;
+    int mode_counter;
+    int line;
+    u8 bg_palette[4];
+    u8 sprite_palette[2][4];
+    std::array<sprite_t, 40> sprites;
+    bool sprites_dirty;
+    u8 unused[7];
+};
+
+struct TimerState {
+    u64 div_reset;
+    u64 next_increment;
+    bool running;
+    u8 unused[7];
+};
+
+struct MbcState {
+    u64 rtc_cycles;
+    u64 rtc_since;
+    u16 rom_bank;
+    bool ram_enabled;
+    u8 ram_bank;
+    u8 mode;
+    u8 latch;
+    std::array<u8, 5> rtc_latched;
+    bool rtc_halted;
+    bool rtc_carry;
+    u8 unused[3];
+};
+
+struct MmuState {
+    u8 dma_source;
+    bool boot_rom;    // Still mapped
+    u8 unused[6];
+};
+
+// The header and the components' registers, gathered on save
+struct StateRegisters {
+    StateHeader header;
+
+    CpuState cpu;
+    PpuState ppu;
+    TimerState timer;
+    Scheduler scheduler;
+    MbcState mbc;
+    MmuState mmu;
+};
+
+/*
+ * Everything that changes as a ROM runs, in one trivially copyable block.
+ *
+ * The emulator runs directly on the arrays (its `mem`, the PPU's VRAM, OAM and
+ * frame, and cart RAM without a battery), and only the handful of scalar
+ * registers are gathered into the block on save. A snapshot or a restore copies
+ * the first `header.size` bytes, in two runs: the registers, and everything
+ * from 0x8000 in `memory` on. The ROM window is left out while a cartridge is
+ * loaded, as ROM reads from its image. That's 0.5KB + 32KB + the 23KB frame +
+ * cart RAM, some 56-88KB: around 3us to save. A restore copies as much, then
+ * remaps the 256 pages and invalidates decoded code, about 1us more, and the
+ * blocks the game runs are decoded again as it reaches them.
+ */
+struct State : StateRegisters {
+    // Up to the end of cart RAM the cartridge has
+    static constexpr std::size_t size(std::size_t cart_ram_size)
+    {
+        return sizeof(State) - sizeof(State::cart_ram) + cart_ram_size;
+    }
+
+    // The start of `memory` that's only saved without a cartridge
+    static constexpr std::size_t kRomWindow {0x8000};
+
+    // The address space. VRAM and OAM are the PPU's memory.
+    alignas(64) std::array<u8, 0x10000> memory;
+    alignas(64) std::array<u8, kLcdWidth * kLcdHeight> pixels;
+
+    // Last, so only as much as the cartridge has is copied
+    alignas(64) std::array<u8, 0x20000> cart_ram;
+};
+
+static_assert(std::is_trivially_copyable_v<State>);
+static_assert(std::has_unique_object_representations_v<StateHeader>);
+static_assert(std::has_unique_object_representations_v<CpuState>);
+static_assert(std::has_unique_object_representations_v<PpuState>);
+static_assert(std::has_unique_object_representations_v<TimerState>);
+static_assert(std::has_unique_object_representations_v<Scheduler>);
+static_assert(std::has_unique_object_representations_v<MbcState>);
+static_assert(std::has_unique_object_representations_v<MmuState>);
+static_assert(std::has_unique_object_representations_v<StateRegisters>);
+static_assert(sizeof(State::cart_ram) % 64 == 0, "State::size() assumes no padding after cart_ram");
+
+/*
+ * The pages of a State written since the previous checkpoint, see
+ * Emulator::save_delta. Pages 0x000-0x0FF are `memory`, 0x100 on are cart RAM.
+ *
+ * The frame isn't in here: it's output, and the PPU redraws all of it every
+ * frame, so it would dwarf the rest.
+ */
+struct StateDelta {
+    static constexpr u16 kCartRamPages {0x100};
+
+    std::size_t size() const
+    {
+        return sizeof(registers) + pages.size() * sizeof(u16) + data.size();
+    }
+
+    StateRegisters registers;
+    std::vector<u16> pages;
+    std::vector<u8> data;    // 256 bytes per page
+};
+
+#endif    // KORLOW_STATE_H
@@ -0,0 +1,132 @@
+#include "timer.h"
+
+#include "scheduler.h"
+#include "state.h"
+
+static constexpr u32 kDivPeriod {256};
+static constexpr u32 kTimaPeriods[4] {1024, 16, 64, 256};
+
+Timer::Timer(TimerRegisters registers, Scheduler& scheduler)
+    : registers(registers)
+    , scheduler(scheduler)
+{
+}
+
+void Timer::reset()
+{
+    scheduler.cancel(Event::Tima);
+    div_reset = scheduler.now;
+    running = false;
+    tac_written(registers.tac);
+}
+
+u32 Timer::tima_period() const
+{
+    return kTimaPeriods[registers.tac & 0x3];
+}
+
+u64 Timer::next_div_change() const
+{
+    return div_reset + ((scheduler.now - div_reset) / kDivPeriod + 1) * kDivPeriod;
+}
+
+u64 Timer::next_tima_change() const
+{
+    if (!running) {
+        return kNever;
+    }
+    if (scheduler.now < next_increment) {
+        return next_increment;
+    }
+    return next_increment + ((scheduler.now - next_increment) / tima_period() + 1) * tima_period();
+}
+
+void Timer::save(TimerState& state) const
+{
+    state.div_reset = div_reset;
+    state.next_increment = next_increment;
+    state.running = running;
+}
+
+void Timer::load(const TimerState& state)
+{
+    div_reset = state.div_reset;
+    next_increment = state.next_increment;
+    running = state.running;
+}
+
+u8 Timer::div()
+{
+    registers.div = static_cast<u8>((scheduler.now - div_reset) / kDivPeriod);
+    return registers.div;
+}
+
+u8 Timer::tima()
+{
+    sync_tima();
+    return registers.tima;
+}
+
+void Timer::on_overflow(u64 at)
+{
+    registers.tima = registers.tma;
+    registers.if_ |= 0x4;
+    next_increment = at + tima_period();
+    schedule_overflow();
+}
+
+void Timer::div_written()
+{
+    // Resetting DIV also resets the internal counter TIMA is clocked from.
+    div_reset = scheduler.now;
+    registers.div = 0;
+    if (running) {
+        sync_tima();
+        next_increment = scheduler.now + tima_period();
+        schedule_overflow();
+    }
+}
+
+void Timer::tima_written(u8 value)
+{
+    sync_tima();
+    registers.tima = value;
+    if (running) {
+        schedule_overflow();
+    }
+}
+
+void Timer::tac_written(u8 value)
+{
+    // Increments so far happened at the old rate
+    sync_tima();
+    registers.tac = value;
+
+    if (!(value & 0x4)) {
+        running = false;
+        scheduler.cancel(Event::Tima);
+        return;
+    }
+    if (!running || next_increment > scheduler.now + tima_period()) {
+        next_increment = scheduler.now + tima_period();
+    }
+    running = true;
+    schedule_overflow();
+}
+
+// Applies the increments due by now. Never wraps: the CPU doesn't run at or
+// past the overflow before on_overflow has been dispatched.
+void Timer::sync_tima()
+{
+    if (!running || scheduler.now < next_increment) {
+        return;
+    }
+    const u64 increments {(scheduler.now - next_increment) / tima_period() + 1};
+    registers.tima += increments;
+    next_increment += increments * tima_period();
+}
+
+void Timer::schedule_overflow()
+{
+    scheduler.schedule(Event::Tima, next_increment + u64(0xFF - registers.tima) * tima_period());
+}
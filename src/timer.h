@@ -0,0 +1,66 @@
+#ifndef KORLOW_TIMER_H
+#define KORLOW_TIMER_H
+
+#include "emu_types.h"
+
+struct Scheduler;
+struct TimerState;
+
+struct TimerRegisters {
+    u8& if_;
+    u8& div;
+    u8& tima;
+    u8& tma;
+    u8& tac;
+};
+
+/*
+ * DIV and TIMA, computed from the cycle counter when they're read rather than
+ * ticked. The only event is TIMA overflowing, which reloads it from TMA and
+ * requests the interrupt.
+ *
+ * While TIMA runs, registers.tima holds its value before `next_increment`; the
+ * increments since then are folded in on access.
+ */
+struct Timer {
+    Timer(TimerRegisters, Scheduler&);
+
+    void reset();
+
+    // Current register values, also stored back into registers.div/tima
+    u8 div();
+    u8 tima();
+
+    // Event handler. `at` is the cycle the overflow was due.
+    void on_overflow(u64 at);
+
+    // Called by the MMU instead of storing the register. DIV ignores `value`.
+    void div_written();
+    void tima_written(u8 value);
+    void tac_written(u8 value);
+
+    // # of cycles per TIMA increment for the current TAC.
+    u32 tima_period() const;
+
+    // Cycle DIV or TIMA next counts up at, unless written. kNever for TIMA
+    // while it's stopped.
+    u64 next_div_change() const;
+    u64 next_tima_change() const;
+
+    // The counters, for save states. The registers are in memory.
+    void save(TimerState&) const;
+    void load(const TimerState&);
+
+    TimerRegisters registers;
+    Scheduler& scheduler;
+
+private:
+    void sync_tima();
+    void schedule_overflow();
+
+    u64 div_reset {0};         // Cycle DIV was last reset at
+    u64 next_increment {0};    // Cycle TIMA next increments at, while running
+    bool running {false};
+};
+
+#endif    // KORLOW_TIMER_H
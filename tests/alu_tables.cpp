@@ -0,0 +1,73 @@
+#include "cpu/alu_tables.h"
+
+#include <doctest/doctest.h>
+
+#include "cpu/cpu_base.h"
+#include "emu_types.h"
+
+TEST_CASE("ALU tables match the flag helpers")
+{
+    for (int a = 0; a < 0x100; a++) {
+        for (int b = 0; b < 0x100; b++) {
+            for (u8 carry : {u8(0), u8(FLAGS_CARRY)}) {
+                INFO("a ", a, " b ", b, " carry ", carry);
+
+                u8 expected_a = a;
+                u8 expected_f = carry;
+                ADC(expected_a, b, expected_f);
+                u8 got_a = a;
+                u8 got_f = carry;
+                alu::adc(got_a, b, got_f);
+                REQUIRE(got_a == expected_a);
+                REQUIRE(got_f == expected_f);
+
+                expected_a = a;
+                expected_f = carry;
+                SBC(expected_a, b, expected_f);
+                got_a = a;
+                got_f = carry;
+                alu::sbc(got_a, b, got_f);
+                REQUIRE(got_a == expected_a);
+                REQUIRE(got_f == expected_f);
+
+                expected_f = carry;
+                got_f = carry;
+                REQUIRE(alu::add(a, b, got_f) == ADD8(a, b, expected_f));
+                REQUIRE(got_f == expected_f);
+
+                expected_f = carry;
+                got_f = carry;
+                REQUIRE(alu::sub(a, b, got_f) == SUB8(a, b, expected_f));
+                REQUIRE(got_f == expected_f);
+
+                expected_f = carry;
+                got_f = carry;
+                CP(a, b, expected_f);
+                alu::cp(a, b, got_f);
+                REQUIRE(got_f == expected_f);
+            }
+        }
+
+        for (u8 f : {u8(0), u8(0xF0)}) {
+            INFO("r ", a, " f ", f);
+
+            u8 expected_r = a;
+            u8 expected_f = f;
+            INC8(expected_r, expected_f);
+            u8 got_r = a;
+            u8 got_f = f;
+            alu::inc(got_r, got_f);
+            REQUIRE(got_r == expected_r);
+            REQUIRE(got_f == expected_f);
+
+            expected_r = a;
+            expected_f = f;
+            DEC8(expected_r, expected_f);
+            got_r = a;
+            got_f = f;
+            alu::dec(got_r, got_f);
+            REQUIRE(got_r == expected_r);
+            REQUIRE(got_f == expected_f);
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include "batch.h"
+
+#include <doctest/doctest.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "cartridge.h"
+#include "emulator.h"
+
+namespace {
+
+// MBC1 with 8KB RAM. Keeps writing DIV through WRAM, cart RAM and the tiles.
+std::vector<u8> make_rom()
+{
+    std::vector<u8> rom(2 * kRomBankSize);
+    const u8 code[] {
+        0x3E, 0x0A,          // LD A, 0x0A
+        0xEA, 0x00, 0x00,    // LD (0x0000), A      Enable RAM
+        0x21, 0x00, 0xC0,    // LD HL, 0xC000
+        0xF0, 0x04,          // loop: LDH A, (DIV)
+        0x22,                // LD (HL+), A
+        0xEA, 0x00, 0xA0,    // LD (0xA000), A
+        0xEA, 0x00, 0x80,    // LD (0x8000), A      Tile 0, row 0
+        0x7C,                // LD A, H
+        0xFE, 0xD0,          // CP 0xD0
+        0x20, 0xF2,          // JR NZ, loop
+        0x21, 0x00, 0xC0,    // LD HL, 0xC000
+        0x18, 0xED,          // JR loop
+    };
+    std::copy(std::begin(code), std::end(code), rom.begin() + 0x100);
+    rom[0x147] = 0x02;
+    rom[0x149] = 0x02;
+    return rom;
+}
+
+bool same_state(Emulator& a, Emulator& b)
+{
+    auto state_a {std::make_unique<State>()};
+    auto state_b {std::make_unique<State>()};
+    a.save_state(*state_a);
+    b.save_state(*state_b);
+    return std::memcmp(state_a.get(), state_b.get(), state_a->header.size) == 0;
+}
+
+struct Fixture {
+    Fixture()
+    {
+        cart.rom = RomImage::from_bytes(make_rom());
+        reference.reset(true);
+        mmu_set_cartridge(&reference.mmu, &cart, true);
+    }
+
+    Cartridge cart;
+    Emulator reference;
+};
+
+}    // namespace
+
+TEST_CASE("Every instance in a batch runs as it would on its own")
+{
+    Fixture f;
+    Batch batch {f.cart, 7, 3};
+    REQUIRE(batch.size() == 7);
+
+    for (int frame = 0; frame < 5; frame++) {
+        batch.run_frame();
+        f.reference.run_frame();
+
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            CHECK(same_state(batch[i], f.reference));
+            CHECK(std::memcmp(batch.frame(i), f.reference.ppu.get_pixels(), Batch::kFrameSize) == 0);
+        }
+    }
+}
+
+TEST_CASE("Instances in a batch don't share memory")
+{
+    Fixture f;
+    Batch batch {f.cart, 4, 2};
+    batch.run_frame();
+
+    batch[1].mmu.write8(0xD800, 0x42);
+    batch[2].mmu.write8(0xA100, 0x24);
+    batch.run_frame();
+
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        CHECK((batch[i].mmu.read8(0xD800) == 0x42) == (i == 1));
+        CHECK((batch[i].mmu.read8(0xA100) == 0x24) == (i == 2));
+    }
+}
+
+TEST_CASE("A batch with more threads than instances still runs them all")
+{
+    Fixture f;
+    Batch batch {f.cart, 3, 8};
+    batch.run_frame();
+    f.reference.run_frame();
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        CHECK(same_state(batch[i], f.reference));
+    }
+}
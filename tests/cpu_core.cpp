@@ -0,0 +1,331 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "cpu/cpu.h"
+#include "emu_types.h"
+#include "memory_map.h"
+#include "scheduler.h"
+#include "test_bus.h"
+
+namespace {
+
+struct Machine {
+    Machine()
+        : mem(new u8[0x10000]())
+        , cpu(CpuRegisters {
+              .io = mem[kIo],
+              .if_ = mem[kIf],
+              .ie = mem[kIe],
+          })
+        , mmu(mem)
+    {
+        mmu.code_cache = &cache;
+    }
+
+    ~Machine()
+    {
+        delete[] mem;
+    }
+
+    u8* mem;
+    Cpu cpu;
+    TestBus mmu;
+    BlockCache cache;
+};
+
+// Deterministic so failures reproduce
+u32 next_random(u32& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+void randomize(Machine& m, u32& state, u16 op)
+{
+    for (int i = 0; i < 0x10000; i++) {
+        m.mem[i] = next_random(state);
+    }
+    m.cache.reset();
+
+    Cpu& cpu {m.cpu};
+    cpu.reset(true);
+    cpu.set_enabled(true);
+    cpu.af = next_random(state) & 0xFFF0;
+    cpu.bc = next_random(state);
+    cpu.de = next_random(state);
+    cpu.hl = next_random(state);
+    cpu.sp = next_random(state);
+    cpu.pc = next_random(state);
+    cpu.ime = next_random(state) & 1;
+    cpu.halt_bug_state = static_cast<HaltBug>(next_random(state) % 3);
+    cpu.ei_bug_state = static_cast<EIBug>(next_random(state) % 3);
+
+    if (op > 0xFF) {
+        m.mem[cpu.pc] = 0xCB;
+        m.mem[u16(cpu.pc + 1)] = op & 0xFF;
+    }
+    else {
+        m.mem[cpu.pc] = op;
+    }
+}
+
+}    // namespace
+
+TEST_CASE("Switch core matches the table core")
+{
+    Machine table;
+    Machine fast;
+
+    for (u16 op = 0; op < 0x200; op++) {
+        if (op == 0xCB) {
+            continue;    // Covered by 0x100-0x1FF
+        }
+
+        for (u32 trial = 0; trial < 16; trial++) {
+            u32 seed {op * 16u + trial + 1};
+            randomize(table, seed, op);
+            seed = op * 16u + trial + 1;
+            randomize(fast, seed, op);
+
+            const int table_cycles {table.cpu.tick(table.mmu)};
+
+            u64 now {0};
+            const u64 deadline {1};
+            const u64 count {fast.cpu.run_until(fast.mmu, fast.cache, now, deadline, kNever)};
+
+            INFO("op ", op, " trial ", trial);
+            REQUIRE(count == 1);
+            CHECK(now == static_cast<u64>(table_cycles));
+            CHECK(fast.cpu.af == table.cpu.af);
+            CHECK(fast.cpu.bc == table.cpu.bc);
+            CHECK(fast.cpu.de == table.cpu.de);
+            CHECK(fast.cpu.hl == table.cpu.hl);
+            CHECK(fast.cpu.sp == table.cpu.sp);
+            CHECK(fast.cpu.pc == table.cpu.pc);
+            CHECK(fast.cpu.ime == table.cpu.ime);
+            CHECK(fast.cpu.halted == table.cpu.halted);
+            CHECK(fast.cpu.enabled == table.cpu.enabled);
+            CHECK(fast.cpu.halt_bug_state == table.cpu.halt_bug_state);
+            CHECK(fast.cpu.ei_bug_state == table.cpu.ei_bug_state);
+            CHECK(std::memcmp(fast.mem, table.mem, 0x10000) == 0);
+        }
+    }
+}
+
+TEST_CASE("Switch core keeps flags across runs of ALU instructions")
+{
+    // One-byte instructions that set or read flags without jumping
+    const u8 ops[] = {0x04, 0x05, 0x0C, 0x0D, 0x14, 0x15, 0x1C, 0x1D, 0x24, 0x25, 0x2C, 0x2D, 0x3C, 0x3D,
+                      0x07, 0x0F, 0x17, 0x1F, 0x27, 0x2F, 0x37, 0x3F, 0xF5, 0xF1};
+
+    Machine table;
+    Machine fast;
+
+    for (u32 trial = 0; trial < 256; trial++) {
+        u32 seed {trial + 1};
+        randomize(table, seed, 0);
+        seed = trial + 1;
+        randomize(fast, seed, 0);
+
+        // Keep the program and the stack apart
+        const u16 start {0xC000};
+        for (Machine* m : {&table, &fast}) {
+            m->cpu.pc = start;
+            m->cpu.sp = 0xE000;
+            m->cpu.ime = false;
+            m->cpu.halt_bug_state = HaltBug::None;
+            m->cpu.ei_bug_state = EIBug::None;
+        }
+
+        u32 state {trial};
+        for (u16 i = 0; i < 64; i++) {
+            const u32 r {next_random(state)};
+            const u8 op {(r & 1) ? ops[(r >> 1) % sizeof(ops)] : u8(0x80 + (r >> 1) % 0x40)};
+            table.mem[start + i] = op;
+            fast.mem[start + i] = op;
+        }
+
+        u64 cycles {0};
+        for (int i = 0; i < 64; i++) {
+            cycles += table.cpu.tick(table.mmu);
+        }
+
+        u64 now {0};
+        const u64 deadline {kNever};
+
+        INFO("trial ", trial);
+        CHECK(fast.cpu.run_until(fast.mmu, fast.cache, now, deadline, cycles) == 64);
+        CHECK(fast.cpu.af == table.cpu.af);
+        CHECK(fast.cpu.bc == table.cpu.bc);
+        CHECK(fast.cpu.de == table.cpu.de);
+        CHECK(fast.cpu.hl == table.cpu.hl);
+        CHECK(std::memcmp(fast.mem, table.mem, 0x10000) == 0);
+    }
+}
+
+TEST_CASE("Fused idioms match running the instructions one by one")
+{
+    struct Program {
+        const char* name;
+        Idiom idiom;
+        std::vector<u8> code;
+    };
+    // Each loop is followed by JR -2, so both cores run up to the same cycle
+    const Program programs[] {
+        // LD HL, 0xC100; LD DE, 0xC200; LD B, 0x20; LD A, (HL+); LD (DE), A; INC DE; DEC B; JR NZ, -6
+        {"copy", Idiom::Copy, {0x21, 0x00, 0xC1, 0x11, 0x00, 0xC2, 0x06, 0x20, 0x2A, 0x12, 0x13, 0x05, 0x20, 0xFA, 0x18, 0xFE}},
+        // LD BC, 0x0100; DEC BC; LD A, B; OR C; JR NZ, -5
+        {"delay", Idiom::Delay, {0x01, 0x00, 0x01, 0x0B, 0x78, 0xB1, 0x20, 0xFB, 0x18, 0xFE}},
+        // LDH A, (0x80); CP 0x07; JR NZ, -6: spins until the end of the slice
+        {"poll", Idiom::Poll, {0xF0, 0x80, 0xFE, 0x07, 0x20, 0xFA, 0x18, 0xFE}},
+    };
+
+    for (const Program& program : programs) {
+        Machine table;
+        Machine fast;
+        for (Machine* m : {&table, &fast}) {
+            m->cpu.reset(true);
+            m->cpu.pc = 0xC000;
+            std::memcpy(m->mem + 0xC000, program.code.data(), program.code.size());
+            for (int i = 0; i < 0x20; i++) {
+                m->mem[0xC100 + i] = i * 7;
+            }
+            m->mem[0xFF80] = 0x05;
+        }
+
+        const u64 target {20000};
+        u64 table_now {0};
+        u64 table_count {0};
+        while (table_now < target) {
+            table_now += table.cpu.tick(table.mmu);
+            table_count++;
+        }
+
+        // Small slices so loops also stop and restart at the end of one
+        u64 now {0};
+        u64 count {0};
+        const u64 deadline {kNever};
+        for (u64 end = 97; now < target; end = std::min(end + 97, target)) {
+            count += fast.cpu.run_until(fast.mmu, fast.cache, now, deadline, end);
+        }
+
+        INFO(program.name);
+        CHECK(fast.cache.fused[static_cast<int>(program.idiom)] > 0);
+        CHECK(now == table_now);
+        CHECK(count == table_count);
+        CHECK(fast.cpu.af == table.cpu.af);
+        CHECK(fast.cpu.bc == table.cpu.bc);
+        CHECK(fast.cpu.de == table.cpu.de);
+        CHECK(fast.cpu.hl == table.cpu.hl);
+        CHECK(fast.cpu.pc == table.cpu.pc);
+        CHECK(std::memcmp(fast.mem, table.mem, 0x10000) == 0);
+    }
+}
+
+TEST_CASE("Copies to the MBC registers aren't fused")
+{
+    // LD HL, 0xC100; LD DE, 0x2000; LD B, 0x20; LD A, (HL+); LD (DE), A; INC DE; DEC B; JR NZ, -6
+    const u8 code[] = {0x21, 0x00, 0xC1, 0x11, 0x00, 0x20, 0x06, 0x20, 0x2A, 0x12, 0x13, 0x05, 0x20, 0xFA, 0x18, 0xFE};
+
+    Machine m;
+    m.cpu.reset(true);
+    m.cpu.pc = 0xC000;
+    std::memcpy(m.mem + 0xC000, code, sizeof(code));
+
+    u64 now {0};
+    const u64 deadline {kNever};
+    m.cpu.run_until(m.mmu, m.cache, now, deadline, 2000);
+
+    CHECK(m.cpu.b == 0);
+    CHECK(m.cpu.de == 0x2020);
+    CHECK(m.cache.fused[static_cast<int>(Idiom::Copy)] == 0);
+}
+
+TEST_CASE("Switch core stops at the deadline")
+{
+    Machine m;
+    m.cpu.reset(true);
+    m.cpu.pc = 0xC000;
+    m.mem[0xC000] = 0x18;    // JR -2
+    m.mem[0xC001] = 0xFE;
+
+    u64 now {0};
+    u64 deadline {120};
+    const u64 count {m.cpu.run_until(m.mmu, m.cache, now, deadline, kNever)};
+
+    CHECK(count == 10);
+    CHECK(now == 120);
+    CHECK(m.cpu.pc == 0xC000);
+
+    SUBCASE("and at the end of the slice")
+    {
+        m.cpu.run_until(m.mmu, m.cache, now, deadline, 100);
+        CHECK(now == 120);
+
+        deadline = kNever;
+        m.cpu.run_until(m.mmu, m.cache, now, deadline, 240);
+        CHECK(now == 240);
+    }
+
+    SUBCASE("and when halted with nothing pending")
+    {
+        m.mmu.write8(0xC000, 0x76);    // HALT
+        deadline = kNever;
+        m.cpu.ime = true;
+        m.mem[kIe] = 0x01;
+        m.mem[kIf] = 0x00;
+        CHECK(m.cpu.run_until(m.mmu, m.cache, now, deadline, kNever) == 1);
+        CHECK(m.cpu.halted);
+    }
+}
+
+TEST_CASE("Block cache")
+{
+    Machine m;
+    m.cpu.reset(true);
+    m.cpu.pc = 0xC000;
+
+    // INC B, INC C, JR -4
+    const u8 code[] = {0x04, 0x0C, 0x18, 0xFC};
+    std::memcpy(m.mem + 0xC000, code, sizeof(code));
+
+    u64 now {0};
+    const u64 deadline {kNever};
+
+    SUBCASE("reuses decoded blocks")
+    {
+        CHECK(m.cpu.run_until(m.mmu, m.cache, now, deadline, 20 * 20) == 60);
+        CHECK(m.cpu.b == 20);
+        CHECK(m.cpu.c == u8(0x13 + 20));
+        CHECK(m.cache.misses == 1);
+        CHECK(m.cache.hits == 19);
+    }
+
+    SUBCASE("drops blocks that are overwritten")
+    {
+        m.cpu.run_until(m.mmu, m.cache, now, deadline, 20);
+        m.mmu.write8(0xC001, 0x14);    // INC D
+
+        const u8 d {m.cpu.d};
+        m.cpu.run_until(m.mmu, m.cache, now, deadline, 40);
+        CHECK(m.cpu.d == d + 1);
+        CHECK(m.cache.misses == 2);
+    }
+
+    SUBCASE("sees writes to the rest of the running block")
+    {
+        // LD A, 0x14; LD (0xC005), A; INC B -> INC D; HALT
+        const u8 smc[] = {0x3E, 0x14, 0xEA, 0x05, 0xC0, 0x04, 0x76};
+        std::memcpy(m.mem + 0xC000, smc, sizeof(smc));
+
+        const u8 b {m.cpu.b};
+        const u8 d {m.cpu.d};
+        m.cpu.run_until(m.mmu, m.cache, now, deadline, kNever);
+        CHECK(m.cpu.b == b);
+        CHECK(m.cpu.d == d + 1);
+        CHECK(m.cpu.halted);
+    }
+}
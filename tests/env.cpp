@@ -0,0 +1,128 @@
+#include "env.h"
+
+#include <doctest/doctest.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "cartridge.h"
+#include "emulator.h"
+#include "mmu.h"
+
+namespace {
+
+// Reads both lines of P1 into WRAM and the first two rows of tile 0, over and
+// over
+std::vector<u8> make_rom()
+{
+    std::vector<u8> rom(2 * kRomBankSize);
+    const u8 code[] {
+        0x3E, 0x20,          // loop: LD A, 0x20
+        0xE0, 0x00,          // LDH (P1), A         Directions
+        0xF0, 0x00,          // LDH A, (P1)
+        0xEA, 0x00, 0xC0,    // LD (0xC000), A
+        0xEA, 0x00, 0x80,    // LD (0x8000), A
+        0x3E, 0x10,          // LD A, 0x10
+        0xE0, 0x00,          // LDH (P1), A         Buttons
+        0xF0, 0x00,          // LDH A, (P1)
+        0xEA, 0x01, 0xC0,    // LD (0xC001), A
+        0xEA, 0x02, 0x80,    // LD (0x8002), A
+        0x18, 0xE6,          // JR loop
+    };
+    std::copy(std::begin(code), std::end(code), rom.begin() + 0x100);
+    return rom;
+}
+
+Env::Config make_config()
+{
+    Env::Config config;
+    config.instances = 4;
+    config.threads = 2;
+    config.frame_skip = 2;
+    config.downscale = 2;
+    config.probes = {0xC000, 0xC001};
+    return config;
+}
+
+}    // namespace
+
+TEST_CASE("Each instance in an env plays its own buttons")
+{
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+    Env env {cart, make_config()};
+    REQUIRE(env.frame_width() == 80);
+    REQUIRE(env.frame_height() == 72);
+
+    const u8 actions[] {0, JoypadRight, JoypadA | JoypadDown, JoypadStart};
+    std::vector<u8> frames(env.size() * env.frame_size());
+    std::vector<u8> features(env.size() * 2);
+    env.step(actions, frames.data(), features.data());
+
+    CHECK(features[0] == 0xEF);
+    CHECK(features[1] == 0xDF);
+    CHECK(features[2] == 0xEE);
+    CHECK(features[3] == 0xDF);
+    CHECK(features[4] == 0xE7);
+    CHECK(features[5] == 0xDE);
+    CHECK(features[6] == 0xEF);
+    CHECK(features[7] == 0xD7);
+
+    // Each pixel out is the average of a 2x2 block of the frame
+    for (std::size_t i = 0; i < env.size(); i++) {
+        const u8* pixels {env.batch[i].ppu.get_pixels()};
+        const u8* frame {&frames[i * env.frame_size()]};
+        for (int y = 0; y < env.frame_height(); y++) {
+            for (int x = 0; x < env.frame_width(); x++) {
+                const u8* block {pixels + 2 * y * kLcdWidth + 2 * x};
+                const int sum {block[0] + block[1] + block[kLcdWidth] + block[kLcdWidth + 1]};
+                REQUIRE(frame[y * env.frame_width() + x] == (sum + 2) / 4);
+            }
+        }
+    }
+    CHECK(std::memcmp(&frames[0], &frames[env.frame_size()], env.frame_size()) != 0);
+}
+
+TEST_CASE("Resetting an env instance takes it back to the start")
+{
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+    Env env {cart, make_config()};
+    Env fresh {cart, make_config()};
+
+    const u8 actions[] {JoypadUp, JoypadB, JoypadLeft, JoypadSelect};
+    std::vector<u8> features(env.size() * 2);
+    for (int i = 0; i < 3; i++) {
+        env.step(actions, nullptr, features.data());
+    }
+
+    env.reset(2);
+    const u8 other[] {JoypadDown, JoypadA, JoypadRight, JoypadStart};
+    std::vector<u8> frames(env.size() * env.frame_size());
+    std::vector<u8> fresh_frames(env.size() * env.frame_size());
+    std::vector<u8> fresh_features(env.size() * 2);
+    env.step(other, frames.data(), features.data());
+    fresh.step(other, fresh_frames.data(), fresh_features.data());
+
+    CHECK(env.batch[2].scheduler.now == fresh.batch[2].scheduler.now);
+    CHECK(env.batch[1].scheduler.now != fresh.batch[1].scheduler.now);
+    CHECK(features[4] == fresh_features[4]);
+    CHECK(features[5] == fresh_features[5]);
+    const std::size_t third {2 * env.frame_size()};
+    CHECK(std::memcmp(&frames[third], &fresh_frames[third], env.frame_size()) == 0);
+}
+
+TEST_CASE("An env needs a frame skip and downscale of at least 1")
+{
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+
+    Env::Config config {make_config()};
+    config.frame_skip = 0;
+    CHECK_THROWS_AS(Env(cart, config), std::runtime_error);
+
+    config = make_config();
+    config.downscale = 0;
+    CHECK_THROWS_AS(Env(cart, config), std::runtime_error);
+}
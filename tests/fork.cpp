@@ -0,0 +1,241 @@
+#include "emulator.h"
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "cartridge.h"
+#include "constants.h"
+#include "memory_map.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// MBC1 with 32KB RAM. Fills WRAM and cart RAM with DIV and switches ROM banks.
+std::vector<u8> make_rom()
+{
+    std::vector<u8> rom(4 * kRomBankSize);
+    const u8 code[] {
+        0x3E, 0x0A,          // LD A, 0x0A
+        0xEA, 0x00, 0x00,    // LD (0x0000), A      Enable RAM
+        0x21, 0x00, 0xC0,    // LD HL, 0xC000
+        0xF0, 0x04,          // loop: LDH A, (DIV)
+        0x22,                // LD (HL+), A
+        0xEA, 0x00, 0xA0,    // LD (0xA000), A
+        0xE6, 0x03,          // AND 3
+        0x3C,                // INC A
+        0xEA, 0x00, 0x20,    // LD (0x2000), A      ROM bank 1-4
+        0x7C,                // LD A, H
+        0xFE, 0xDF,          // CP 0xDF
+        0x20, 0xEF,          // JR NZ, loop
+        0x21, 0x00, 0xC0,    // LD HL, 0xC000
+        0x18, 0xEA,          // JR loop
+    };
+    std::copy(std::begin(code), std::end(code), rom.begin() + 0x100);
+    rom[0x147] = 0x03;
+    rom[0x149] = 0x03;
+    return rom;
+}
+
+void run_until(Emulator& emulator, u64 cycle)
+{
+    while (emulator.scheduler.now < cycle) {
+        bool redraw {false};
+        emulator.run(cycle - emulator.scheduler.now, redraw);
+    }
+}
+
+bool same_state(Emulator& a, Emulator& b)
+{
+    auto state_a {std::make_unique<State>()};
+    auto state_b {std::make_unique<State>()};
+    a.save_state(*state_a);
+    b.save_state(*state_b);
+    return std::memcmp(state_a.get(), state_b.get(), state_a->header.size) == 0;
+}
+
+struct Fixture {
+    Fixture()
+    {
+        emulator.reset(true);
+        cart.rom = RomImage::from_bytes(make_rom());
+        mmu_set_cartridge(&emulator.mmu, &cart, true);
+        run_until(emulator, 100'000);
+    }
+
+    Emulator emulator;
+    Cartridge cart;
+};
+
+#ifdef __GLIBC__
+// Bytes of [data, data + size) backed by memory, in whole pages
+std::size_t committed(const void* data, std::size_t size)
+{
+    const std::size_t page_size {static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+    const std::uintptr_t first {reinterpret_cast<std::uintptr_t>(data) / page_size * page_size};
+    const std::size_t pages {(reinterpret_cast<std::uintptr_t>(data) + size - first + page_size - 1) / page_size};
+    std::vector<unsigned char> resident(pages);
+    if (mincore(reinterpret_cast<void*>(first), pages * page_size, resident.data()) != 0) {
+        return size;
+    }
+    std::size_t count {0};
+    for (const unsigned char page : resident) {
+        count += page & 1;
+    }
+    return count * page_size;
+}
+#endif
+
+}    // namespace
+
+TEST_CASE("A fork runs exactly like its parent")
+{
+    Fixture f;
+    Emulator& parent {f.emulator};
+
+    auto child {parent.fork()};
+    CHECK(same_state(parent, *child));
+
+    // Both write all over WRAM and cart RAM from here
+    run_until(parent, 250'000);
+    run_until(*child, 250'000);
+    CHECK(same_state(parent, *child));
+
+    SUBCASE("and so do forks of forks")
+    {
+        auto grandchild {child->fork()};
+        run_until(parent, 400'000);
+        run_until(*grandchild, 400'000);
+        CHECK(same_state(parent, *grandchild));
+    }
+}
+
+TEST_CASE("Forks share pages until they write to them")
+{
+    Fixture f;
+    Emulator& parent {f.emulator};
+    Mmu& mmu {parent.mmu};
+
+    const u8 wram {mmu.read8(0xC123)};
+    const u8 next {mmu.read8(0xC124)};
+    const u8 cart_ram {mmu.read8(0xA010)};
+
+    auto child {parent.fork()};
+    auto sibling {parent.fork()};
+
+    // Nothing was written in between, so they're forked from the same base
+    CHECK(child->mmu.base == sibling->mmu.base);
+    CHECK(child->mmu.read_map[0xC1] == mmu.read_map[0xC1]);
+    CHECK(child->mmu.shared[0xC1]);
+
+    child->mmu.write8(0xC123, wram + 1);
+    child->mmu.write8(0xA010, cart_ram + 1);
+    mmu.write8(0xC124, ~next);
+
+    CHECK(child->mmu.read8(0xC123) == u8(wram + 1));
+    CHECK(child->mmu.read8(0xE123) == u8(wram + 1));
+    CHECK(child->mmu.read8(0xA010) == u8(cart_ram + 1));
+    CHECK(child->mmu.read8(0xC124) == next);
+    CHECK_FALSE(child->mmu.shared[0xC1]);
+    CHECK(child->mmu.shared[0xC2]);
+
+    CHECK(mmu.read8(0xC123) == wram);
+    CHECK(mmu.read8(0xA010) == cart_ram);
+    CHECK(mmu.read8(0xC124) == u8(~next));
+
+    CHECK(sibling->mmu.read8(0xC123) == wram);
+    CHECK(sibling->mmu.read8(0xA010) == cart_ram);
+    CHECK(sibling->mmu.read8(0xC124) == next);
+
+    SUBCASE("A new fork after a write gets a new base")
+    {
+        auto later {parent.fork()};
+        CHECK(later->mmu.base != child->mmu.base);
+        CHECK(later->mmu.read8(0xC124) == u8(~next));
+    }
+}
+
+TEST_CASE("Writes to shared pages invalidate code decoded from them")
+{
+    Fixture f;
+    auto child {f.emulator.fork()};
+    Mmu& mmu {child->mmu};
+
+    const Block* block {&child->code_cache.lookup(mmu, 0xC000)};
+    mmu.write8(0xC000, 0x00);
+    CHECK_FALSE(child->code_cache.is_current(*block));
+
+    // And the page is watched again once code is decoded from it
+    block = &child->code_cache.lookup(mmu, 0xC000);
+    CHECK(child->code_cache.is_current(*block));
+    mmu.write8(0xC000, 0x00);
+    CHECK_FALSE(child->code_cache.is_current(*block));
+}
+
+TEST_CASE("Forks share VRAM, OAM and the frame until they write to them")
+{
+    Fixture f;
+    Emulator& parent {f.emulator};
+    run_until(parent, 100'000 + kCyclesPerLine / 2);
+
+    auto child {parent.fork()};
+    Ppu& ppu {child->ppu};
+    CHECK(ppu.memory.data() == parent.ppu.memory.data());
+    CHECK(ppu.oam.data() == parent.ppu.oam.data());
+    CHECK(ppu.pixels_shared());
+
+    const u8 tile {child->mmu.read8(0x8010)};
+    child->mmu.write8(0x8010, ~tile);
+    child->mmu.write8(0xFE00, 0x42);
+    CHECK(ppu.memory[0x10] == u8(~tile));
+    CHECK(ppu.memory.data() != parent.ppu.memory.data());
+    CHECK(ppu.oam[0] == 0x42);
+    CHECK(parent.ppu.memory[0x10] == tile);
+    CHECK(parent.mmu.read8(0x8010) == tile);
+    CHECK(parent.ppu.oam[0] != 0x42);
+
+    // All of VRAM came home, not just the page written
+    CHECK(child->mmu.read8(0x9800) == parent.mmu.read8(0x9800));
+    CHECK_FALSE(child->mmu.shared[0x98]);
+
+    // The next line is drawn into its own frame, over the rest of the shared one
+    const std::vector<u8> frame(parent.ppu.pixels.begin(), parent.ppu.pixels.end());
+    run_until(*child, child->scheduler.now + kCyclesPerLine);
+    CHECK_FALSE(ppu.pixels_shared());
+    CHECK(std::equal(frame.begin() + kLcdWidth * 100, frame.end(), ppu.pixels.begin() + kLcdWidth * 100));
+    CHECK(std::equal(frame.begin(), frame.end(), parent.ppu.pixels.begin()));
+}
+
+#ifdef __GLIBC__
+TEST_CASE("A fork commits only its registers and IO/HRAM")
+{
+    Fixture f;
+
+    // Hands the free pages back, so the block the fork gets is untouched
+    // wherever the allocator finds it
+    malloc_trim(0);
+    auto child {f.emulator.fork()};
+    const std::size_t page_size {static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+
+    // The registers at the start of the block and the IO/HRAM page, but none of
+    // VRAM, OAM, the frame, WRAM or cart RAM
+    CHECK(committed(child->state.get(), sizeof(State)) <= 3 * page_size);
+    // Past the page the frame shares with HRAM
+    CHECK(committed(child->state->pixels.data() + page_size, child->state->pixels.size() - page_size) == 0);
+    CHECK(committed(&child->state->memory[kTileRamUnsigned], 0x2000) == 0);
+
+    // Running on copies only what it writes
+    run_until(*child, child->scheduler.now + kCyclesPerFrame);
+    CHECK(committed(child->state.get(), sizeof(State)) < sizeof(State) / 2);
+}
+#endif
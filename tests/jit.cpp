@@ -0,0 +1,189 @@
+#include "cpu/jit.h"
+
+#include <doctest/doctest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "emulator.h"
+#include "memory_map.h"
+
+#ifdef KORLOW_JIT
+
+namespace {
+
+u32 next_random(u32& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+void load(Emulator& emulator, const u8* code, size_t size)
+{
+    emulator.reset(true);
+    for (size_t i = 0; i < size; i++) {
+        emulator.mmu.write8(kWram + i, code[i]);
+    }
+    emulator.cpu.pc = kWram;
+    emulator.cpu.sp = 0xDFF0;
+}
+
+void compare(Emulator& jit, Emulator& reference)
+{
+    CHECK(jit.scheduler.now == reference.scheduler.now);
+    CHECK(jit.total_instructions == reference.total_instructions);
+    CHECK(jit.cpu.af == reference.cpu.af);
+    CHECK(jit.cpu.bc == reference.cpu.bc);
+    CHECK(jit.cpu.de == reference.cpu.de);
+    CHECK(jit.cpu.hl == reference.cpu.hl);
+    CHECK(jit.cpu.sp == reference.cpu.sp);
+    CHECK(jit.cpu.pc == reference.cpu.pc);
+    CHECK(jit.cpu.ime == reference.cpu.ime);
+    CHECK(jit.cpu.halted == reference.cpu.halted);
+    CHECK(std::memcmp(jit.mem + kWram, reference.mem + kWram, 0x2000) == 0);
+    CHECK(std::memcmp(jit.mem + kZeroPage, reference.mem + kZeroPage, 0x80) == 0);
+}
+
+}    // namespace
+
+TEST_CASE("JIT core matches the switch core")
+{
+    Emulator reference;
+    reference.core = CpuCore::Switch;
+
+    Emulator jit;
+    jit.core = CpuCore::Jit;
+    jit.jit.threshold = 0;    // Translate every block on first use
+
+    SUBCASE("on a copy loop that rewrites itself")
+    {
+        // LD HL, 0xC100; LD DE, 0xC200; LD B, 0x40
+        // loop: LD A, (HL+); XOR B; LD (DE), A; INC DE; DEC B; JR NZ, loop
+        // LD A, 0x3C; LD (0xC00C), A; JP 0xC000  (the second pass runs INC A instead of XOR B)
+        const u8 code[] = {0x21, 0x00, 0xC1, 0x11, 0x00, 0xC2, 0x06, 0x40, 0x2A, 0xA8, 0x12, 0x13,
+                           0x05, 0x20, 0xF9, 0x3E, 0x3C, 0xEA, 0x09, 0xC0, 0xC3, 0x00, 0xC0};
+        load(reference, code, sizeof(code));
+        load(jit, code, sizeof(code));
+
+        bool redraw {false};
+        reference.run(200000, redraw);
+        redraw = false;
+        jit.run(200000, redraw);
+
+        CHECK(jit.jit.blocks_translated > 0);
+        compare(jit, reference);
+    }
+
+    SUBCASE("on arithmetic, rotates and branches, without leaving translated code")
+    {
+        // LD HL, 0xC100; LD B, 0x40
+        // loop: LD A, (HL); ADD A, B; ADC A, 0x13; SUB C; SBC A, D; CP E; RLA; RRCA; INC C; DEC D;
+        //       RL C; SRL D; SWAP A; BIT 3, B; JR C, +1; INC L; CPL; CCF; AND (HL); XOR 0x5A; INC L;
+        //       DEC B; JR NZ, loop
+        // JP 0xC000
+        const u8 code[] = {0x21, 0x00, 0xC1, 0x06, 0x40, 0x7E, 0x80, 0xCE, 0x13, 0x91, 0x9A, 0xBB, 0x17,
+                           0x0F, 0x0C, 0x15, 0xCB, 0x11, 0xCB, 0x3A, 0xCB, 0x37, 0xCB, 0x58, 0x38, 0x01,
+                           0x2C, 0x2F, 0x3F, 0xA6, 0xEE, 0x5A, 0x2C, 0x05, 0x20, 0xE1, 0xC3, 0x00, 0xC0};
+        load(reference, code, sizeof(code));
+        load(jit, code, sizeof(code));
+        for (Emulator* emulator : {&reference, &jit}) {
+            for (int i = 0; i < 0x100; i++) {
+                emulator->mmu.write8(kWram + 0x100 + i, static_cast<u8>(i * 37));
+            }
+        }
+
+        bool redraw {false};
+        reference.run(200000, redraw);
+        redraw = false;
+        jit.run(200000, redraw);
+
+        compare(jit, reference);
+        CHECK(jit.jit.handler_ops == 0);
+
+        // A block is at most 16 instructions, so this many per entry means
+        // the blocks chained into each other
+        CHECK(jit.jit.native_entries * 20 < jit.total_instructions);
+    }
+
+    SUBCASE("on random arithmetic")
+    {
+        for (u32 seed = 1; seed <= 64; seed++) {
+            // Instructions that don't write memory or jump, with JR cc, +1
+            // over some, then JP back to the start
+            std::vector<u8> code;
+            u32 state {seed};
+            while (code.size() < 0x400) {
+                const u32 r {next_random(state)};
+                const u8 op {static_cast<u8>(r)};
+                const u8 operand {static_cast<u8>(r >> 8)};
+                switch ((r >> 16) % 6) {
+                    case 0:
+                    case 1:
+                        code.push_back(0x80 + op % 0x40);    // ALU A, r
+                        break;
+                    case 2:
+                        code.insert(code.end(), {static_cast<u8>(0xC6 + (op % 8) * 8), operand});    // ALU A, d8
+                        break;
+                    case 3:
+                        if ((operand & 7) == 6 && (operand < 0x40 || operand >= 0x80)) {
+                            break;    // Writes (HL)
+                        }
+                        code.insert(code.end(), {0xCB, operand});
+                        break;
+                    case 4:
+                    {
+                        const u8 ops[] {0x04, 0x05, 0x0C, 0x0D, 0x14, 0x15, 0x1C, 0x1D, 0x24, 0x25, 0x2C, 0x2D, 0x3C, 0x3D,
+                                        0x07, 0x0F, 0x17, 0x1F, 0x27, 0x2F, 0x37, 0x3F, 0x03, 0x0B, 0x13, 0x1B, 0x23, 0x2B};
+                        code.push_back(ops[op % sizeof(ops)]);
+                        break;
+                    }
+                    case 5:
+                        code.insert(code.end(), {static_cast<u8>(0x20 + (op % 4) * 8), 0x01, 0x04});    // JR cc, +1; INC B
+                        break;
+                }
+            }
+            code.insert(code.end(), {0xC3, 0x00, 0xC0});
+
+            load(reference, code.data(), code.size());
+            load(jit, code.data(), code.size());
+            for (Emulator* emulator : {&reference, &jit}) {
+                u32 regs {seed * 2654435761u};
+                emulator->cpu.af = next_random(regs) & 0xFFF0;
+                emulator->cpu.bc = next_random(regs);
+                emulator->cpu.de = next_random(regs);
+                emulator->cpu.hl = kWram + next_random(regs) % 0x2000;
+            }
+
+            bool redraw {false};
+            reference.run(50000, redraw);
+            redraw = false;
+            jit.run(50000, redraw);
+
+            INFO("seed ", seed);
+            compare(jit, reference);
+        }
+    }
+
+    SUBCASE("on random code")
+    {
+        for (u32 seed = 1; seed <= 64; seed++) {
+            u8 code[0x1000];
+            u32 state {seed};
+            for (u8& byte : code) {
+                byte = next_random(state);
+            }
+            load(reference, code, sizeof(code));
+            load(jit, code, sizeof(code));
+
+            bool redraw {false};
+            reference.run(50000, redraw);
+            redraw = false;
+            jit.run(50000, redraw);
+
+            INFO("seed ", seed);
+            compare(jit, reference);
+        }
+    }
+}
+
+#endif    // KORLOW_JIT
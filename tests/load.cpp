@@ -4,7 +4,7 @@
 #include "cpu/cpu_base.h"
 #include "emu_types.h"
 #include "memory_map.h"
-#include "mmu.h"
+#include "test_bus.h"
 
 TEST_CASE("Load instructions")
 {
@@ -15,8 +15,7 @@ TEST_CASE("Load instructions")
         .if_ = mem[kIf],
         .ie = mem[kIe],
     });
-    Component null_ppu;
-    Mmu mmu(cpu, null_ppu, mem);
+    TestBus mmu(mem);
 
     SUBCASE("0X")
     {
@@ -5,7 +5,7 @@
 #include "cpu/cpu_base.h"
 #include "emu_types.h"
 #include "memory_map.h"
-#include "mmu.h"
+#include "test_bus.h"
 
 TEST_CASE("Base operations")
 {
@@ -16,8 +16,7 @@ TEST_CASE("Base operations")
         .if_ = mem[kIf],
         .ie = mem[kIe],
     });
-    Component null_ppu;
-    Mmu mmu(cpu, null_ppu, mem);
+    TestBus mmu(mem);
 
     /* Z00C */
     SUBCASE("Rotate left")
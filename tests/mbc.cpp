@@ -0,0 +1,311 @@
+#include "mbc.h"
+
+#include <doctest/doctest.h>
+
+#include "cartridge.h"
+#include "constants.h"
+#include "emulator.h"
+#include "fs.h"
+#include "memory_map.h"
+
+namespace {
+
+// Every bank starts with its own number, little endian
+std::vector<u8> make_rom(u8 cart_type, int banks, u8 ram_size = 0)
+{
+    std::vector<u8> rom(banks * kRomBankSize);
+    for (int bank = 0; bank < banks; bank++) {
+        rom[bank * kRomBankSize] = bank & 0xFF;
+        rom[bank * kRomBankSize + 1] = bank >> 8;
+    }
+    rom[0x147] = cart_type;
+    rom[0x149] = ram_size;
+    return rom;
+}
+
+Cartridge make_cartridge(std::vector<u8> rom)
+{
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(std::move(rom));
+    return cart;
+}
+
+}    // namespace
+
+TEST_CASE("MBC1 bank switching")
+{
+    Emulator emulator;
+    emulator.reset(true);
+    Mmu& mmu = emulator.mmu;
+
+    Cartridge cart {make_cartridge(make_rom(0x03, 128, 0x03))};    // 2MB ROM, 32KB RAM
+    mmu_set_cartridge(&mmu, &cart, true);
+
+    CHECK(mmu.read16(0x0000) == 0);
+    CHECK(mmu.read16(0x4000) == 1);
+
+    SUBCASE("ROM banks are mapped in place")
+    {
+        mmu.write8(0x2000, 5);
+        CHECK(mmu.read16(0x4000) == 5);
+        CHECK(mmu.read_map[0x40] == cart.rom->data + 5 * kRomBankSize);
+        CHECK(emulator.mem[0x4000] == 0);
+    }
+
+    SUBCASE("Bank 0 selects bank 1")
+    {
+        mmu.write8(0x2000, 0);
+        CHECK(mmu.read16(0x4000) == 1);
+        mmu.write8(0x3FFF, 0x20);
+        CHECK(mmu.read16(0x4000) == 1);
+    }
+
+    SUBCASE("The second register supplies the upper bits")
+    {
+        mmu.write8(0x4000, 2);
+        mmu.write8(0x2000, 3);
+        CHECK(mmu.read16(0x4000) == 0x43);
+        CHECK(mmu.read16(0x0000) == 0);
+
+        // and in mode 1 also maps bank 0
+        mmu.write8(0x6000, 1);
+        CHECK(mmu.read16(0x0000) == 0x40);
+    }
+
+    SUBCASE("RAM")
+    {
+        mmu.write8(kCartRam, 0x12);
+        CHECK(mmu.read8(kCartRam) == 0xFF);
+
+        mmu.write8(0x0000, 0x0A);
+        mmu.write8(kCartRam, 0x12);
+        CHECK(mmu.read8(kCartRam) == 0x12);
+
+        mmu.write8(0x6000, 1);
+        mmu.write8(0x4000, 2);
+        CHECK(mmu.read8(kCartRam) == 0x00);
+        mmu.write8(kCartRam + 0x1FFF, 0x34);
+
+        mmu.write8(0x4000, 0);
+        CHECK(mmu.read8(kCartRam) == 0x12);
+        CHECK(mmu.read8(kCartRam + 0x1FFF) == 0x00);
+
+        mmu.write8(0x0000, 0x00);
+        CHECK(mmu.read8(kCartRam) == 0xFF);
+    }
+}
+
+TEST_CASE("MBC2 has 512 4-bit RAM values")
+{
+    Emulator emulator;
+    emulator.reset(true);
+    Mmu& mmu = emulator.mmu;
+
+    Cartridge cart {make_cartridge(make_rom(0x06, 16))};
+    mmu_set_cartridge(&mmu, &cart, true);
+
+    // Address bit 8 set selects the ROM bank
+    mmu.write8(0x2100, 3);
+    CHECK(mmu.read16(0x4000) == 3);
+
+    mmu.write8(0x0000, 0x0A);
+    CHECK(mmu.read16(0x4000) == 3);
+
+    mmu.write8(kCartRam + 1, 0x5A);
+    CHECK(mmu.read8(kCartRam + 1) == 0xFA);
+    CHECK(mmu.read8(kCartRam + 0x201) == 0xFA);
+}
+
+TEST_CASE("MBC3 banks and clock")
+{
+    Emulator emulator;
+    emulator.reset(true);
+    Mmu& mmu = emulator.mmu;
+    u64& now = emulator.scheduler.now;
+
+    Cartridge cart {make_cartridge(make_rom(0x10, 128, 0x03))};
+    mmu_set_cartridge(&mmu, &cart, true);
+
+    mmu.write8(0x2000, 0x7F);
+    CHECK(mmu.read16(0x4000) == 0x7F);
+
+    mmu.write8(0x0000, 0x0A);
+    mmu.write8(0x4000, 3);
+    mmu.write8(kCartRam, 0x99);
+    CHECK(mmu.read8(kCartRam) == 0x99);
+
+    const auto latch = [&] {
+        mmu.write8(0x6000, 0);
+        mmu.write8(0x6000, 1);
+    };
+    const auto read_rtc = [&](u8 reg) {
+        mmu.write8(0x4000, reg);
+        return mmu.read8(kCartRam);
+    };
+
+    now += 61 * u64(kCpuFreq);
+    CHECK(read_rtc(0x08) == 0);
+
+    latch();
+    CHECK(read_rtc(0x08) == 1);
+    CHECK(read_rtc(0x09) == 1);
+
+    SUBCASE("Latched values hold until the next latch")
+    {
+        now += u64(kCpuFreq);
+        CHECK(read_rtc(0x08) == 1);
+        latch();
+        CHECK(read_rtc(0x08) == 2);
+    }
+
+    SUBCASE("Halting stops the clock")
+    {
+        mmu.write8(0x4000, 0x0C);
+        mmu.write8(kCartRam, 0x40);
+        now += 10 * u64(kCpuFreq);
+        latch();
+        CHECK(read_rtc(0x08) == 1);
+        CHECK(read_rtc(0x0C) == 0x40);
+    }
+
+    SUBCASE("The day counter overflows into the carry bit")
+    {
+        mmu.write8(0x4000, 0x0B);
+        mmu.write8(kCartRam, 0xFF);
+        mmu.write8(0x4000, 0x0C);
+        mmu.write8(kCartRam, 0x01);
+        now += 60 * 60 * 24 * u64(kCpuFreq);
+        latch();
+        CHECK(read_rtc(0x0B) == 0);
+        CHECK(read_rtc(0x0C) == 0x80);
+    }
+
+    SUBCASE("RAM is still there after the clock")
+    {
+        CHECK(read_rtc(0x03) == 0x99);
+    }
+}
+
+TEST_CASE("MBC5 addresses 512 ROM banks")
+{
+    Emulator emulator;
+    emulator.reset(true);
+    Mmu& mmu = emulator.mmu;
+
+    Cartridge cart {make_cartridge(make_rom(0x1B, 512, 0x04))};    // 8MB ROM, 128KB RAM
+    mmu_set_cartridge(&mmu, &cart, true);
+
+    mmu.write8(0x2000, 0x23);
+    mmu.write8(0x3000, 0x01);
+    CHECK(mmu.read16(0x4000) == 0x123);
+
+    // Bank 0 can be mapped twice
+    mmu.write8(0x2000, 0x00);
+    mmu.write8(0x3000, 0x00);
+    CHECK(mmu.read16(0x4000) == 0);
+
+    mmu.write8(0x0000, 0x0A);
+    for (u8 bank = 0; bank < 16; bank++) {
+        mmu.write8(0x4000, bank);
+        mmu.write8(kCartRam + bank, bank + 1);
+    }
+    for (u8 bank = 0; bank < 16; bank++) {
+        mmu.write8(0x4000, bank);
+        CHECK(mmu.read8(kCartRam + bank) == bank + 1);
+        CHECK(mmu.read8(kCartRam + bank + 1) == 0);
+    }
+}
+
+TEST_CASE("Battery-backed RAM is kept in the .sav file")
+{
+    const auto path {std::filesystem::temp_directory_path() / "korlow_mbc_test.sav"};
+    std::filesystem::remove(path);
+
+    const auto load = [&](Emulator& emulator, Cartridge& cart) {
+        emulator.reset(true);
+        cart.save_path = path;
+        mmu_set_cartridge(&emulator.mmu, &cart, true);
+        emulator.mmu.write8(0x0000, 0x0A);
+    };
+
+    {
+        Emulator emulator;
+        Cartridge cart {make_cartridge(make_rom(0x03, 4, 0x03))};
+        load(emulator, cart);
+        Mmu& mmu = emulator.mmu;
+
+        REQUIRE(mmu.mbc.save);
+        CHECK(std::filesystem::file_size(path) == 0x8000);
+
+        // Guest writes are plain stores into the mapping
+        CHECK(mmu.write_map[kCartRam >> 8] == mmu.mbc.save->data);
+        mmu.write8(kCartRam + 5, 0x42);
+        mmu.write8(0x0000, 0x00);
+    }
+
+    CHECK(FS::read_bytes(path.string())[5] == 0x42);
+
+    SUBCASE("and read back by the next session")
+    {
+        Emulator emulator;
+        Cartridge cart {make_cartridge(make_rom(0x03, 4, 0x03))};
+        load(emulator, cart);
+        CHECK(emulator.mmu.read8(kCartRam + 5) == 0x42);
+    }
+
+    SUBCASE("but only for cartridges with a battery")
+    {
+        Emulator emulator;
+        Cartridge cart {make_cartridge(make_rom(0x02, 4, 0x03))};
+        load(emulator, cart);
+        CHECK_FALSE(emulator.mmu.mbc.save);
+        CHECK(emulator.mmu.read8(kCartRam + 5) == 0x00);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Switching banks invalidates code decoded from them")
+{
+    Emulator emulator;
+    emulator.reset(true);
+    Mmu& mmu = emulator.mmu;
+    BlockCache& cache = emulator.code_cache;
+
+    std::vector<u8> rom {make_rom(0x01, 4)};
+    rom[1 * kRomBankSize + 0x10] = 0x3C;    // INC A
+    rom[2 * kRomBankSize + 0x10] = 0x3D;    // DEC A
+
+    Cartridge cart {make_cartridge(std::move(rom))};
+    mmu_set_cartridge(&mmu, &cart, true);
+
+    const Block* block {&cache.lookup(mmu, 0x4010)};
+    CHECK(block->ops[0].op == 0x3C);
+
+    mmu.write8(0x2000, 1);
+    CHECK(cache.is_current(*block));
+
+    mmu.write8(0x2000, 2);
+    CHECK_FALSE(cache.is_current(*block));
+    CHECK(cache.lookup(mmu, 0x4010).ops[0].op == 0x3D);
+}
+
+TEST_CASE("The boot ROM covers the first page until FF50 is written")
+{
+    Emulator emulator;
+    emulator.reset(false);
+    Mmu& mmu = emulator.mmu;
+
+    std::vector<u8> rom {make_rom(0x00, 2)};
+    rom[0xFF] = 0x22;
+
+    Cartridge cart {make_cartridge(std::move(rom))};
+    cart.bios.data.assign(0x100, 0x31);
+    mmu_set_cartridge(&mmu, &cart, false);
+
+    CHECK(mmu.read8(0x00FF) == 0x31);
+    CHECK(mmu.read16(0x4000) == 1);
+
+    mmu.write8(kExitBootRomReg, 1);
+    CHECK(mmu.read8(0x00FF) == 0x22);
+}
@@ -0,0 +1,123 @@
+#include "mmu.h"
+
+#include <doctest/doctest.h>
+
+#include "emulator.h"
+#include "memory_map.h"
+
+TEST_CASE("MMU page table")
+{
+    Emulator emulator;
+    emulator.reset(true);
+
+    Mmu& mmu = emulator.mmu;
+    u8* mem = emulator.mem;
+
+    SUBCASE("WRAM and HRAM are plain stores")
+    {
+        mmu.write8(kWram + 0x123, 0xAB);
+        CHECK(mem[kWram + 0x123] == 0xAB);
+        CHECK(mmu.read8(kWram + 0x123) == 0xAB);
+
+        mmu.write8(kZeroPage + 1, 0xCD);
+        CHECK(mmu.read8(kZeroPage + 1) == 0xCD);
+    }
+
+    SUBCASE("Echo RAM mirrors WRAM")
+    {
+        mmu.write8(kWram + 0x10, 0x42);
+        CHECK(mmu.read8(kEchoRam + 0x10) == 0x42);
+
+        mmu.write8(kEchoRam + 0x1DFF, 0x24);
+        CHECK(mmu.read8(kWram + 0x1DFF) == 0x24);
+    }
+
+    SUBCASE("ROM writes are ignored")
+    {
+        mem[0x2000] = 0x11;
+        mmu.write8(0x2000, 0x01);
+        CHECK(mmu.read8(0x2000) == 0x11);
+    }
+
+    SUBCASE("VRAM and OAM writes reach the PPU")
+    {
+        mmu.write8(kTileRamUnsigned + 5, 0x77);
+        CHECK(emulator.ppu.memory[5] == 0x77);
+        CHECK(mmu.read8(kTileRamUnsigned + 5) == 0x77);
+
+        mmu.write8(kOam + 3, 0x66);
+        CHECK(emulator.ppu.oam[3] == 0x66);
+    }
+
+    SUBCASE("IO writes keep their side effects")
+    {
+        mmu.write8(kIf, 0xFF);
+        CHECK(mmu.read8(kIf) == 0x1F);
+
+        mmu.write8(kIo, 0x00);
+        CHECK(mmu.read8(kIo) == 0xCF);
+    }
+
+    SUBCASE("Held buttons show on the lines the game selects")
+    {
+        mmu.set_joypad(JoypadRight | JoypadStart);
+        mmu.write8(kIf, 0x00);
+
+        mmu.write8(kIo, 0x20);    // Directions
+        CHECK(mmu.read8(kIo) == 0xEE);
+        mmu.write8(kIo, 0x10);    // Buttons
+        CHECK(mmu.read8(kIo) == 0xD7);
+        mmu.write8(kIo, 0x30);    // Neither
+        CHECK(mmu.read8(kIo) == 0xFF);
+        CHECK(mmu.read8(kIf) == 0x00);
+
+        // Pressing a button that shows requests the interrupt
+        mmu.write8(kIo, 0x10);
+        mmu.set_joypad(JoypadRight | JoypadA);
+        CHECK(mmu.read8(kIo) == 0xDE);
+        CHECK(mmu.read8(kIf) == 0x10);
+
+        mmu.write8(kIf, 0x00);
+        mmu.set_joypad(JoypadLeft);
+        CHECK(mmu.read8(kIo) == 0xDF);
+        CHECK(mmu.read8(kIf) == 0x00);
+    }
+}
+
+TEST_CASE("Writes to code pages invalidate decoded blocks")
+{
+    Emulator emulator;
+    emulator.reset(true);
+
+    Mmu& mmu = emulator.mmu;
+    BlockCache& cache = emulator.code_cache;
+
+    mmu.write8(kWram + 0x100, 0x00);    // NOP
+    mmu.write8(kWram + 0x101, 0x18);    // JR -3
+    mmu.write8(kWram + 0x102, 0xFD);
+
+    const Block* block {&cache.lookup(mmu, kWram + 0x100)};
+    CHECK(block->length == 2);
+    CHECK(mmu.write_map[(kWram + 0x100) >> 8] == nullptr);
+    CHECK(cache.is_current(*block));
+
+    SUBCASE("through WRAM")
+    {
+        mmu.write8(kWram + 0x1FF, 0x00);
+        CHECK_FALSE(cache.is_current(*block));
+        CHECK(emulator.mem[kWram + 0x1FF] == 0x00);
+    }
+
+    SUBCASE("through echo RAM")
+    {
+        mmu.write8(kEchoRam + 0x100, 0x3C);    // INC A
+        CHECK_FALSE(cache.is_current(*block));
+        CHECK(cache.lookup(mmu, kWram + 0x100).ops[0].op == 0x3C);
+    }
+
+    SUBCASE("but not through other pages")
+    {
+        mmu.write8(kWram + 0x200, 0x00);
+        CHECK(cache.is_current(*block));
+    }
+}
@@ -2,6 +2,9 @@
 
 #include <doctest/doctest.h>
 
+#include <vector>
+
+#include "constants.h"
 #include "cpu/cpu.h"
 #include "cpu/cpu_base.h"
 #include "emu_types.h"
@@ -11,13 +14,13 @@
 TEST_CASE("PPU produces correct pixels")
 {
     u8* mem = new u8[0x10000]();
+    std::vector<u8> pixels(kLcdWidth * kLcdHeight);
 
     Cpu cpu(CpuRegisters {
         .io = mem[kIo],
         .if_ = mem[kIf],
         .ie = mem[kIe],
     });
-    Component null_ppu;
     Ppu ppu(PpuRegisters {
         .if_ = mem[kIf],
         .lcdc = mem[kLcdc],
@@ -28,8 +31,10 @@ TEST_CASE("PPU produces correct pixels")
         .lyc = mem[kLyc],
         .wy = mem[kWy],
         .wx = mem[kWx],
-    });
-    Mmu mmu(cpu, ppu, mem);
+    },
+        mem,
+        pixels.data());
+    Mmu mmu(ppu, mem);
 
     /* Enable LCD */
     mem[kLcdc] = 0x80;
@@ -70,8 +75,8 @@ TEST_CASE("PPU produces correct pixels")
     CHECK(mem[kMap0 + 2] == 10);
 
     bool redraw {false};
-    for (int i = 0; i < 1000; i++) {
-        ppu.tick(redraw);
+    for (int i = 0; i < 9; i++) {
+        ppu.step_line(redraw);
     }
 
     CHECK(ppu.pixels[0] == 0xFF);              // tile0 x0 y0
@@ -0,0 +1,136 @@
+#include "rewind.h"
+
+#include <doctest/doctest.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "cartridge.h"
+#include "emulator.h"
+
+namespace {
+
+// MBC1 with 8KB RAM. Keeps writing DIV through WRAM and cart RAM.
+std::vector<u8> make_rom()
+{
+    std::vector<u8> rom(2 * kRomBankSize);
+    const u8 code[] {
+        0x3E, 0x0A,          // LD A, 0x0A
+        0xEA, 0x00, 0x00,    // LD (0x0000), A      Enable RAM
+        0x21, 0x00, 0xC0,    // LD HL, 0xC000
+        0xF0, 0x04,          // loop: LDH A, (DIV)
+        0x22,                // LD (HL+), A
+        0xEA, 0x00, 0xA0,    // LD (0xA000), A
+        0x7C,                // LD A, H
+        0xFE, 0xD0,          // CP 0xD0
+        0x20, 0xF5,          // JR NZ, loop
+        0x21, 0x00, 0xC0,    // LD HL, 0xC000
+        0x18, 0xF0,          // JR loop
+    };
+    std::copy(std::begin(code), std::end(code), rom.begin() + 0x100);
+    rom[0x147] = 0x02;
+    rom[0x149] = 0x02;
+    return rom;
+}
+
+struct Fixture {
+    Fixture()
+    {
+        emulator.reset(true);
+        cart.rom = RomImage::from_bytes(make_rom());
+        mmu_set_cartridge(&emulator.mmu, &cart, true);
+    }
+
+    // Runs a frame and captures it, returning the state it captured
+    std::unique_ptr<State> advance(Rewind& rewind)
+    {
+        emulator.run_frame();
+        rewind.capture(emulator);
+        // So no frame is skipped
+        rewind.flush();
+
+        auto state {std::make_unique<State>()};
+        emulator.save_state(*state);
+        return state;
+    }
+
+    bool matches(const State& expected)
+    {
+        auto state {std::make_unique<State>()};
+        emulator.save_state(*state);
+        return std::memcmp(state.get(), &expected, expected.header.size) == 0;
+    }
+
+    Emulator emulator;
+    Cartridge cart;
+};
+
+}    // namespace
+
+TEST_CASE("Rewinding steps back through the frames captured")
+{
+    Fixture f;
+    Rewind rewind {1 << 20, 4};
+
+    std::vector<std::unique_ptr<State>> states;
+    for (int i = 0; i < 10; i++) {
+        states.push_back(f.advance(rewind));
+    }
+    CHECK(rewind.frames() == 10);
+
+    // Through deltas and across keyframes, frame included
+    for (int i = 8; i >= 0; i--) {
+        REQUIRE(rewind.step_back(f.emulator));
+        CHECK(f.matches(*states[i]));
+    }
+    CHECK_FALSE(rewind.step_back(f.emulator));
+    CHECK(rewind.frames() == 1);
+
+    SUBCASE("and carries on from where it went back to")
+    {
+        std::vector<std::unique_ptr<State>> branch;
+        for (int i = 0; i < 6; i++) {
+            branch.push_back(f.advance(rewind));
+        }
+        CHECK(rewind.frames() == 7);
+
+        for (int i = 4; i >= 0; i--) {
+            REQUIRE(rewind.step_back(f.emulator));
+            CHECK(f.matches(*branch[i]));
+        }
+        REQUIRE(rewind.step_back(f.emulator));
+        CHECK(f.matches(*states[0]));
+    }
+
+    SUBCASE("until it's cleared")
+    {
+        rewind.clear();
+        CHECK(rewind.frames() == 0);
+        CHECK_FALSE(rewind.step_back(f.emulator));
+    }
+}
+
+TEST_CASE("Rewinding keeps the newest frames that fit its budget")
+{
+    Fixture f;
+    constexpr std::size_t kBudget {64 << 10};
+    Rewind rewind {kBudget, 8};
+
+    std::vector<std::unique_ptr<State>> states;
+    for (int i = 0; i < 300; i++) {
+        states.push_back(f.advance(rewind));
+        CHECK(rewind.bytes_used() <= kBudget);
+    }
+
+    const std::size_t kept {rewind.frames()};
+    CHECK(kept > 8);
+    CHECK(kept < states.size());
+
+    // The oldest ones went first, a keyframe and its deltas at a time
+    for (std::size_t i = 1; i < kept; i++) {
+        REQUIRE(rewind.step_back(f.emulator));
+        CHECK(f.matches(*states[states.size() - 1 - i]));
+    }
+    CHECK_FALSE(rewind.step_back(f.emulator));
+}
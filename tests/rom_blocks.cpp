@@ -0,0 +1,165 @@
+#include "cpu/rom_blocks.h"
+
+#include <doctest/doctest.h>
+
+#include <thread>
+#include <vector>
+
+#include "cartridge.h"
+#include "cpu/block_cache.h"
+#include "emulator.h"
+#include "memory_map.h"
+
+namespace {
+
+// MBC1, with INC A at 0x4010 in bank 1 and DEC A in bank 2
+std::vector<u8> make_rom()
+{
+    std::vector<u8> rom(4 * kRomBankSize);
+    rom[0x147] = 0x01;
+    rom[0x150] = 0x04;    // INC B
+    rom[0x151] = 0x18;    // JR -3
+    rom[0x152] = 0xFD;
+    rom[1 * kRomBankSize + 0x10] = 0x3C;
+    rom[2 * kRomBankSize + 0x10] = 0x3D;
+
+    // NOPs at the end of bank 0 run into LD A, n; HALT at the start of the next
+    rom[1 * kRomBankSize + 0] = 0x3E;
+    rom[1 * kRomBankSize + 1] = 0x11;
+    rom[1 * kRomBankSize + 2] = 0x76;
+    rom[2 * kRomBankSize + 0] = 0x3E;
+    rom[2 * kRomBankSize + 1] = 0x22;
+    rom[2 * kRomBankSize + 2] = 0x76;
+    return rom;
+}
+
+struct Instance {
+    explicit Instance(const Cartridge& from)
+        : cart(from)
+    {
+        emulator.reset(true);
+        mmu_set_cartridge(&emulator.mmu, &cart, true);
+    }
+
+    const Block& lookup(u16 pc)
+    {
+        return emulator.code_cache.lookup(emulator.mmu, pc);
+    }
+
+    Emulator emulator;
+    Cartridge cart;
+};
+
+}    // namespace
+
+TEST_CASE("Instances running the same image share the code decoded from it")
+{
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+    Instance a {cart};
+    Instance b {cart};
+
+    const Block& from_a {a.lookup(0x150)};
+    const Block& from_b {b.lookup(0x150)};
+    CHECK(from_a.length == 2);
+    CHECK(from_a.ops == from_b.ops);
+
+    SUBCASE("but not code in RAM")
+    {
+        for (Instance* instance : {&a, &b}) {
+            instance->emulator.mmu.write8(kWram, 0x04);
+            instance->emulator.mmu.write8(kWram + 1, 0x76);
+        }
+        CHECK(a.lookup(kWram).ops != b.lookup(kWram).ops);
+        CHECK(a.lookup(kWram).ops[0].op == 0x04);
+    }
+
+    SUBCASE("nor with other decode settings")
+    {
+        b.emulator.code_cache.idle_skip = false;
+        b.emulator.code_cache.reset();
+        CHECK(b.lookup(0x150).ops != from_a.ops);
+        CHECK(from_a.idle);
+        CHECK_FALSE(b.lookup(0x150).idle);
+    }
+}
+
+TEST_CASE("Shared code is keyed by the bank it's read from")
+{
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+    Instance a {cart};
+    Instance b {cart};
+
+    b.emulator.mmu.write8(0x2000, 2);
+    CHECK(a.lookup(0x4010).ops[0].op == 0x3C);
+    CHECK(b.lookup(0x4010).ops[0].op == 0x3D);
+
+    a.emulator.mmu.write8(0x2000, 2);
+    CHECK(a.lookup(0x4010).ops == b.lookup(0x4010).ops);
+}
+
+TEST_CASE("Code running from bank 0 into another isn't shared")
+{
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+    Instance a {cart};
+    Instance b {cart};
+
+    b.emulator.mmu.write8(0x2000, 2);
+    CHECK(a.lookup(0x3FFE).ops[2].d16 == 0x7611);
+    CHECK(b.lookup(0x3FFE).ops[2].d16 == 0x7622);
+
+    a.emulator.mmu.write8(0x2000, 2);
+    CHECK(a.lookup(0x3FFE).ops[2].d16 == 0x7622);
+}
+
+TEST_CASE("Code under the boot ROM isn't shared")
+{
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+    cart.bios.data.assign(0x100, 0x00);
+
+    Emulator emulator;
+    emulator.reset(false);
+    mmu_set_cartridge(&emulator.mmu, &cart, false);
+
+    u32 offset {0};
+    CHECK(emulator.mmu.rom_blocks(0x0000, offset) == nullptr);
+    CHECK(emulator.mmu.rom_blocks(0x0150, offset) == cart.rom->blocks.get());
+    CHECK(offset == 0x150);
+
+    emulator.mmu.write8(kExitBootRomReg, 1);
+    CHECK(emulator.mmu.rom_blocks(0x0000, offset) == cart.rom->blocks.get());
+}
+
+TEST_CASE("Every thread publishing a block gets the same one back")
+{
+    RomBlocks blocks {2 * kRomBankSize};
+    constexpr int kThreads {4};
+    constexpr u32 kOffsets {0x800};
+
+    std::vector<std::vector<const BlockCode*>> kept(kThreads, std::vector<const BlockCode*>(kOffsets));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            BlockCode code;
+            code.pc = static_cast<u16>(t);
+            for (u32 offset = 0; offset < kOffsets; offset++) {
+                kept[t][offset] = blocks.publish(offset, 1, code);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (u32 offset = 0; offset < kOffsets; offset++) {
+        const BlockCode* block {blocks.find(offset, 1)};
+        REQUIRE(block);
+        for (int t = 0; t < kThreads; t++) {
+            REQUIRE(kept[t][offset] == block);
+        }
+        CHECK(blocks.find(offset, 0) == nullptr);
+    }
+}
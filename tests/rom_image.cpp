@@ -0,0 +1,80 @@
+#include "rom_image.h"
+
+#include <doctest/doctest.h>
+
+#include "cartridge.h"
+#include "emulator.h"
+#include "fs.h"
+
+namespace {
+
+std::filesystem::path write_rom(const std::vector<u8>& bytes)
+{
+    const auto path {std::filesystem::temp_directory_path() / "korlow_rom_image_test.gb"};
+    FS::write_bytes(path.string(), bytes.data(), bytes.size());
+    return path;
+}
+
+}    // namespace
+
+TEST_CASE("ROM images are mapped once per file")
+{
+    std::vector<u8> bytes(0x5000);
+    for (std::size_t i = 0; i < bytes.size(); i++) {
+        bytes[i] = i * 7;
+    }
+    bytes[0x147] = 0x00;    // ROM only
+    const auto path {write_rom(bytes)};
+
+    auto image {RomImage::open(path)};
+    REQUIRE(image);
+    CHECK(image->path == std::filesystem::canonical(path));
+    CHECK(image->file_size == 0x5000);
+    CHECK(image->size == 0x8000);
+    CHECK(std::equal(bytes.begin(), bytes.end(), image->data));
+
+    // Zeros up to whole banks
+    CHECK(image->data[0x5000] == 0);
+    CHECK(image->data[0x7FFF] == 0);
+
+    SUBCASE("and shared while in use")
+    {
+        CHECK(RomImage::open(path) == image);
+    }
+
+    SUBCASE("by every emulator running it")
+    {
+        Emulator first;
+        Emulator second;
+        first.reset(true);
+        second.reset(true);
+
+        Cartridge first_cart;
+        Cartridge second_cart;
+        cartridge_load_rom(&first_cart, path);
+        cartridge_load_rom(&second_cart, path);
+        mmu_set_cartridge(&first.mmu, &first_cart, true);
+        mmu_set_cartridge(&second.mmu, &second_cart, true);
+
+        CHECK(first.mmu.read_map[0x40] == image->data + 0x4000);
+        CHECK(second.mmu.read_map[0x40] == image->data + 0x4000);
+    }
+
+    SUBCASE("until the last user lets go")
+    {
+        image.reset();
+
+        bytes[0] = 0xAB;
+        write_rom(bytes);
+        CHECK(RomImage::open(path)->data[0] == 0xAB);
+    }
+
+    SUBCASE("but images from memory aren't shared")
+    {
+        auto a {RomImage::from_bytes(bytes)};
+        auto b {RomImage::from_bytes(bytes)};
+        CHECK(a->data != b->data);
+        CHECK(a->size == 0x8000);
+        CHECK(a->path.empty());
+    }
+}
@@ -2,7 +2,7 @@
 #include "cpu/cpu_base.h"
 #include "doctest.h"
 #include "emu_types.h"
-#include "mmu.h"
+#include "test_bus.h"
 
 TEST_CASE("RL sets flags and result correctly")
 {
@@ -327,9 +327,7 @@ TEST_CASE("Rotate instructions")
         .ie = mem[kIe],
     });
 
-    Component null_ppu;
-
-    Mmu mmu(cpu, null_ppu, mem);
+    TestBus mmu(mem);
 
     SUBCASE("0X")
     {
@@ -0,0 +1,277 @@
+#include "scheduler.h"
+
+#include <doctest/doctest.h>
+
+#include "constants.h"
+#include "emulator.h"
+#include "memory_map.h"
+
+TEST_CASE("Scheduler pops events in deadline order")
+{
+    Scheduler scheduler;
+    CHECK(scheduler.next == kNever);
+
+    scheduler.schedule(Event::Ppu, 456);
+    scheduler.schedule(Event::Tima, 256);
+    scheduler.schedule(Event::Serial, 4096);
+    scheduler.schedule(Event::Dma, 640);
+    CHECK(scheduler.next == 256);
+
+    SUBCASE("Rescheduling moves an event")
+    {
+        scheduler.schedule(Event::Serial, 100);
+        CHECK(scheduler.next == 100);
+        CHECK(scheduler.pop() == Event::Serial);
+        CHECK(scheduler.pop() == Event::Tima);
+        CHECK(scheduler.pop() == Event::Ppu);
+        CHECK(scheduler.pop() == Event::Dma);
+        CHECK(scheduler.next == kNever);
+    }
+
+    SUBCASE("Cancelling removes an event")
+    {
+        scheduler.cancel(Event::Tima);
+        CHECK_FALSE(scheduler.is_scheduled(Event::Tima));
+        CHECK(scheduler.next == 456);
+        CHECK(scheduler.pop() == Event::Ppu);
+        CHECK(scheduler.pop() == Event::Dma);
+        CHECK(scheduler.pop() == Event::Serial);
+        CHECK(scheduler.next == kNever);
+    }
+}
+
+TEST_CASE("Devices run on scheduler events")
+{
+    Emulator emulator;
+    emulator.reset(true);
+
+    Mmu& mmu = emulator.mmu;
+    Scheduler& scheduler = emulator.scheduler;
+
+    SUBCASE("DIV increments every 256 cycles")
+    {
+        scheduler.now = 256 * 10;
+        CHECK(mmu.read8(kDiv) == 10);
+
+        mmu.write8(kDiv, 0x55);
+        CHECK(mmu.read8(kDiv) == 0);
+
+        scheduler.now += 255;
+        CHECK(mmu.read8(kDiv) == 0);
+        scheduler.now++;
+        CHECK(mmu.read8(kDiv) == 1);
+    }
+
+    SUBCASE("TIMA overflow requests the timer interrupt")
+    {
+        bool redraw {false};
+        mmu.write8(kIf, 0);
+        mmu.write8(kTma, 0xF0);
+        mmu.write8(kTima, 0xFE);
+        mmu.write8(kTac, 0x5);    // Enabled, 16 cycles
+
+        scheduler.now += 16;
+        emulator.dispatch_events(redraw);
+        CHECK(mmu.read8(kTima) == 0xFF);
+        CHECK(!(emulator.mem[kIf] & 0x4));
+
+        // The only timer event is the overflow
+        CHECK(scheduler.next == scheduler.now + 16);
+
+        scheduler.now += 16;
+        emulator.dispatch_events(redraw);
+        CHECK(mmu.read8(kTima) == 0xF0);
+        CHECK(emulator.mem[kIf] & 0x4);
+    }
+
+    SUBCASE("TIMA keeps its phase across TAC and TIMA writes")
+    {
+        const u64 start {scheduler.now};
+        mmu.write8(kTima, 0x00);
+        mmu.write8(kTac, 0x5);    // Enabled, 16 cycles
+        scheduler.now = start + 100;
+        CHECK(mmu.read8(kTima) == 6);
+
+        // The increment due at 112 still happens, then every 1024 cycles
+        mmu.write8(kTac, 0x4);
+        scheduler.now = start + 112;
+        CHECK(mmu.read8(kTima) == 7);
+        scheduler.now = start + 1135;
+        CHECK(mmu.read8(kTima) == 7);
+        scheduler.now = start + 1136;
+        CHECK(mmu.read8(kTima) == 8);
+
+        mmu.write8(kTima, 0x10);
+        scheduler.now = start + 2159;
+        CHECK(mmu.read8(kTima) == 0x10);
+        scheduler.now = start + 2160;
+        CHECK(mmu.read8(kTima) == 0x11);
+
+        // Stopped, it holds its value
+        mmu.write8(kTac, 0x0);
+        CHECK_FALSE(scheduler.is_scheduled(Event::Tima));
+        scheduler.now += 10000;
+        CHECK(mmu.read8(kTima) == 0x11);
+    }
+
+    SUBCASE("OAM DMA completes after 640 cycles")
+    {
+        bool redraw {false};
+        emulator.mem[kWram] = 0x42;
+        mmu.write8(kDmaStartAddr, kWram >> 8);
+        CHECK(emulator.mem[kOam] == 0);
+
+        scheduler.now += 640;
+        emulator.dispatch_events(redraw);
+        CHECK(emulator.mem[kOam] == 0x42);
+    }
+
+    SUBCASE("A frame is 70224 cycles")
+    {
+        bool redraw {false};
+        scheduler.now = kCyclesPerLine * kLcdHeight - 1;
+        emulator.dispatch_events(redraw);
+        CHECK(!redraw);
+
+        scheduler.now++;
+        emulator.dispatch_events(redraw);
+        CHECK(redraw);
+        CHECK(emulator.mem[kLy] == kLcdHeight);
+        CHECK(emulator.mem[kIf] & 0x1);
+    }
+}
+
+TEST_CASE("HALT sleeps until an interrupt is pending")
+{
+    Emulator emulator;
+    emulator.reset(true);
+
+    Mmu& mmu = emulator.mmu;
+    Cpu& cpu = emulator.cpu;
+
+    /* HALT; NOP */
+    emulator.mem[0x100] = 0x76;
+    emulator.mem[0x101] = 0x00;
+    mmu.write8(kIe, 0x1);
+    mmu.write8(kIf, 0x0);
+
+    bool redraw {false};
+    emulator.run(kCyclesPerFrame, redraw);
+
+    /* Slept straight through to VBlank without executing anything else */
+    CHECK(redraw);
+    CHECK(cpu.halted);
+    CHECK(emulator.total_instructions == 1);
+    CHECK(emulator.scheduler.now == kCyclesPerLine * kLcdHeight);
+
+    /* IME is off, so it wakes and carries on after the HALT */
+    redraw = false;
+    emulator.run(4, redraw);
+    CHECK(!cpu.halted);
+    CHECK(cpu.pc == 0x102);
+}
+
+TEST_CASE("Polling loops skip ahead to the next event")
+{
+    Emulator skipping;
+    Emulator stepping;
+
+    // wait_ly: LDH A, (LY); CP 0x90; JR C, wait_ly
+    // INC B
+    // wait_mode: LDH A, (STAT); AND 3; JR NZ, wait_mode
+    // JP wait_ly
+    const u8 code[] = {0xF0, 0x44, 0xFE, 0x90, 0x38, 0xFA, 0x04, 0xF0, 0x41, 0xE6, 0x03, 0x20, 0xFA, 0xC3, 0x00, 0xC0};
+
+    for (Emulator* emulator : {&skipping, &stepping}) {
+        emulator->reset(true);
+        for (size_t i = 0; i < sizeof(code); i++) {
+            emulator->mmu.write8(kWram + i, code[i]);
+        }
+        emulator->cpu.pc = kWram;
+    }
+    stepping.code_cache.idle_skip = false;
+    bool skips {true};
+
+    SUBCASE("but not loops that read DIV")
+    {
+        skips = false;
+        // wait_div: LDH A, (DIV); AND 0x80; JR Z, wait_div; INC B; JR wait_div
+        const u8 div_code[] = {0xF0, 0x04, 0xE6, 0x80, 0x28, 0xFA, 0x04, 0x18, 0xF7};
+        for (Emulator* emulator : {&skipping, &stepping}) {
+            for (size_t i = 0; i < sizeof(div_code); i++) {
+                emulator->mmu.write8(kWram + i, div_code[i]);
+            }
+            emulator->cpu.pc = kWram;
+        }
+    }
+
+    SUBCASE("unless they poll it")
+    {
+        // wait_div: LDH A, (DIV); CP 0x80; JR NZ, wait_div; INC B; JR wait_div
+        const u8 div_code[] = {0xF0, 0x04, 0xFE, 0x80, 0x20, 0xFA, 0x04, 0x18, 0xF7};
+        for (Emulator* emulator : {&skipping, &stepping}) {
+            for (size_t i = 0; i < sizeof(div_code); i++) {
+                emulator->mmu.write8(kWram + i, div_code[i]);
+            }
+            emulator->cpu.pc = kWram;
+        }
+    }
+
+    for (int frame = 0; frame < 10; frame++) {
+        skipping.run_frame();
+        stepping.run_frame();
+    }
+
+    CHECK((skipping.code_cache.idle_passes > 0) == skips);
+    CHECK(stepping.code_cache.idle_passes == 0);
+    CHECK(skipping.scheduler.now == stepping.scheduler.now);
+    CHECK(skipping.total_instructions == stepping.total_instructions);
+    CHECK(skipping.cpu.af == stepping.cpu.af);
+    CHECK(skipping.cpu.bc == stepping.cpu.bc);
+    CHECK(skipping.cpu.pc == stepping.cpu.pc);
+}
+
+TEST_CASE("Poll loops skip to when the register they read changes")
+{
+    struct Program {
+        const char* name;
+        u8 address;
+        u8 value;
+    };
+    const Program programs[] {
+        {"LY", 0x44, 0x90},
+        {"STAT", 0x41, 0x81},
+        {"DIV", 0x04, 0x80},
+        {"TIMA", 0x05, 0x80},
+    };
+
+    for (const Program& program : programs) {
+        Emulator skipping;
+        Emulator stepping;
+
+        // wait: LDH A, (address); CP value; JR NZ, wait; INC B; JR wait
+        const u8 code[] = {0xF0, program.address, 0xFE, program.value, 0x20, 0xFA, 0x04, 0x18, 0xF7};
+        for (Emulator* emulator : {&skipping, &stepping}) {
+            emulator->reset(true);
+            for (size_t i = 0; i < sizeof(code); i++) {
+                emulator->mmu.write8(kWram + i, code[i]);
+            }
+            emulator->mmu.write8(kTac, 0x04);    // TIMA every 1024 cycles
+            emulator->cpu.pc = kWram;
+        }
+        stepping.code_cache.idle_skip = false;
+
+        for (int frame = 0; frame < 4; frame++) {
+            skipping.run_frame();
+            stepping.run_frame();
+        }
+
+        INFO(program.name);
+        CHECK(skipping.code_cache.idle_passes > 0);
+        CHECK(skipping.scheduler.now == stepping.scheduler.now);
+        CHECK(skipping.total_instructions == stepping.total_instructions);
+        CHECK(skipping.cpu.af == stepping.cpu.af);
+        CHECK(skipping.cpu.bc == stepping.cpu.bc);
+        CHECK(skipping.cpu.pc == stepping.cpu.pc);
+    }
+}
@@ -0,0 +1,220 @@
+#include "state.h"
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "cartridge.h"
+#include "emulator.h"
+#include "memory_map.h"
+
+namespace {
+
+// MBC1 with 32KB RAM. Fills WRAM, cart RAM and the ROM bank register with DIV
+// and TIMA while the timer runs.
+std::vector<u8> make_rom()
+{
+    std::vector<u8> rom(4 * kRomBankSize);
+    const u8 code[] {
+        0x3E, 0x0A,          // LD A, 0x0A
+        0xEA, 0x00, 0x00,    // LD (0x0000), A      Enable RAM
+        0x3E, 0x05,          // LD A, 0x05
+        0xE0, 0x07,          // LDH (TAC), A
+        0x21, 0x00, 0xC0,    // LD HL, 0xC000
+        0xF0, 0x04,          // loop: LDH A, (DIV)
+        0x22,                // LD (HL+), A
+        0xEA, 0x00, 0xA0,    // LD (0xA000), A
+        0xE6, 0x03,          // AND 3
+        0x3C,                // INC A
+        0xEA, 0x00, 0x20,    // LD (0x2000), A      ROM bank 1-4
+        0xF0, 0x05,          // LDH A, (TIMA)
+        0xEA, 0x01, 0xA0,    // LD (0xA001), A
+        0x7C,                // LD A, H
+        0xFE, 0xDF,          // CP 0xDF
+        0x20, 0xEA,          // JR NZ, loop
+        0x21, 0x00, 0xC0,    // LD HL, 0xC000
+        0x18, 0xE5,          // JR loop
+    };
+    std::copy(std::begin(code), std::end(code), rom.begin() + 0x100);
+    rom[0x147] = 0x03;
+    rom[0x149] = 0x03;
+    rom[0x14E] = 0x12;
+    rom[0x14F] = 0x34;
+    return rom;
+}
+
+void run_until(Emulator& emulator, u64 cycle)
+{
+    while (emulator.scheduler.now < cycle) {
+        bool redraw {false};
+        emulator.run(cycle - emulator.scheduler.now, redraw);
+    }
+}
+
+}    // namespace
+
+TEST_CASE("Save states restore the whole machine")
+{
+    Emulator emulator;
+    emulator.reset(true);
+
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+    mmu_set_cartridge(&emulator.mmu, &cart, true);
+
+    run_until(emulator, 100'000);
+
+    auto saved {std::make_unique<State>()};
+    emulator.save_state(*saved);
+    CHECK(saved->header.magic == kStateMagic);
+    CHECK(saved->header.cart_checksum == 0x1234);
+    CHECK(saved->header.size == State::size(0x8000));
+
+    // Run on, then go back and run the same stretch again
+    auto first {std::make_unique<State>()};
+    run_until(emulator, 250'000);
+    emulator.save_state(*first);
+
+    emulator.load_state(*saved);
+    CHECK(emulator.scheduler.now == saved->scheduler.now);
+    CHECK(emulator.cpu.pc == saved->cpu.pc);
+
+    // Every field made it back
+    auto reloaded {std::make_unique<State>()};
+    emulator.save_state(*reloaded);
+    CHECK(std::memcmp(saved.get(), reloaded.get(), saved->header.size) == 0);
+
+    auto second {std::make_unique<State>()};
+    run_until(emulator, 250'000);
+    emulator.save_state(*second);
+
+    CHECK(first->mbc.rom_bank == second->mbc.rom_bank);
+    CHECK(std::memcmp(first->cart_ram.data(), second->cart_ram.data(), 0x8000) == 0);
+    CHECK(std::memcmp(first.get(), second.get(), first->header.size) == 0);
+
+    SUBCASE("but not into another cartridge")
+    {
+        std::vector<u8> rom {make_rom()};
+        rom[0x14F] = 0x35;
+
+        Cartridge other;
+        other.rom = RomImage::from_bytes(std::move(rom));
+        mmu_set_cartridge(&emulator.mmu, &other, true);
+        CHECK_THROWS_AS(emulator.load_state(*saved), std::runtime_error);
+    }
+
+    SUBCASE("or from another version")
+    {
+        saved->header.version++;
+        CHECK_THROWS_AS(emulator.load_state(*saved), std::runtime_error);
+    }
+}
+
+TEST_CASE("Save states leave the ROM window out unless it's memory")
+{
+    Emulator emulator;
+    emulator.reset(true);
+    emulator.mem[0x1234] = 0x56;    // ROM is plain memory without a cartridge
+
+    auto saved {std::make_unique<State>()};
+    std::fill(saved->memory.begin(), saved->memory.end(), 0xAA);
+    emulator.save_state(*saved);
+    CHECK(saved->memory[0x1234] == 0x56);
+    CHECK(saved->memory[0x1235] == 0x00);
+
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+    mmu_set_cartridge(&emulator.mmu, &cart, true);
+
+    std::fill(saved->memory.begin(), saved->memory.end(), 0xAA);
+    emulator.save_state(*saved);
+    CHECK(std::all_of(saved->memory.begin(), saved->memory.begin() + State::kRomWindow, [](u8 b) { return b == 0xAA; }));
+    CHECK(saved->memory[kWram] != 0xAA);
+
+    emulator.load_state(*saved);
+    CHECK(emulator.mem[0x1234] == 0x56);
+    CHECK(emulator.mmu.read8(0x0100) == 0x3E);
+}
+
+TEST_CASE("Delta states replay on top of a full state")
+{
+    Emulator emulator;
+    emulator.reset(true);
+
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(make_rom());
+    mmu_set_cartridge(&emulator.mmu, &cart, true);
+
+    run_until(emulator, 100'000);
+    auto base {std::make_unique<State>()};
+    emulator.save_state(*base);
+
+    // A frame apiece
+    std::vector<StateDelta> deltas(3);
+    for (std::size_t i = 0; i < deltas.size(); i++) {
+        run_until(emulator, 100'000 + (i + 1) * kCyclesPerFrame);
+        emulator.save_delta(deltas[i]);
+
+        // A few pages of WRAM, cart RAM, IO and the stack. The first also has
+        // everything written since the emulator was reset.
+        if (i > 0) {
+            CHECK(deltas[i].pages.size() < 16);
+            CHECK(deltas[i].size() < sizeof(State) / 10);
+        }
+    }
+    auto last {std::make_unique<State>()};
+    emulator.save_state(*last);
+
+    emulator.load_state(*base);
+    for (const StateDelta& delta : deltas) {
+        emulator.load_delta(delta);
+    }
+    auto replayed {std::make_unique<State>()};
+    emulator.save_state(*replayed);
+
+    // All but the frame
+    const StateRegisters& registers {*last};
+    CHECK(std::memcmp(&registers, static_cast<StateRegisters*>(replayed.get()), sizeof(registers)) == 0);
+    CHECK(last->memory == replayed->memory);
+    CHECK(std::memcmp(last->cart_ram.data(), replayed->cart_ram.data(), 0x8000) == 0);
+}
+
+TEST_CASE("Dirty pages are tracked by where writes land")
+{
+    Emulator emulator;
+    emulator.reset(true);
+    Mmu& mmu = emulator.mmu;
+
+    std::vector<u8> rom(4 * kRomBankSize);
+    rom[0x147] = 0x03;    // MBC1+RAM+BATTERY
+    rom[0x149] = 0x03;    // 4 banks
+    Cartridge cart;
+    cart.rom = RomImage::from_bytes(std::move(rom));
+    mmu_set_cartridge(&mmu, &cart, true);
+
+    mmu.write8(0x0000, 0x0A);    // Enable RAM
+    mmu.write8(0x6000, 0x01);    // RAM banking
+    mmu.write8(0x4000, 0x02);
+    mmu.clear_dirty();
+
+    mmu.write8(0xA010, 1);
+    mmu.write8(0x4000, 0x00);
+    mmu.write8(0xA100, 2);
+    mmu.write8(0xE005, 3);
+    mmu.sync_dirty();
+
+    const auto& ram_dirty {mmu.mbc.ram_dirty};
+    CHECK(ram_dirty[2 * kRamBankSize / 0x100]);
+    CHECK(ram_dirty[1]);
+    CHECK(std::count(ram_dirty.begin(), ram_dirty.end(), true) == 2);
+
+    CHECK(mmu.dirty[0xC0]);
+    CHECK_FALSE(mmu.dirty[0xE0]);
+    CHECK_FALSE(mmu.dirty[0xA0]);
+    CHECK_FALSE(mmu.dirty[0xA1]);
+}
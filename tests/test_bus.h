@@ -0,0 +1,60 @@
+#ifndef KORLOW_TEST_BUS_H
+#define KORLOW_TEST_BUS_H
+
+#include "cpu/block_cache.h"
+#include "emu_types.h"
+#include "scheduler.h"
+
+/* Flat 64K memory with no side effects, for testing instructions in isolation. */
+struct TestBus {
+    explicit TestBus(u8* memory)
+        : memory(memory)
+    {
+    }
+
+    u8 read8(u16 address)
+    {
+        return memory[address];
+    }
+
+    u16 read16(u16 address)
+    {
+        return u16(read8(address + 1) << 8) + read8(address);
+    }
+
+    void write8(u16 address, u8 value)
+    {
+        memory[address] = value;
+        if (code_cache) {
+            code_cache->invalidate(address);
+        }
+    }
+
+    void write16(u16 address, u16 value)
+    {
+        write8(address, static_cast<u8>(value));
+        write8(address + 1, (value & 0xFF00) >> 8);
+    }
+
+    // Every write already reaches invalidate()
+    void watch_code(u8)
+    {
+    }
+
+    // Nothing changes but through writes
+    u64 next_change(u16) const
+    {
+        return kNever;
+    }
+
+    // No image behind it, so nothing decoded here is shared
+    RomBlocks* rom_blocks(u16, u32&) const
+    {
+        return nullptr;
+    }
+
+    u8* memory {nullptr};
+    BlockCache* code_cache {nullptr};
+};
+
+#endif    // KORLOW_TEST_BUS_H